@@ -0,0 +1,109 @@
+// Benchmark of the ExtrusionEntity allocation: heap allocation of each entity
+// against the per layer ExtrusionEntityArena, on a synthetic print with the
+// entity count of a large print (many layers of perimeters and infill lines).
+
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <libslic3r/BoundingBox.hpp>
+#include <libslic3r/ExtrusionEntity.hpp>
+#include <libslic3r/ExtrusionEntityCollection.hpp>
+#include <libslic3r/ExtrusionEntityArena.hpp>
+#include <libslic3r/Thread.hpp>
+#include <libslic3r/Timer.hpp>
+#include <libslic3r/Utils.hpp>
+
+const std::string USAGE_STR = {
+    "Usage: extrusion_arena [layers] [islands per layer] [infill lines per island]"
+};
+
+using namespace Slic3r;
+
+using LayerExtrusions = std::vector<std::unique_ptr<ExtrusionEntityCollection>>;
+
+// Mimics the entity tree of a layer: per island a collection of perimeter
+// loops and a collection of short infill paths.
+static LayerExtrusions make_layer(size_t layer_idx, size_t islands, size_t infill_lines)
+{
+    LayerExtrusions out;
+    const ExtrusionFlow flow(0.08, 0.45f, 0.2f);
+    for (size_t island = 0; island < islands; ++ island) {
+        const coord_t x0 = coord_t(island) * scaled<coord_t>(10.);
+        auto perimeters = std::make_unique<ExtrusionEntityCollection>();
+        for (int loop_idx = 0; loop_idx < 3; ++ loop_idx) {
+            const coord_t d = scaled<coord_t>(0.4 * loop_idx);
+            Polyline      pl{ Point(x0 + d, d), Point(x0 + scaled<coord_t>(8.) - d, d),
+                              Point(x0 + scaled<coord_t>(8.) - d, scaled<coord_t>(8.) - d), Point(x0 + d, d) };
+            ExtrusionLoop loop(elrDefault);
+            loop.paths.emplace_back(ArcPolyline(pl), ExtrusionAttributes(ExtrusionRole::Perimeter, flow), nullptr);
+            perimeters->append(std::move(loop));
+        }
+        auto infill = std::make_unique<ExtrusionEntityCollection>();
+        for (size_t line = 0; line < infill_lines; ++ line) {
+            const coord_t y = coord_t(line % 1000) * scaled<coord_t>(0.45);
+            Polyline      pl{ Point(x0, y + coord_t(layer_idx)), Point(x0 + scaled<coord_t>(8.), y + coord_t(layer_idx)) };
+            auto path = std::make_unique<ExtrusionPath>(ArcPolyline(pl), ExtrusionAttributes(ExtrusionRole::SolidInfill, flow), nullptr);
+            infill->append(path);
+        }
+        out.emplace_back(std::move(perimeters));
+        out.emplace_back(std::move(infill));
+    }
+    return out;
+}
+
+static void run(const char *name, bool use_arena, size_t layers, size_t islands, size_t infill_lines)
+{
+    std::vector<LayerExtrusions> print(layers);
+
+    Timing::Timer timer;
+    timer.start();
+    Slic3r::parallel_for(size_t(0), layers, [&](size_t layer_idx) {
+        std::optional<ExtrusionEntityArena::Scope> arena_scope;
+        if (use_arena)
+            arena_scope.emplace();
+        print[layer_idx] = make_layer(layer_idx, islands, infill_lines);
+    });
+    const double t_create = timer.elapsed_seconds();
+    const std::string mem = log_memory_info(true);
+
+    timer.start();
+    Slic3r::parallel_for(size_t(0), layers, [&](size_t layer_idx) {
+        LayerExtrusions copy;
+        for (const auto &collection : print[layer_idx])
+            copy.emplace_back(collection->clone());
+        print[layer_idx] = std::move(copy);
+    });
+    const double t_clone = timer.elapsed_seconds();
+
+    timer.start();
+    print.clear();
+    const double t_free = timer.elapsed_seconds();
+
+    std::cout << name << ": create " << t_create << " s, clone " << t_clone << " s, free " << t_free << " s" << mem << std::endl;
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--help") {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const size_t layers       = argc > 1 ? std::stoul(argv[1]) : 2000;
+    const size_t islands      = argc > 2 ? std::stoul(argv[2]) : 20;
+    const size_t infill_lines = argc > 3 ? std::stoul(argv[3]) : 100;
+
+    std::cout << layers * islands * (infill_lines + 8) << " extrusion entities" << std::endl;
+
+    // The clone step runs without an arena scope, it measures the allocation
+    // of entities created outside of the layer processing.
+    run("heap ", false, layers, islands, infill_lines);
+    run("arena", true, layers, islands, infill_lines);
+
+    const ExtrusionEntityArena::Stats stats = ExtrusionEntityArena::stats();
+    std::cout << "chunks alive after free: " << stats.chunks_alive << ", allocations alive: " << stats.allocations_alive << std::endl;
+
+    return EXIT_SUCCESS;
+}
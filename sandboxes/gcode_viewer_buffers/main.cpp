@@ -0,0 +1,177 @@
+// Benchmark of the generation of the toolpaths buffers of the G-code preview
+// (GCodeViewer::generate_toolpaths_geometry()), single threaded against the
+// parallel generation over ranges of layers. No OpenGL context is needed.
+// The paths generated in parallel are compared against the single threaded ones,
+// both their layout and their triangles exported in the OBJ format.
+// Then the levels of detail are simplified and generated (GCodeViewer::simplify_toolpaths_moves()).
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <libslic3r/GCode/GCodeProcessor.hpp>
+#include <libslic3r/Timer.hpp>
+
+#include <slic3r/GUI/GCodeViewer.hpp>
+
+const std::string USAGE_STR = {
+    "Usage: gcode_viewer_buffers gcode_file [repeats] [toolpaths.obj]"
+};
+
+using namespace Slic3r;
+using ToolpathsGeometry = GUI::GCodeViewer::ToolpathsGeometry;
+using Path              = decltype(ToolpathsGeometry::Buffer::paths)::value_type;
+using SubPath           = decltype(Path::sub_paths)::value_type;
+
+static ToolpathsGeometry run(const char *name, const GCodeProcessorResult &result, bool parallel, int repeats)
+{
+    ToolpathsGeometry geometry;
+    double            best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++ i) {
+        Timing::Timer timer;
+        timer.start();
+        geometry = GUI::GCodeViewer::generate_toolpaths_geometry(result, parallel);
+        best = std::min(best, timer.elapsed_seconds());
+    }
+    size_t vbuffers = 0;
+    size_t paths    = 0;
+    for (const ToolpathsGeometry::Buffer &buffer : geometry.buffers) {
+        vbuffers += buffer.vertices.size();
+        paths    += buffer.paths.size();
+    }
+    std::cout << name << ": " << best << " s, " << geometry.vertices_count_floats() * sizeof(float) / (1024 * 1024) << " MB of vertices, "
+              << geometry.indices_count() << " indices, " << vbuffers << " vertex buffers, " << paths << " paths" << std::endl;
+    return geometry;
+}
+
+// The ranges processed in parallel end where all the paths end, thus the paths have to be the same.
+// The vertex data may only differ where a path is split into two vertex buffers.
+static bool same_paths(const ToolpathsGeometry &lhs, const ToolpathsGeometry &rhs)
+{
+    for (size_t i = 0; i < lhs.buffers.size(); ++ i) {
+        const auto &lhs_paths = lhs.buffers[i].paths;
+        const auto &rhs_paths = rhs.buffers[i].paths;
+        if (lhs_paths.size() != rhs_paths.size())
+            return false;
+        for (size_t j = 0; j < lhs_paths.size(); ++ j)
+            if (lhs_paths[j].type != rhs_paths[j].type || lhs_paths[j].role != rhs_paths[j].role ||
+                lhs_paths[j].sub_paths.front().first.s_id != rhs_paths[j].sub_paths.front().first.s_id ||
+                lhs_paths[j].sub_paths.back().last.s_id != rhs_paths[j].sub_paths.back().last.s_id)
+                return false;
+        if (lhs.buffers[i].instances_ids != rhs.buffers[i].instances_ids)
+            return false;
+    }
+    return true;
+}
+
+// Writes the triangles of the given path of the extrusion buffer in the OBJ format, with the same vertices and normals
+// as GCodeViewer::export_toolpaths_to_obj(), which reads them back from the GPU.
+// The vertices are written per triangle, thus the output does not depend on the layout of the vertex buffers.
+static void export_path_to_obj(const ToolpathsGeometry::Buffer &buffer, const Path &path, std::ostream &out)
+{
+    // position followed by normal
+    static const size_t floats_per_vertex = 6;
+    for (const SubPath &sub_path : path.sub_paths) {
+        const auto &indices  = buffer.indices[sub_path.first.b_id];
+        const auto &vertices = buffer.vertices[buffer.vbuffer_ids[sub_path.first.b_id]];
+        for (size_t i = sub_path.first.i_id; i + 2 <= sub_path.last.i_id; i += 3) {
+            // skip the dummy triangles of the corner caps
+            if (indices[i] == indices[i + 1] && indices[i] == indices[i + 2])
+                continue;
+            for (size_t j = 0; j < 3; ++ j) {
+                const float *v = vertices.data() + indices[i + j] * floats_per_vertex;
+                out << "v " << v[0] << " " << v[1] << " " << v[2] << "\n";
+                out << "vn " << v[3] << " " << v[4] << " " << v[5] << "\n";
+            }
+            out << "f -3//-3 -2//-2 -1//-1\n";
+        }
+    }
+}
+
+// Compares the triangles of the extrusion paths exported in the OBJ format.
+// Where a vertex buffer is full, the path restarts into a new vertex buffer without the outer corner cap.
+// The single threaded and the parallel generation fill the vertex buffers differently, thus the paths
+// split into vertex buffers at different moves are only counted, all the other paths have to be the same.
+static bool same_obj(const ToolpathsGeometry &lhs, const ToolpathsGeometry &rhs, const char *obj_file)
+{
+    auto same_split = [](const Path &lhs, const Path &rhs) {
+        if (lhs.sub_paths.size() != rhs.sub_paths.size())
+            return false;
+        for (size_t i = 0; i < lhs.sub_paths.size(); ++ i)
+            if (lhs.sub_paths[i].first.s_id != rhs.sub_paths[i].first.s_id || lhs.sub_paths[i].last.s_id != rhs.sub_paths[i].last.s_id)
+                return false;
+        return true;
+    };
+
+    // the buffers are indexed by the move type, starting with the retractions
+    const size_t id = size_t(EMoveType::Extrude) - size_t(EMoveType::Retract);
+    const ToolpathsGeometry::Buffer &lhs_buffer = lhs.buffers[id];
+    const ToolpathsGeometry::Buffer &rhs_buffer = rhs.buffers[id];
+    std::ofstream obj;
+    if (obj_file != nullptr) {
+        obj.open(obj_file);
+        obj << "# G-Code Toolpaths\n";
+    }
+    size_t differently_split = 0;
+    for (size_t i = 0; i < lhs_buffer.paths.size(); ++ i) {
+        std::ostringstream lhs_obj;
+        export_path_to_obj(lhs_buffer, lhs_buffer.paths[i], lhs_obj);
+        if (obj.is_open())
+            obj << lhs_obj.str();
+        if (! same_split(lhs_buffer.paths[i], rhs_buffer.paths[i])) {
+            ++ differently_split;
+            continue;
+        }
+        std::ostringstream rhs_obj;
+        export_path_to_obj(rhs_buffer, rhs_buffer.paths[i], rhs_obj);
+        if (lhs_obj.str() != rhs_obj.str()) {
+            std::cerr << "The triangles of the extrusion path " << i << " generated in parallel differ from the single threaded ones" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "OBJ export: " << lhs_buffer.paths.size() - differently_split << " extrusion paths compared, "
+              << differently_split << " split into vertex buffers at different moves" << std::endl;
+    return true;
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_SUCCESS;
+    }
+    const int repeats = argc > 2 ? std::max(1, atoi(argv[2])) : 3;
+
+    GCodeProcessor processor;
+    processor.process_file(argv[1]);
+    const GCodeProcessorResult &result = processor.get_result();
+    std::cout << result.moves.size() << " moves" << std::endl;
+
+    ToolpathsGeometry single   = run("single threaded", result, false, repeats);
+    ToolpathsGeometry parallel = run("parallel", result, true, repeats);
+    if (! same_paths(single, parallel)) {
+        std::cerr << "The paths generated in parallel differ from the single threaded ones" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (! same_obj(single, parallel, argc > 3 ? argv[3] : nullptr))
+        return EXIT_FAILURE;
+
+    for (float tolerance : { 0.25f, 1.0f }) {
+        Timing::Timer timer;
+        timer.start();
+        GCodeProcessorResult lod_result;
+        std::vector<size_t>  moves_ids;
+        lod_result.moves = GUI::GCodeViewer::simplify_toolpaths_moves(result, tolerance, moves_ids);
+        std::cout << "level of detail " << tolerance << " mm: simplified in " << timer.elapsed_seconds() << " s, "
+                  << lod_result.moves.size() << " moves" << std::endl;
+        if (moves_ids.size() != lod_result.moves.size() || ! std::is_sorted(moves_ids.begin(), moves_ids.end())) {
+            std::cerr << "Invalid ids of the simplified moves" << std::endl;
+            return EXIT_FAILURE;
+        }
+        run("level of detail", lod_result, true, 1);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+// Benchmark and quality comparison of the SLA orientation optimizer: the
+// full resolution search against the multi resolution (coarse to fine) one.
+
+#include <iostream>
+#include <iomanip>
+
+#include <libslic3r/Model.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+#include <libslic3r/Timer.hpp>
+
+const std::string USAGE_STR = {
+    "Usage: rotfinder meshfile.stl|obj [accuracy]"
+};
+
+using namespace Slic3r;
+
+// Same metrics as the optimizer uses, evaluated on the full mesh, so that the
+// results of both search variants can be compared.
+static double misalignment(const indexed_triangle_set &its, const Transform3f &tr)
+{
+    double S = 0.;
+    for (const auto &f : its.indices) {
+        Vec3f U = tr.linear() * (its.vertices[f(1)] - its.vertices[f(0)]);
+        Vec3f V = tr.linear() * (its.vertices[f(2)] - its.vertices[f(0)]);
+        Vec3f C = U.cross(V);
+        Vec3f n = C.normalized();
+        S += 0.5 * C.norm() * (std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z()));
+    }
+    return S / its.indices.size();
+}
+
+static double supportedness(const indexed_triangle_set &its, const Transform3f &tr)
+{
+    double S = 0.;
+    for (const auto &f : its.indices) {
+        Vec3f U = tr.linear() * (its.vertices[f(1)] - its.vertices[f(0)]);
+        Vec3f V = tr.linear() * (its.vertices[f(2)] - its.vertices[f(0)]);
+        Vec3f C = U.cross(V);
+        float phi = 1.f - std::acos(std::clamp(-C.normalized().z(), -1.f, 1.f)) / float(PI);
+        S += std::sqrt(0.5 * C.norm()) * phi * phi * phi;
+    }
+    return S / its.indices.size();
+}
+
+static double z_height(const indexed_triangle_set &its, const Transform3f &tr)
+{
+    float zmin = std::numeric_limits<float>::max(), zmax = std::numeric_limits<float>::lowest();
+    for (const Vec3f &v : its.vertices) {
+        float z = (tr * v).z();
+        zmin = std::min(zmin, z);
+        zmax = std::max(zmax, z);
+    }
+    return zmax - zmin;
+}
+
+static Transform3f to_transform(const Vec2d &rot)
+{
+    Transform3f rt = Transform3f::Identity();
+    rt.rotate(Eigen::AngleAxisf(float(rot.y()), Vec3f::UnitY()));
+    rt.rotate(Eigen::AngleAxisf(float(rot.x()), Vec3f::UnitX()));
+    return rt;
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << USAGE_STR << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    Model model = Model::read_from_file(argv[1]);
+    if (model.objects.empty()) {
+        std::cerr << "No object in " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const ModelObject &mo  = *model.objects.front();
+    indexed_triangle_set its = mo.raw_mesh().its;
+    float accuracy = argc > 2 ? std::stof(argv[2]) : 1.f;
+
+    std::cout << "Mesh faces: " << its.indices.size() << std::endl;
+
+    using Finder = Vec2d (*)(const ModelObject &, const sla::RotOptimizeParams &);
+    struct Method { const char *name; Finder fn; double (*metric)(const indexed_triangle_set &, const Transform3f &); bool maximize; };
+
+    // The supports variant searches the convex hull rotations when the object
+    // sits on the pad or on the bed (default configuration).
+    Method methods[] = {
+        {"misalignment", sla::find_best_misalignment_rotation, misalignment, true},
+        {"least supports", sla::find_least_supports_rotation, supportedness, false},
+        {"min z height", sla::find_min_z_height_rotation, z_height, false},
+    };
+
+    std::cout << std::fixed << std::setprecision(4);
+    for (const Method &m : methods) {
+        for (bool multires : {false, true}) {
+            sla::RotOptimizeParams params;
+            params.accuracy(accuracy).multi_resolution(multires);
+
+            Timing::Timer timer;
+            timer.start();
+            Vec2d rot = m.fn(mo, params);
+            double t = timer.elapsed_seconds();
+
+            std::cout << std::setw(16) << m.name << (multires ? " multires" : " full    ")
+                      << " time: " << t << " s"
+                      << " rotation: [" << rot.x() << ", " << rot.y() << "]"
+                      << " score: " << m.metric(its, to_transform(rot))
+                      << (m.maximize ? " (higher is better)" : " (lower is better)")
+                      << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
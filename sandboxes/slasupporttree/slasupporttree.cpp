@@ -1,42 +1,86 @@
+// Benchmark of the support tree meshing: meshing every part of the tree and
+// merging the meshes one by one against meshing the instances of the cached
+// primitive templates in parallel (sla::get_mesh(const SupportTreeParts&)).
+
 #include <iostream>
-#include <fstream>
 #include <string>
 
 #include <libslic3r/libslic3r.h>
 #include <libslic3r/Model.hpp>
-#include <libslic3r/Tesselate.hpp>
-#include <libslic3r/ClipperUtils.hpp>
-#include <libslic3r/SLA/SLAAutoSupports.hpp>
-#include <libslic3r/SLA/SLASupportTree.hpp>
-#include <libslic3r/SLAPrint.hpp>
-#include <libslic3r/MTUtils.hpp>
-
-#include <tbb/parallel_for.h>
-#include <tbb/mutex.h>
-#include <future>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
+#include <libslic3r/Timer.hpp>
+#include <libslic3r/SLA/SupportPointGenerator.hpp>
+#include <libslic3r/SLA/SupportTreeBuilder.hpp>
+#include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/DefaultSupportTree.hpp>
 
 const std::string USAGE_STR = {
-    "Usage: slasupporttree stlfilename.stl"
+    "Usage: slasupporttree stlfilename.stl [steps]"
 };
 
-int main(const int argc, const char *argv[]) {
-    using namespace Slic3r;
-    using std::cout; using std::endl;
+using namespace Slic3r;
 
-    if(argc < 2) {
-        cout << USAGE_STR << endl;
+static indexed_triangle_set mesh_parts_one_by_one(const sla::SupportTreeParts &parts, size_t steps)
+{
+    indexed_triangle_set out;
+    for (const sla::Head &h : parts.heads) its_merge(out, sla::get_mesh(h, steps));
+    for (const sla::Pillar &p : parts.pillars) its_merge(out, sla::get_mesh(p, steps));
+    for (const sla::Pedestal &p : parts.pedestals) its_merge(out, sla::get_mesh(p, steps));
+    for (const sla::Junction &j : parts.junctions) its_merge(out, sla::get_mesh(j, steps));
+    for (const sla::Bridge &br : parts.bridges) its_merge(out, sla::get_mesh(br, steps));
+    for (const sla::DiffBridge &br : parts.diffbridges) its_merge(out, sla::get_mesh(br, steps));
+    return out;
+}
+
+int main(const int argc, const char *argv[])
+{
+    if (argc < 2) {
+        std::cout << USAGE_STR << std::endl;
         return EXIT_SUCCESS;
     }
 
-    DynamicPrintConfig config;
+    const size_t steps = argc > 2 ? std::stoul(argv[2]) : 45;
+
+    Model        model = Model::read_from_file(argv[1]);
+    TriangleMesh mesh  = model.mesh();
+    mesh.align_to_origin();
+
+    sla::SupportTreeConfig supportcfg;
+    auto bb      = mesh.bounding_box();
+    auto heights = grid(float(bb.min.z() - supportcfg.object_elevation_mm), float(bb.max.z()), 0.05f);
+    std::vector<ExPolygons> slices = slice_mesh_ex(mesh.its, heights, 0.005f);
+
+    sla::SupportableMesh sm{mesh.its, {}, supportcfg};
+
+    sla::SupportPointGenerator::Config autogencfg;
+    autogencfg.head_diameter = float(2 * supportcfg.head_front_radius_mm);
+    sla::SupportPointGenerator point_gen{sm.emesh, autogencfg, [] {}, [](int) {}};
+    point_gen.seed(0);
+    point_gen.execute(slices, heights);
+    sm.pts = point_gen.output();
+
+    sla::SupportTreeBuilder builder;
+    sla::DefaultSupportTree::execute(builder, sm);
+    sla::SupportTreeParts parts = builder.parts();
 
-    Model model = Model::read_from_file(argv[1], &config);
+    std::cout << sm.pts.size() << " support points, " << parts.heads.size() << " heads, "
+              << parts.pillars.size() << " pillars, " << parts.junctions.size() << " junctions, "
+              << parts.bridges.size() + parts.diffbridges.size() << " bridges" << std::endl;
 
-    SLAPrint print;
+    Timing::Timer timer;
+    timer.start();
+    indexed_triangle_set one_by_one = mesh_parts_one_by_one(parts, steps);
+    its_merge_vertices(one_by_one);
+    const double t_one_by_one = timer.elapsed_seconds();
 
-    print.apply(model, config);
-    print.process();
+    timer.start();
+    indexed_triangle_set templates = sla::get_mesh(parts, steps);
+    its_merge_vertices(templates);
+    const double t_templates = timer.elapsed_seconds();
 
+    std::cout << "one by one: " << t_one_by_one << " s, " << one_by_one.indices.size() << " triangles" << std::endl;
+    std::cout << "templates:  " << t_templates << " s, " << templates.indices.size() << " triangles" << std::endl;
 
     return EXIT_SUCCESS;
 }
@@ -630,6 +630,7 @@ int CLI::run(int argc, char **argv)
                 if (printer_technology == ptFFF) {
                     for (auto* mo : model.objects)
                         fff_print.auto_assign_extruders(mo);
+                    fff_print.set_low_memory_mode(m_config.opt_bool("low_memory"));
                 }
                 print->apply(model, m_print_config);
                 std::pair<PrintBase::PrintValidationError, std::string> err = print->validate();
@@ -647,6 +648,9 @@ int CLI::run(int argc, char **argv)
                             // The outfile is processed by a PlaceholderParser.
                             outfile = fff_print.export_gcode(outfile, nullptr, nullptr);
                             outfile_final = fff_print.print_statistics().finalize_output_path(outfile);
+                            if (m_config.opt_bool("low_memory"))
+                                for (const std::pair<std::string, size_t> &step : fff_print.memory_by_step())
+                                    boost::nowide::cout << "Memory usage after " << step.first << ": " << Slic3r::format_memsize_MB(step.second) << std::endl;
                         } else if (printer_technology == ptSLA) {
                             outfile = sla_print.output_filepath(outfile);
                             // We need to finalize the filename beforehand because the export function sets the filename inside the zip metadata
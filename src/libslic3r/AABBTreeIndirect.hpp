@@ -17,6 +17,8 @@
 
 #include <Eigen/Geometry>
 
+#include <oneapi/tbb/parallel_invoke.h>
+
 #include "BoundingBox.hpp"
 #include "Utils.hpp" // for next_highest_power_of_2()
 
@@ -149,10 +151,20 @@ private:
 		// Insert an inner node into the tree. Inner node does not reference any input entity (triangle, line segment etc).
 		m_nodes[node].idx  = inner;
 		m_nodes[node].bbox = bbox;
-        build_recursive(input, node * 2 + 1, left, center);
-		build_recursive(input, node * 2 + 2, center + 1, right);
+		if (right - left >= parallel_build_threshold)
+			// The two subtrees are built over disjoint ranges of the input into disjoint sets of nodes.
+			tbb::parallel_invoke(
+				[this, &input, node, left, center]() { build_recursive(input, node * 2 + 1, left, center); },
+				[this, &input, node, center, right]() { build_recursive(input, node * 2 + 2, center + 1, right); });
+		else {
+	        build_recursive(input, node * 2 + 1, left, center);
+			build_recursive(input, node * 2 + 2, center + 1, right);
+		}
 	}
 
+	// Subtrees over at least this many entities are built in parallel.
+	static constexpr size_t parallel_build_threshold = 16384;
+
 	// Partition the input m_nodes <left, right> at "k" and "dimension" using the QuickSelect method:
 	// https://en.wikipedia.org/wiki/Quickselect
 	// Items left of the k'th item are lower than the k'th item in the "dimension", 
@@ -0,0 +1,314 @@
+#ifndef slic3r_AABBTreeWide_hpp_
+#define slic3r_AABBTreeWide_hpp_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include "AABBTreeIndirect.hpp"
+
+namespace Slic3r {
+namespace AABBTreeIndirect {
+
+// Four-wide bounding volume hierarchy collapsed from a 3D AABBTreeIndirect::Tree, used for tracing many rays.
+// A node stores the bounding boxes of up to four children as a structure of arrays of floats, the boxes of a tree
+// over doubles are rounded outwards. The hierarchy is a snapshot of the source tree, it has to be rebuilt
+// when the source tree is rebuilt.
+// The ray tracing functions below trace packets of rays through the hierarchy: a child is visited if any ray
+// of the packet hits its box, and the boxes are tested against all rays of the packet by loops over the rays,
+// which the compiler vectorizes.
+class WideTree
+{
+public:
+    static constexpr size_t   Width     = 4;
+    // Unused child slot.
+    static constexpr uint32_t npos      = uint32_t(-1);
+    // Leaf children store the index of the source entity with this flag set.
+    static constexpr uint32_t leaf_flag = uint32_t(1) << 31;
+
+    struct Node {
+        std::array<float, Width>    min_x, min_y, min_z, max_x, max_y, max_z;
+        // Index of the child node, index of the source entity | leaf_flag or npos.
+        std::array<uint32_t, Width> children;
+    };
+
+    WideTree() = default;
+    template<typename CoordType>
+    explicit WideTree(const Tree<3, CoordType> &tree) { this->build(tree); }
+
+    template<typename CoordType>
+    void build(const Tree<3, CoordType> &tree)
+    {
+        m_nodes.clear();
+        if (tree.empty())
+            return;
+        assert(tree.nodes().size() < size_t(leaf_flag));
+        m_nodes.reserve(tree.nodes().size() / 6 + 1);
+        m_nodes.emplace_back();
+        collapse(tree, 0, 0);
+    }
+
+    void                     clear() { m_nodes.clear(); }
+    const std::vector<Node>& nodes() const { return m_nodes; }
+    const Node&              node(size_t idx) const { return m_nodes[idx]; }
+    bool                     empty() const { return m_nodes.empty(); }
+
+    static bool              is_leaf(uint32_t child) { return child != npos && (child & leaf_flag) != 0; }
+    static size_t            leaf_idx(uint32_t child) { return size_t(child & ~leaf_flag); }
+
+private:
+    static float round_down(double v) { float f = float(v); return double(f) > v ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f; }
+    static float round_up(double v) { float f = float(v); return double(f) < v ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f; }
+
+    // Fill m_nodes[dst] with the descendants of the source node src: the inner nodes with the largest surface
+    // are replaced by their children until there are four of them.
+    template<typename TreeType>
+    void collapse(const TreeType &tree, size_t src, size_t dst)
+    {
+        std::array<size_t, Width> slots;
+        size_t                    num_slots = 0;
+        slots[num_slots ++] = src;
+        while (num_slots < Width) {
+            int    open = -1;
+            double open_area = -1.;
+            for (size_t i = 0; i < num_slots; ++ i)
+                if (const auto &node = tree.node(slots[i]); node.is_inner()) {
+                    const auto   size = node.bbox.sizes();
+                    const double area = double(size.x()) * double(size.y()) + double(size.y()) * double(size.z()) + double(size.z()) * double(size.x());
+                    if (area > open_area) {
+                        open      = int(i);
+                        open_area = area;
+                    }
+                }
+            if (open == -1)
+                break;
+            size_t idx = slots[open];
+            slots[open] = TreeType::left_child_idx(idx);
+            slots[num_slots ++] = TreeType::right_child_idx(idx);
+        }
+
+        for (size_t i = 0; i < Width; ++ i) {
+            Node &node = m_nodes[dst];
+            if (i >= num_slots) {
+                node.min_x[i] = node.min_y[i] = node.min_z[i] = 0.f;
+                node.max_x[i] = node.max_y[i] = node.max_z[i] = 0.f;
+                node.children[i] = npos;
+                continue;
+            }
+            const auto &src_node = tree.node(slots[i]);
+            assert(src_node.is_valid());
+            node.min_x[i] = round_down(double(src_node.bbox.min().x()));
+            node.min_y[i] = round_down(double(src_node.bbox.min().y()));
+            node.min_z[i] = round_down(double(src_node.bbox.min().z()));
+            node.max_x[i] = round_up(double(src_node.bbox.max().x()));
+            node.max_y[i] = round_up(double(src_node.bbox.max().y()));
+            node.max_z[i] = round_up(double(src_node.bbox.max().z()));
+            if (src_node.is_leaf())
+                node.children[i] = uint32_t(src_node.idx) | leaf_flag;
+            else {
+                // m_nodes may be reallocated, node is not to be used anymore.
+                uint32_t child = uint32_t(m_nodes.size());
+                m_nodes[dst].children[i] = child;
+                m_nodes.emplace_back();
+                collapse(tree, slots[i], child);
+            }
+        }
+    }
+
+    std::vector<Node> m_nodes;
+};
+
+namespace detail {
+
+    // Rays of a packet in a structure of arrays layout for the box tests.
+    template<size_t PacketSize>
+    struct RayPacket {
+        std::array<float, PacketSize> ox, oy, oz;
+        std::array<float, PacketSize> ix, iy, iz;
+        // Parameter of the closest hit so far.
+        std::array<float, PacketSize> tmax;
+
+        template<typename VectorType>
+        void set(size_t i, const VectorType &origin, const VectorType &dir)
+        {
+            // Replace zero direction components by tiny ones to avoid 0 * inf in the slab test.
+            auto inverse = [](double d) {
+                constexpr double tiny = 1e-20;
+                return float(1. / (std::abs(d) < tiny ? std::copysign(tiny, d) : d));
+            };
+            ox[i] = float(origin.x());
+            oy[i] = float(origin.y());
+            oz[i] = float(origin.z());
+            ix[i] = inverse(double(dir.x()));
+            iy[i] = inverse(double(dir.y()));
+            iz[i] = inverse(double(dir.z()));
+            tmax[i] = std::numeric_limits<float>::infinity();
+        }
+    };
+
+    // Slab test of a single box against the active rays of the packet, returns the mask of the rays hitting the box
+    // and the minimum entry parameter of these rays.
+    template<size_t PacketSize>
+    inline uint32_t ray_packet_box_intersect(const RayPacket<PacketSize> &rays, uint32_t active, const WideTree::Node &node, size_t slot, float &tnear)
+    {
+        // Compensates the rounding of the slab test, see Ize: Robust BVH Ray Traversal.
+        constexpr float robust = 1.f + 4.f * std::numeric_limits<float>::epsilon();
+        const float min_x = node.min_x[slot], min_y = node.min_y[slot], min_z = node.min_z[slot];
+        const float max_x = node.max_x[slot], max_y = node.max_y[slot], max_z = node.max_z[slot];
+        auto test_ray = [&](size_t i, float &t0) {
+            const float tx0 = (min_x - rays.ox[i]) * rays.ix[i], tx1 = (max_x - rays.ox[i]) * rays.ix[i];
+            const float ty0 = (min_y - rays.oy[i]) * rays.iy[i], ty1 = (max_y - rays.oy[i]) * rays.iy[i];
+            const float tz0 = (min_z - rays.oz[i]) * rays.iz[i], tz1 = (max_z - rays.oz[i]) * rays.iz[i];
+            t0 = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.f));
+            const float t1 = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), rays.tmax[i]));
+            return t0 <= t1 * robust;
+        };
+        if ((active & (active - 1)) == 0) {
+            // Single active ray, the packets diverged.
+            size_t i = 0;
+            while (! (active & (uint32_t(1) << i)))
+                ++ i;
+            const bool hit = test_ray(i, tnear);
+            return hit ? active : 0;
+        }
+        uint32_t    mask  = 0;
+        tnear = std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < PacketSize; ++ i) {
+            const float tx0 = (min_x - rays.ox[i]) * rays.ix[i], tx1 = (max_x - rays.ox[i]) * rays.ix[i];
+            const float ty0 = (min_y - rays.oy[i]) * rays.iy[i], ty1 = (max_y - rays.oy[i]) * rays.iy[i];
+            const float tz0 = (min_z - rays.oz[i]) * rays.iz[i], tz1 = (max_z - rays.oz[i]) * rays.iz[i];
+            const float t0  = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), 0.f));
+            const float t1  = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), rays.tmax[i]));
+            const bool  hit = t0 <= t1 * robust;
+            mask |= uint32_t(hit) << i;
+            tnear = std::min(tnear, hit ? t0 : std::numeric_limits<float>::infinity());
+        }
+        return mask & active;
+    }
+
+    template<size_t PacketSize, typename VertexType, typename IndexedFaceType, typename VectorType>
+    inline void intersect_ray_packet_first_hit(
+        const std::vector<VertexType>      &vertices,
+        const std::vector<IndexedFaceType> &faces,
+        const WideTree                     &tree,
+        const VectorType                   *origins,
+        const VectorType                   *dirs,
+        size_t                              num_rays,
+        igl::Hit                           *hits,
+        const double                        eps)
+    {
+        static_assert(PacketSize > 0 && PacketSize <= 32, "The rays of a packet are masked by 32 bit masks");
+        assert(num_rays > 0 && num_rays <= PacketSize);
+        RayPacket<PacketSize> rays;
+        for (size_t i = 0; i < PacketSize; ++ i)
+            rays.set(i, origins[std::min(i, num_rays - 1)], dirs[std::min(i, num_rays - 1)]);
+        for (size_t i = 0; i < num_rays; ++ i)
+            hits[i] = igl::Hit{ -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() };
+
+        // Nodes to be visited with the rays hitting them. Each node pushes at most Width - 1 more nodes than it pops.
+        std::array<std::pair<uint32_t, uint32_t>, 64 * WideTree::Width> stack;
+        size_t stack_size = 0;
+        stack[stack_size ++] = { 0, uint32_t((uint64_t(1) << num_rays) - 1) };
+        while (stack_size > 0) {
+            const auto [node_idx, active] = stack[-- stack_size];
+            const WideTree::Node &node = tree.node(node_idx);
+            // Children to be visited, the farthest one is pushed first to be visited last.
+            std::array<std::tuple<float, uint32_t, uint32_t>, WideTree::Width> visit;
+            size_t num_visit = 0;
+            for (size_t slot = 0; slot < WideTree::Width; ++ slot) {
+                const uint32_t child = node.children[slot];
+                if (child == WideTree::npos)
+                    continue;
+                float          tnear;
+                const uint32_t mask = ray_packet_box_intersect(rays, active, node, slot, tnear);
+                if (mask == 0)
+                    continue;
+                if (WideTree::is_leaf(child)) {
+                    const size_t face_idx = WideTree::leaf_idx(child);
+                    const auto  &face     = faces[face_idx];
+                    for (size_t i = 0; i < num_rays; ++ i)
+                        if (mask & (uint32_t(1) << i)) {
+                            double t, u, v;
+                            if (intersect_triangle(origins[i], dirs[i], vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+                                t > 0. && t < hits[i].t) {
+                                hits[i]      = igl::Hit{ int(face_idx), -1, float(u), float(v), float(t) };
+                                rays.tmax[i] = float(t);
+                            }
+                        }
+                } else
+                    visit[num_visit ++] = { tnear, child, mask };
+            }
+            std::sort(visit.begin(), visit.begin() + num_visit, [](const auto &l, const auto &r) { return std::get<0>(l) > std::get<0>(r); });
+            for (size_t i = 0; i < num_visit; ++ i) {
+                assert(stack_size < stack.size());
+                stack[stack_size ++] = { std::get<1>(visit[i]), std::get<2>(visit[i]) };
+            }
+        }
+    }
+
+} // namespace detail
+
+// Find a first intersection of a ray with indexed triangle set using a WideTree built over the triangles.
+// Same as intersect_ray_first_hit() with AABBTreeIndirect::Tree.
+template<typename VertexType, typename IndexedFaceType, typename VectorType>
+inline bool intersect_ray_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// WideTree over vertices & faces.
+	const WideTree 						&tree,
+	// Origin of the ray.
+	const VectorType					&origin,
+	// Direction of the ray.
+	const VectorType 					&dir,
+	// First intersection of the ray with the indexed triangle set.
+	igl::Hit 							&hit,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    if (tree.empty())
+        return false;
+    detail::intersect_ray_packet_first_hit<1>(vertices, faces, tree, &origin, &dir, 1, &hit, eps);
+    return hit.id != -1;
+}
+
+// Find first intersections of a batch of rays with indexed triangle set using a WideTree built over the triangles.
+// The rays are traced in packets of PacketSize consecutive rays. Tracing a packet pays off if its rays are coherent,
+// for example if they share the origin and their directions are close, thus the caller should order the rays accordingly.
+// hits[i].id is -1 if the i-th ray does not hit the triangle set. Returns the number of rays hitting the triangle set.
+template<size_t PacketSize = 4, typename VertexType, typename IndexedFaceType, typename VectorType>
+inline size_t intersect_rays_first_hit(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices,
+	// Indexed triangle set - triangular faces, references to vertices.
+	const std::vector<IndexedFaceType> 	&faces,
+	// WideTree over vertices & faces.
+	const WideTree 						&tree,
+	// Origins of the rays.
+	const std::vector<VectorType>		&origins,
+	// Directions of the rays.
+	const std::vector<VectorType> 		&dirs,
+	// First intersections of the rays with the indexed triangle set.
+	std::vector<igl::Hit> 				&hits,
+	// Epsilon for the ray-triangle intersection, it should be proportional to an average triangle edge length.
+	const double 						 eps = 0.000001)
+{
+    assert(origins.size() == dirs.size());
+    hits.assign(origins.size(), igl::Hit{ -1, -1, 0.f, 0.f, std::numeric_limits<float>::infinity() });
+    if (tree.empty())
+        return 0;
+    for (size_t i = 0; i < origins.size(); i += PacketSize)
+        detail::intersect_ray_packet_first_hit<PacketSize>(vertices, faces, tree, origins.data() + i, dirs.data() + i,
+            std::min(PacketSize, origins.size() - i), hits.data() + i, eps);
+    return size_t(std::count_if(hits.begin(), hits.end(), [](const igl::Hit &hit) { return hit.id != -1; }));
+}
+
+} // namespace AABBTreeIndirect
+} // namespace Slic3r
+
+#endif // slic3r_AABBTreeWide_hpp_
@@ -13,6 +13,7 @@
 #include "Core/ArrangeBase.hpp"
 #include "Core/ArrangeFirstFit.hpp"
 #include "Core/NFP/PackStrategyNFP.hpp"
+#include "Core/NFP/NFPCache.hpp"
 #include "Core/NFP/Kernels/TMArrangeKernel.hpp"
 #include "Core/NFP/Kernels/GravityKernel.hpp"
 #include "Core/NFP/RectangleOverfitPackingStrategy.hpp"
@@ -353,6 +354,8 @@ public:
         const ExtendedBed &bed,
         ArrangerCtl<ArrItem> &ctl) override
     {
+        NFPCache::Stats nfp_stats = NFPCache::global().stats();
+
         visit_bed([this, &items, &fixed, &ctl](auto rawbed) {
 
             if constexpr (IsSegmentedBed<decltype(rawbed)>)
@@ -361,6 +364,8 @@ public:
 
             arrange_(range(items), crange(fixed), rawbed, ctl);
         }, bed);
+
+        NFPCache::global().log_stats(nfp_stats, "arrange");
     }
 };
 
@@ -0,0 +1,171 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#include "NFPCache.hpp"
+#include "NFP.hpp"
+
+#include <boost/log/trivial.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+namespace {
+
+// Copy of the polygon vertices relative to the reference vertex, the shape
+// invariant to translation.
+Points normalized_points(const Polygon &p)
+{
+    Vec2crd ref = reference_vertex(p);
+    Points  pts;
+    pts.reserve(p.size());
+    for (const Point &pt : p.points)
+        pts.emplace_back(pt - ref);
+
+    return pts;
+}
+
+// FNV-1a over the coordinates of both normalized shapes.
+uint64_t shapes_hash(const Points &fixed, const Points &movable)
+{
+    uint64_t h = 14695981039346656037ull;
+
+    auto add = [&h](int64_t v) {
+        for (int i = 0; i < 8; ++i) {
+            h ^= uint64_t(v >> (8 * i)) & 0xff;
+            h *= 1099511628211ull;
+        }
+    };
+
+    for (const Points *pts : {&fixed, &movable}) {
+        add(int64_t(pts->size()));
+        for (const Point &pt : *pts) {
+            add(pt.x());
+            add(pt.y());
+        }
+    }
+
+    return h;
+}
+
+} // namespace
+
+NFPCache::Key NFPCache::make_key(const Polygon &fixed, const Polygon &movable)
+{
+    Key key;
+    key.fixed   = normalized_points(fixed);
+    key.movable = normalized_points(movable);
+    key.hash    = shapes_hash(key.fixed, key.movable);
+
+    return key;
+}
+
+Polygon NFPCache::nfp_convex_convex_normalized(const Polygon &fixed, const Polygon &movable)
+{
+    Key    key = make_key(fixed, movable);
+    Shard &sh  = shard(key);
+
+    {
+        std::lock_guard<std::mutex> lk{sh.mutex};
+        if (auto it = sh.entries.find(key); it != sh.entries.end()) {
+            ++sh.stats.hits;
+            sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+            return it->second->nfp;
+        }
+        ++sh.stats.misses;
+    }
+
+    // Computed outside of the lock, the same NFP may be computed concurrently
+    // by two threads, only one of the results is stored.
+    Polygon nfp = nfp_convex_convex_legacy(fixed, movable);
+    nfp.translate(-reference_vertex(nfp));
+
+    std::lock_guard<std::mutex> lk{sh.mutex};
+    if (auto [it, inserted] = sh.entries.emplace(std::move(key), LRUList::iterator{}); inserted) {
+        sh.lru.push_front(Entry{&it->first, nfp});
+        it->second = sh.lru.begin();
+        sh.stats.memory += entry_memory(sh.lru.front());
+        ++sh.stats.entries;
+        sh.evict_to_budget(shard_budget());
+    }
+
+    return nfp;
+}
+
+void NFPCache::Shard::evict_to_budget(size_t budget)
+{
+    while (stats.memory > budget && !lru.empty()) {
+        const Entry &e = lru.back();
+        stats.memory -= entry_memory(e);
+        --stats.entries;
+        ++stats.evictions;
+        entries.erase(entries.find(*e.key));
+        lru.pop_back();
+    }
+}
+
+NFPCache::Stats NFPCache::stats() const
+{
+    Stats ret;
+    for (const Shard &sh : m_shards) {
+        std::lock_guard<std::mutex> lk{sh.mutex};
+        ret += sh.stats;
+    }
+
+    return ret;
+}
+
+void NFPCache::reset_stats()
+{
+    for (Shard &sh : m_shards) {
+        std::lock_guard<std::mutex> lk{sh.mutex};
+        sh.stats.hits = 0;
+        sh.stats.misses = 0;
+        sh.stats.evictions = 0;
+    }
+}
+
+void NFPCache::log_stats(const Stats &since, const char *what) const
+{
+    Stats now = stats();
+
+    Stats diff;
+    diff.hits = now.hits - since.hits;
+    diff.misses = now.misses - since.misses;
+    diff.evictions = now.evictions - since.evictions;
+
+    BOOST_LOG_TRIVIAL(debug) << "NFP cache, " << what << ": " << diff.hits << " hits, "
+                             << diff.misses << " misses (hit rate "
+                             << int(diff.hit_rate() * 100.) << "%), " << diff.evictions
+                             << " evictions, " << now.entries << " entries using "
+                             << now.memory / 1024 << " KiB";
+}
+
+void NFPCache::clear()
+{
+    for (Shard &sh : m_shards) {
+        std::lock_guard<std::mutex> lk{sh.mutex};
+        sh.entries.clear();
+        sh.lru.clear();
+        sh.stats.entries = 0;
+        sh.stats.memory = 0;
+    }
+}
+
+void NFPCache::memory_budget(size_t bytes)
+{
+    m_memory_budget.store(bytes, std::memory_order_relaxed);
+
+    for (Shard &sh : m_shards) {
+        std::lock_guard<std::mutex> lk{sh.mutex};
+        sh.evict_to_budget(shard_budget());
+    }
+}
+
+NFPCache &NFPCache::global()
+{
+    static NFPCache cache;
+
+    return cache;
+}
+
+}} // namespace Slic3r::arr2
@@ -0,0 +1,141 @@
+///|/ Copyright (c) Prusa Research 2023 Tomáš Mészáros @tamasmeszaros
+///|/
+///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
+///|/
+#ifndef NFPCACHE_HPP
+#define NFPCACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <libslic3r/Polygon.hpp>
+
+namespace Slic3r { namespace arr2 {
+
+// Cache of no-fit polygons of convex polygon pairs, shared across the items
+// of one arrangement and across consecutive arrange calls.
+//
+// The NFP of two convex polygons only depends on their shapes, translating
+// the inputs only translates the result. The cache is therefore keyed by the
+// vertices of both polygons relative to their reference vertices, a hit
+// requires all of them to match, not only their hash. As the item rotation
+// is applied to the polygon coordinates, the relative rotation of the pair
+// is part of the key as well. Filling a bed with copies of one shape thus
+// computes each NFP only once per rotation.
+//
+// The stored NFPs are normalized: their reference vertex is at the origin.
+// The cache is bounded by a memory budget, the least recently used entries
+// are evicted first. It is thread safe, the entries are split into shards
+// by their hash, each guarded by its own mutex, so the parallel NFP
+// calculation of the arrangement does not serialize on a single lock.
+class NFPCache
+{
+public:
+    struct Stats
+    {
+        size_t hits      = 0;
+        size_t misses    = 0;
+        size_t evictions = 0;
+        size_t entries   = 0;
+        size_t memory    = 0; // Estimated memory used by the entries in bytes
+
+        double hit_rate() const
+        {
+            size_t lookups = hits + misses;
+            return lookups > 0 ? double(hits) / lookups : 0.;
+        }
+
+        Stats &operator+=(const Stats &o)
+        {
+            hits += o.hits;
+            misses += o.misses;
+            evictions += o.evictions;
+            entries += o.entries;
+            memory += o.memory;
+            return *this;
+        }
+    };
+
+    static constexpr size_t DefaultMemoryBudget = 64 * 1024 * 1024;
+
+    explicit NFPCache(size_t memory_budget = DefaultMemoryBudget)
+        : m_memory_budget{memory_budget}
+    {}
+
+    // Return the normalized NFP of the convex polygons fixed and movable,
+    // as computed by nfp_convex_convex_legacy(), using the cached result
+    // if available.
+    Polygon nfp_convex_convex_normalized(const Polygon &fixed, const Polygon &movable);
+
+    Stats stats() const;
+    void  reset_stats();
+
+    // Log the hits and misses since the given snapshot of stats().
+    void log_stats(const Stats &since, const char *what) const;
+
+    void   clear();
+    size_t memory_budget() const { return m_memory_budget.load(std::memory_order_relaxed); }
+    void   memory_budget(size_t bytes);
+
+    // Instance shared by all the arrangements.
+    static NFPCache &global();
+
+private:
+    // Vertices of both polygons relative to their reference vertices.
+    struct Key
+    {
+        uint64_t hash = 0;
+        Points   fixed, movable;
+
+        bool operator==(const Key &o) const
+        {
+            return hash == o.hash && fixed == o.fixed && movable == o.movable;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &k) const { return size_t(k.hash); }
+    };
+
+    struct Entry
+    {
+        const Key *key; // Owned by the map of the shard
+        Polygon    nfp;
+    };
+
+    using LRUList = std::list<Entry>;
+
+    struct Shard
+    {
+        LRUList lru; // most recently used at the front
+        std::unordered_map<Key, LRUList::iterator, KeyHash> entries;
+        Stats   stats;
+
+        mutable std::mutex mutex;
+
+        void evict_to_budget(size_t budget);
+    };
+
+    static constexpr size_t ShardCount = 16;
+
+    static Key    make_key(const Polygon &fixed, const Polygon &movable);
+    static size_t entry_memory(const Entry &e)
+    {
+        return sizeof(Entry) + 2 * sizeof(void *) +
+               (e.key->fixed.size() + e.key->movable.size() + e.nfp.size()) * sizeof(Point);
+    }
+
+    Shard &shard(const Key &key) { return m_shards[(key.hash >> 32) % ShardCount]; }
+    size_t shard_budget() const { return memory_budget() / ShardCount; }
+
+    std::atomic<size_t>          m_memory_budget;
+    std::array<Shard, ShardCount> m_shards;
+};
+
+}} // namespace Slic3r::arr2
+
+#endif // NFPCACHE_HPP
@@ -15,6 +15,7 @@
 #include "libslic3r/Arrange/Core/PackingContext.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFPArrangeItemTraits.hpp"
 #include "libslic3r/Arrange/Core/NFP/NFP.hpp"
+#include "libslic3r/Arrange/Core/NFP/NFPCache.hpp"
 
 #include "libslic3r/Arrange/Items/MutableItemTraits.hpp"
 
@@ -284,7 +285,8 @@ template<> struct WritableDataStoreTraits_<ArrangeItem>
 template<class FixedIt, class StopCond = DefaultStopCondition>
 static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
                                            const Range<FixedIt> &fixed_items,
-                                           StopCond &&stop_cond = {})
+                                           StopCond &&stop_cond = {},
+                                           NFPCache &nfp_cache = NFPCache::global())
 {
     size_t cap = 0;
 
@@ -310,16 +312,16 @@ static Polygons calculate_nfp_unnormalized(const ArrangeItem    &item,
             for (size_t mi = 0; mi < item_outlines.size(); ++mi) {
                 const Polygon &movable = item_outlines[mi];
                 const Vec2crd &mref = item.envelope().reference_vertex(mi);
-                subnfp = nfp_convex_convex_legacy(fixed_poly, movable);
+
+                // The cached NFP has its reference vertex in the origin.
+                subnfp = nfp_cache.nfp_convex_convex_normalized(fixed_poly, movable);
 
                 Vec2crd min_movable = item.envelope().min_vertex(mi);
 
                 Vec2crd dtouch = max_fixed - min_movable;
                 Vec2crd top_other = mref + dtouch;
-                Vec2crd max_nfp = Slic3r::reference_vertex(subnfp);
-                auto dnfp = top_other - max_nfp;
 
-                auto d = ref_whole - mref + dnfp;
+                auto d = ref_whole - mref + top_other;
                 subnfp.translate(d);
                 nfps.emplace_back(subnfp);
             }
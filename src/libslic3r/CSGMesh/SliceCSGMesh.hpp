@@ -17,24 +17,29 @@ namespace Slic3r { namespace csg {
 
 namespace detail {
 
-inline void merge_slices(csg::CSGType op, size_t i,
-                  std::vector<ExPolygons> &target,
-                  std::vector<ExPolygons> &source)
+inline void merge_slices(csg::CSGType op, ExPolygons &target, ExPolygons &source)
 {
     switch(op) {
     case CSGType::Union:
-        for (ExPolygon &expoly : source[i])
-            target[i].emplace_back(std::move(expoly));
+        for (ExPolygon &expoly : source)
+            target.emplace_back(std::move(expoly));
         break;
     case CSGType::Difference:
-        target[i] = diff_ex(target[i], source[i]);
+        target = diff_ex(target, source);
         break;
     case CSGType::Intersection:
-        target[i] = intersection_ex(target[i], source[i]);
+        target = intersection_ex(target, source);
         break;
     }
 }
 
+inline void merge_slices(csg::CSGType op, size_t i,
+                  std::vector<ExPolygons> &target,
+                  std::vector<ExPolygons> &source)
+{
+    merge_slices(op, target[i], source[i]);
+}
+
 inline void collect_nonempty_indices(csg::CSGType                   op,
                               const std::vector<float>      &slicegrid,
                               const std::vector<ExPolygons> &slices,
@@ -82,19 +87,14 @@ std::vector<ExPolygons> slice_csgmesh_ex(
 
         if (its) {
             params_cpy.trafo = trafo * csg::get_transform(csgpart).template cast<double>();
-            std::vector<ExPolygons> slices = slice_mesh_ex(*its,
-                                                           slicegrid, params_cpy,
-                                                           throw_on_cancel);
-
-            assert(slices.size() == slicegrid.size());
-
-            collect_nonempty_indices(op, slicegrid, slices, nonempty_indices);
 
-            execution::for_each(
-                ex_tbb, nonempty_indices.begin(), nonempty_indices.end(),
-                [op, &slices, &top](size_t i) {
-                    merge_slices(op, i, top->slices, slices);
-                }, execution::max_concurrency(ex_tbb));
+            // The layers are merged as they are sliced, the slices of the
+            // whole part are never held at once.
+            slice_mesh_ex_streamed(*its, slicegrid, params_cpy,
+                                   [op, top](size_t i, ExPolygons &&slice) {
+                                       if (op == CSGType::Intersection || !slice.empty())
+                                           merge_slices(op, top->slices[i], slice);
+                                   }, throw_on_cancel);
         }
 
         if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
@@ -3,6 +3,7 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cfloat>
 #include <unordered_map>
@@ -17,6 +18,8 @@
 #include "SVG.hpp"
 #include "PNGReadWrite.hpp"
 
+#include <oneapi/tbb/parallel_for.h>
+
 // #define EDGE_GRID_DEBUG_OUTPUT
 
 #if 0
@@ -154,6 +157,7 @@ void EdgeGrid::Grid::create(const ExPolygons &expolygons, coord_t resolution)
 void EdgeGrid::Grid::create_from_m_contours(coord_t resolution)
 {
 	assert(resolution > 0);
+	m_sparse_sdf.reset();
 	// 1) Measure the bounding box.
 	for (const Contour &contour : m_contours) {
 		assert(contour.num_segments() > 0);
@@ -690,6 +694,7 @@ void EdgeGrid::Grid::calculate_sdf()
 #ifdef _DEBUG
     m_signed_distance_field_computed = true;
 #endif
+	m_sparse_sdf.reset();
 
 	// 1) Initialize a signum and an unsigned vector to a zero iso surface.
 	size_t nrows = m_rows + 1;
@@ -994,6 +999,200 @@ void EdgeGrid::Grid::calculate_sdf()
 #endif // EDGE_GRID_DEBUG_OUTPUT
 }
 
+// Size of a tile of the sparse signed distance field in grid cells.
+static constexpr size_t sparse_sdf_tile_size = 16;
+// Grid nodes of a tile in a row, the border nodes are shared with the neighbor tiles.
+static constexpr size_t sparse_sdf_tile_stride = sparse_sdf_tile_size + 1;
+
+struct EdgeGrid::Grid::SparseSDF
+{
+	SparseSDF(coord_t band, size_t rows, size_t cols) :
+		band(band), rows(rows), cols(cols), in_band(rows * cols, false),
+		tiles(new std::atomic<float*>[rows * cols]), signs(new std::atomic<int8_t>[rows * cols])
+	{
+		for (size_t i = 0; i < rows * cols; ++ i) {
+			tiles[i] = nullptr;
+			signs[i] = 0;
+		}
+	}
+	~SparseSDF() {
+		for (size_t i = 0; i < rows * cols; ++ i)
+			delete[] tiles[i].load();
+	}
+
+	coord_t								  band;
+	// Count of tiles.
+	size_t								  rows;
+	size_t								  cols;
+	// Is the tile closer than band to the contours?
+	std::vector<bool>					  in_band;
+	// Values at the grid nodes of the tiles in band, null until calculated.
+	std::unique_ptr<std::atomic<float*>[]> tiles;
+	// Signum of the tiles out of band, zero until calculated.
+	std::unique_ptr<std::atomic<int8_t>[]> signs;
+	std::atomic<size_t>					  num_tiles_calculated { 0 };
+};
+
+void EdgeGrid::Grid::calculate_sparse_sdf(coord_t band)
+{
+#ifdef _DEBUG
+    m_signed_distance_field_computed = true;
+#endif
+	m_signed_distance_field.clear();
+	m_signed_distance_field.shrink_to_fit();
+
+	// The signum is propagated between the neighbor nodes out of band, see calculate_sparse_sdf_tile().
+	band = std::max(band, m_resolution);
+	size_t tile_rows = (m_rows + sparse_sdf_tile_size) / sparse_sdf_tile_size;
+	size_t tile_cols = (m_cols + sparse_sdf_tile_size) / sparse_sdf_tile_size;
+	auto sdf = std::make_shared<SparseSDF>(band, tile_rows, tile_cols);
+
+	// Mark tiles around the cells crossed by the contours. The field is published once marked.
+	const coord_t tile_size = coord_t(sparse_sdf_tile_size) * m_resolution;
+	for (size_t r = 0; r < m_rows; ++ r)
+		for (size_t c = 0; c < m_cols; ++ c)
+			if (const Cell &cell = m_cells[r * m_cols + c]; cell.begin < cell.end) {
+				coord_t r0 = std::max<coord_t>(0, (coord_t(r) * m_resolution - band) / tile_size);
+				coord_t c0 = std::max<coord_t>(0, (coord_t(c) * m_resolution - band) / tile_size);
+				coord_t r1 = std::min<coord_t>(tile_rows - 1, (coord_t(r + 1) * m_resolution + band) / tile_size);
+				coord_t c1 = std::min<coord_t>(tile_cols - 1, (coord_t(c + 1) * m_resolution + band) / tile_size);
+				for (coord_t tr = r0; tr <= r1; ++ tr)
+					for (coord_t tc = c0; tc <= c1; ++ tc)
+						sdf->in_band[tr * tile_cols + tc] = true;
+			}
+	m_sparse_sdf = std::move(sdf);
+}
+
+size_t EdgeGrid::Grid::sparse_sdf_tiles_in_band() const
+{
+	return m_sparse_sdf ? std::count(m_sparse_sdf->in_band.begin(), m_sparse_sdf->in_band.end(), true) : 0;
+}
+
+// Values of the grid nodes of a tile: The exact signed distance closer than band to the contours, +-band otherwise.
+std::vector<float> EdgeGrid::Grid::calculate_sparse_sdf_tile(size_t tile_row, size_t tile_col) const
+{
+	const coord_t band   = m_sparse_sdf->band;
+	const size_t  stride = sparse_sdf_tile_stride;
+	std::vector<float> values(stride * stride, 0.f);
+	// Nodes out of band, waiting for the signum.
+	std::vector<char>  unknown(stride * stride, false);
+	auto node_point = [this, tile_row, tile_col](size_t r, size_t c) -> Point {
+		return m_bbox.min + m_resolution * Point(coord_t(tile_col * sparse_sdf_tile_size + c), coord_t(tile_row * sparse_sdf_tile_size + r));
+	};
+	for (size_t r = 0; r < stride; ++ r)
+		for (size_t c = 0; c < stride; ++ c) {
+			ClosestPointResult cp = this->closest_point_signed_distance(node_point(r, c), band);
+			if (cp.valid())
+				values[r * stride + c] = float(cp.distance);
+			else
+				unknown[r * stride + c] = true;
+		}
+
+	// Neighbor nodes out of band are not separated by a contour, as band >= resolution.
+	// Thus the signum is tested once for each connected component of the nodes out of band.
+	std::vector<size_t> queue;
+	for (size_t i = 0; i < unknown.size(); ++ i)
+		if (unknown[i]) {
+			float value = this->inside_by_ray(node_point(i / stride, i % stride)) ? - float(band) : float(band);
+			unknown[i] = false;
+			queue.assign(1, i);
+			while (! queue.empty()) {
+				size_t j = queue.back();
+				queue.pop_back();
+				values[j] = value;
+				size_t r = j / stride, c = j % stride;
+				auto visit = [&unknown, &queue](size_t k) { if (unknown[k]) { unknown[k] = false; queue.emplace_back(k); } };
+				if (r > 0)          visit(j - stride);
+				if (r + 1 < stride) visit(j + stride);
+				if (c > 0)          visit(j - 1);
+				if (c + 1 < stride) visit(j + 1);
+			}
+		}
+	return values;
+}
+
+float EdgeGrid::Grid::sparse_sdf_value(size_t row, size_t col) const
+{
+	assert(m_sparse_sdf);
+	SparseSDF &sdf = *m_sparse_sdf;
+	size_t tile_row = std::min(row / sparse_sdf_tile_size, sdf.rows - 1);
+	size_t tile_col = std::min(col / sparse_sdf_tile_size, sdf.cols - 1);
+	size_t tile_idx = tile_row * sdf.cols + tile_col;
+	if (! sdf.in_band[tile_idx]) {
+		int8_t sign = sdf.signs[tile_idx].load(std::memory_order_relaxed);
+		if (sign == 0) {
+			// All nodes of the tile are farther than band from the contours, thus they are all on the same side.
+			sign = this->inside_by_ray(m_bbox.min + m_resolution * Point(coord_t(col), coord_t(row))) ? -1 : 1;
+			sdf.signs[tile_idx].store(sign, std::memory_order_relaxed);
+		}
+		return float(sign * sdf.band);
+	}
+	float *tile = sdf.tiles[tile_idx].load(std::memory_order_acquire);
+	if (tile == nullptr) {
+		std::vector<float> values = this->calculate_sparse_sdf_tile(tile_row, tile_col);
+		float *new_tile = new float[values.size()];
+		std::copy(values.begin(), values.end(), new_tile);
+		// Another thread may have calculated the same tile in the meantime.
+		if (sdf.tiles[tile_idx].compare_exchange_strong(tile, new_tile, std::memory_order_acq_rel)) {
+			tile = new_tile;
+			++ sdf.num_tiles_calculated;
+		} else
+			delete[] new_tile;
+	}
+	return tile[(row - tile_row * sparse_sdf_tile_size) * sparse_sdf_tile_stride + col - tile_col * sparse_sdf_tile_size];
+}
+
+void EdgeGrid::Grid::calculate_sparse_sdf_tiles() const
+{
+	assert(m_sparse_sdf);
+	const SparseSDF &sdf = *m_sparse_sdf;
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, sdf.rows * sdf.cols), [this, &sdf](const tbb::blocked_range<size_t> &range) {
+		for (size_t tile_idx = range.begin(); tile_idx < range.end(); ++ tile_idx)
+			if (sdf.in_band[tile_idx])
+				this->sparse_sdf_value((tile_idx / sdf.cols) * sparse_sdf_tile_size, (tile_idx % sdf.cols) * sparse_sdf_tile_size);
+	});
+}
+
+size_t EdgeGrid::Grid::sdf_memory_size() const
+{
+	size_t size = m_signed_distance_field.capacity() * sizeof(float);
+	if (m_sparse_sdf) {
+		const SparseSDF &sdf = *m_sparse_sdf;
+		size_t num_tiles = sdf.rows * sdf.cols;
+		size += sizeof(SparseSDF) + num_tiles / 8 + num_tiles * (sizeof(std::atomic<float*>) + sizeof(std::atomic<int8_t>)) +
+			sdf.num_tiles_calculated * sparse_sdf_tile_stride * sparse_sdf_tile_stride * sizeof(float);
+	}
+	return size;
+}
+
+bool EdgeGrid::Grid::inside_by_ray(const Point &pt) const
+{
+	// Count crossings of a ray from pt in the positive x direction with the contours.
+	// pt may lie on the boundary of two rows of cells, collect segments of both of them.
+	coord_t y = pt.y() - m_bbox.min.y();
+	coord_t row = y / m_resolution;
+	coord_t col = std::max<coord_t>(0, (pt.x() - m_bbox.min.x()) / m_resolution);
+	if (y < 0 || row > coord_t(m_rows) || col >= coord_t(m_cols))
+		return false;
+	std::vector<std::pair<size_t, size_t>> segments;
+	for (coord_t r = std::max<coord_t>(0, row - 1); r <= std::min<coord_t>(row, m_rows - 1); ++ r)
+		for (coord_t c = col; c < coord_t(m_cols); ++ c) {
+			auto range = this->cell_data_range(r, c);
+			segments.insert(segments.end(), range.first, range.second);
+		}
+	sort_remove_duplicates(segments);
+	bool inside = false;
+	for (const std::pair<size_t, size_t> &segment : segments) {
+		const Line l = this->line(segment);
+		if ((l.a.y() > pt.y()) != (l.b.y() > pt.y())) {
+			double t = double(pt.y() - l.a.y()) / double(l.b.y() - l.a.y());
+			if (double(l.a.x()) + t * double(l.b.x() - l.a.x()) > double(pt.x()))
+				inside = ! inside;
+		}
+	}
+	return inside;
+}
+
 float EdgeGrid::Grid::signed_distance_bilinear(const Point &pt) const
 {
 #ifdef _DEBUG
@@ -1027,12 +1226,20 @@ float EdgeGrid::Grid::signed_distance_bilinear(const Point &pt) const
 	assert(tx >= -1e-5 && tx < 1.f + 1e-5);
 	float   ty = float(ycl - cell_r * m_resolution) / float(m_resolution);
 	assert(ty >= -1e-5 && ty < 1.f + 1e-5);
-	size_t  addr = cell_r * (m_cols + 1) + cell_c;
-	float   f00 = m_signed_distance_field[addr];
-	float   f01 = m_signed_distance_field[addr+1];
-	addr += m_cols + 1;
-	float   f10 = m_signed_distance_field[addr];
-	float   f11 = m_signed_distance_field[addr+1];
+	float   f00, f01, f10, f11;
+	if (m_sparse_sdf) {
+		f00 = this->sparse_sdf_value(cell_r,     cell_c);
+		f01 = this->sparse_sdf_value(cell_r,     cell_c + 1);
+		f10 = this->sparse_sdf_value(cell_r + 1, cell_c);
+		f11 = this->sparse_sdf_value(cell_r + 1, cell_c + 1);
+	} else {
+		size_t addr = cell_r * (m_cols + 1) + cell_c;
+		f00 = m_signed_distance_field[addr];
+		f01 = m_signed_distance_field[addr+1];
+		addr += m_cols + 1;
+		f10 = m_signed_distance_field[addr];
+		f11 = m_signed_distance_field[addr+1];
+	}
 	float   f0  = (1.f - tx) * f00 + tx * f01;
 	float   f1  = (1.f - tx) * f10 + tx * f11;
 	float	f   = (1.f - ty) * f0 + ty * f1;
@@ -1297,7 +1504,7 @@ bool EdgeGrid::Grid::signed_distance(const Point &pt, coord_t search_radius, coo
 #endif
 	if (signed_distance_edges(pt, search_radius, result_min_dist))
 		return true;
-	if (m_signed_distance_field.empty())
+	if (m_signed_distance_field.empty() && ! m_sparse_sdf)
 		return false;
 	result_min_dist = signed_distance_bilinear(pt);
 	return true;
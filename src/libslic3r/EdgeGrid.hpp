@@ -7,6 +7,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <memory>
 
 #include "Point.hpp"
 #include "BoundingBox.hpp"
@@ -136,7 +137,20 @@ public:
 	// Only call this function for closed contours!
 	void calculate_sdf();
 
-	// Return an estimate of the signed distance based on m_signed_distance_field grid.
+	// Prepare a sparse signed distance field as a replacement of calculate_sdf() for queries close to the contours.
+	// The grid nodes are split into square tiles, only the tiles closer than band to the contours are stored,
+	// each of them calculated on its first query. Farther from the contours, the distance is clamped to +-band.
+	// The sparse field does not allocate anything until queried, thus it is cheap for large grids.
+	// Only call this function for closed contours!
+	void calculate_sparse_sdf(coord_t band);
+	// Calculate all tiles of the sparse signed distance field in parallel ahead of the queries.
+	void calculate_sparse_sdf_tiles() const;
+	// Count of the tiles of the sparse signed distance field closer than band to the contours.
+	size_t sparse_sdf_tiles_in_band() const;
+	// Memory allocated by the signed distance field (either the full or the sparse one) in bytes.
+	size_t sdf_memory_size() const;
+
+	// Return an estimate of the signed distance based on m_signed_distance_field grid or on the sparse field.
 	float signed_distance_bilinear(const Point &pt) const;
 
 	// Calculate a signed distance to the contours in search_radius from the point.
@@ -411,9 +425,16 @@ protected:
 		const Cell &cell = m_cells[r * m_cols + c];
 		return 
 			(cell.begin < cell.end) || 
-			(! m_signed_distance_field.empty() && m_signed_distance_field[r * (m_cols + 1) + c] <= 0.f);
+			(! m_signed_distance_field.empty() && m_signed_distance_field[r * (m_cols + 1) + c] <= 0.f) ||
+			(m_sparse_sdf && sparse_sdf_value(r, c) <= 0.f);
 	}
 
+	// Value of the sparse signed distance field at a grid node, calculates the tile of the node if needed.
+	float sparse_sdf_value(size_t row, size_t col) const;
+	std::vector<float> calculate_sparse_sdf_tile(size_t tile_row, size_t tile_col) const;
+	// Is the point inside of the contours? Tested by a ray crossing the contours.
+	bool inside_by_ray(const Point &pt) const;
+
 	// Bounding box around the contours.
 	BoundingBox 								m_bbox;
 	// Grid dimensions.
@@ -435,6 +456,10 @@ protected:
 	// Distance field derived from the edge grid, seed filled by the Danielsson chamfer metric.
 	// May be empty.
 	std::vector<float>							m_signed_distance_field;
+	// Tiles of the sparse signed distance field, calculated on demand. May be null.
+	// Shared by copies of the grid, as the tiles depend only on the contours.
+	struct SparseSDF;
+	std::shared_ptr<SparseSDF>					m_sparse_sdf;
 #ifdef _DEBUG
     bool m_signed_distance_field_computed = false;
 #endif
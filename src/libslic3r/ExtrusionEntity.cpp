@@ -36,6 +36,18 @@ void ExtrusionVisitorConst::use(const ExtrusionLoop &loop) { default_use(loop);
 void ExtrusionVisitorConst::use(const ExtrusionEntityCollection &collection) { default_use(collection); }
 void ExtrusionVisitorConst::use(const ExtrusionNop &nop) { default_use(nop); }
 
+uint32_t ExtrusionEntity::next_id()
+{
+    thread_local uint32_t next = 0;
+    thread_local uint32_t end  = 0;
+    if (next == end) {
+        // Ids start from 1, as with the former ++id_generator.
+        next = uint32_t(id_generator.fetch_add(IdRangeSize, std::memory_order_relaxed)) + 1;
+        end  = next + IdRangeSize;
+    }
+    return next ++;
+}
+
 void ExtrusionEntity::visit(ExtrusionVisitor &&visitor) { this->visit(visitor); }
 void ExtrusionEntity::visit(ExtrusionVisitorConst &&visitor) const { this->visit(visitor); }
 
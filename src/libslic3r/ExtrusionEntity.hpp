@@ -9,6 +9,7 @@
 #define slic3r_ExtrusionEntity_hpp_
 
 #include "libslic3r.h"
+#include "ExtrusionEntityArena.hpp"
 #include "ExtrusionRole.hpp"
 #include "Flow.hpp"
 #include "Polygon.hpp"
@@ -333,15 +334,18 @@ class ExtrusionEntity
 {
 protected:
     static inline std::atomic_int32_t id_generator;
+    // Each thread reserves a range of IdRangeSize ids from id_generator, to not contend on a single atomic.
+    static constexpr int32_t IdRangeSize = 4096;
+    static uint32_t next_id();
     uint32_t m_id; // for travel map
     // even if no_sort, allow to reverse() us (and our entities if they allow it, but they should) 
     bool m_can_reverse; //TODO: use (int64_t) m_id sign to embed this property, currently not an issue as 32+8 <= 64
     // unique_ptr to avoid creating one empty one, most of the time there is nothing and it's lighter that way.
     std::unique_ptr<ExtrusionProperty> m_property = nullptr;
 
-    ExtrusionEntity(bool can_reverse) : m_can_reverse(can_reverse) , m_id(++id_generator) {}
+    ExtrusionEntity(bool can_reverse) : m_can_reverse(can_reverse) , m_id(next_id()) {}
     ExtrusionEntity(std::unique_ptr<ExtrusionProperty> &&eprop, bool can_reverse)
-        : m_property(std::move(eprop)), m_can_reverse(can_reverse), m_id(++id_generator) {}
+        : m_property(std::move(eprop)), m_can_reverse(can_reverse), m_id(next_id()) {}
     ExtrusionEntity(const ExtrusionEntity &rhs)
         : m_can_reverse(rhs.m_can_reverse)
         , m_id(rhs.m_id)
@@ -362,6 +366,10 @@ protected:
         return *this;
     }
 public:
+    // Allocated from the ExtrusionEntityArena of the current thread, if an ExtrusionEntityArena::Scope is active.
+    static void *operator new(size_t size) { return ExtrusionEntityArena::allocate(size); }
+    static void  operator delete(void *ptr) noexcept { ExtrusionEntityArena::deallocate(ptr); }
+
     uint64_t get_id() const { return m_id; }
     virtual ExtrusionRole role() const = 0;
     virtual bool has_role(ExtrusionRole) const = 0;
@@ -0,0 +1,116 @@
+#include "ExtrusionEntityArena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace Slic3r {
+
+// Each allocation is prefixed by a header pointing to the chunk it was allocated from,
+// nullptr for the allocations done on the heap.
+static constexpr size_t HeaderSize = alignof(std::max_align_t);
+
+struct ExtrusionEntityArena::Chunk
+{
+    // Number of live allocations, plus one for the arena while the chunk is being filled.
+    std::atomic<size_t> refs { 1 };
+};
+
+static std::atomic<size_t> s_chunks_alive { 0 };
+static std::atomic<size_t> s_allocations_alive { 0 };
+
+static thread_local ExtrusionEntityArena *s_current_arena = nullptr;
+
+static inline size_t align_up(size_t size) { return (size + HeaderSize - 1) & ~(HeaderSize - 1); }
+
+void ExtrusionEntityArena::release_chunk(Chunk *chunk) noexcept
+{
+    if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        chunk->~Chunk();
+        ::operator delete(static_cast<void*>(chunk));
+        s_chunks_alive.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+ExtrusionEntityArena::Scope::Scope() : m_previous(s_current_arena)
+{
+    s_current_arena = new ExtrusionEntityArena();
+}
+
+ExtrusionEntityArena::Scope::~Scope()
+{
+    assert(s_current_arena != nullptr);
+    delete s_current_arena;
+    s_current_arena = m_previous;
+}
+
+ExtrusionEntityArena::~ExtrusionEntityArena()
+{
+    this->retire_chunk();
+}
+
+ExtrusionEntityArena *ExtrusionEntityArena::current()
+{
+    return s_current_arena;
+}
+
+void *ExtrusionEntityArena::allocate(size_t size)
+{
+    if (ExtrusionEntityArena *arena = s_current_arena; arena != nullptr && size <= MaxAllocationSize)
+        return arena->allocate_from_chunk(size);
+    auto *mem = static_cast<char*>(::operator new(HeaderSize + size));
+    *reinterpret_cast<Chunk**>(mem) = nullptr;
+    return mem + HeaderSize;
+}
+
+void ExtrusionEntityArena::deallocate(void *ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+    char  *mem   = static_cast<char*>(ptr) - HeaderSize;
+    Chunk *chunk = *reinterpret_cast<Chunk**>(mem);
+    if (chunk == nullptr) {
+        ::operator delete(mem);
+    } else {
+        s_allocations_alive.fetch_sub(1, std::memory_order_relaxed);
+        release_chunk(chunk);
+    }
+}
+
+void *ExtrusionEntityArena::allocate_from_chunk(size_t size)
+{
+    const size_t needed = HeaderSize + align_up(size);
+    if (m_chunk == nullptr || size_t(m_end - m_top) < needed) {
+        this->retire_chunk();
+        char *mem = static_cast<char*>(::operator new(ChunkSize));
+        m_chunk   = new (mem) Chunk();
+        m_top     = mem + align_up(sizeof(Chunk));
+        m_end     = mem + ChunkSize;
+        s_chunks_alive.fetch_add(1, std::memory_order_relaxed);
+    }
+    assert(size_t(m_end - m_top) >= needed);
+    char *mem = m_top;
+    m_top += needed;
+    *reinterpret_cast<Chunk**>(mem) = m_chunk;
+    m_chunk->refs.fetch_add(1, std::memory_order_relaxed);
+    s_allocations_alive.fetch_add(1, std::memory_order_relaxed);
+    return mem + HeaderSize;
+}
+
+void ExtrusionEntityArena::retire_chunk()
+{
+    if (m_chunk != nullptr) {
+        // Drop the reference of the arena, the chunk is released once all its entities are deleted.
+        release_chunk(m_chunk);
+        m_chunk = nullptr;
+        m_top   = nullptr;
+        m_end   = nullptr;
+    }
+}
+
+ExtrusionEntityArena::Stats ExtrusionEntityArena::stats()
+{
+    return { s_chunks_alive.load(std::memory_order_relaxed), s_allocations_alive.load(std::memory_order_relaxed) };
+}
+
+} // namespace Slic3r
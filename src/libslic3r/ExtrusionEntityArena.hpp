@@ -0,0 +1,75 @@
+#ifndef slic3r_ExtrusionEntityArena_hpp_
+#define slic3r_ExtrusionEntityArena_hpp_
+
+#include <atomic>
+#include <cstddef>
+
+namespace Slic3r {
+
+// Bump allocator for ExtrusionEntities.
+// Perimeter and infill generation create millions of small ExtrusionEntities, each allocated separately on the heap.
+// While an ExtrusionEntityArena::Scope is active on a thread, the ExtrusionEntities created by that thread are allocated
+// from chunks owned by the scope, so the entities of one layer end up packed in a few chunks.
+// A chunk is reference counted by the entities allocated from it, it is released in one shot when the last of them is deleted,
+// thus the entities may be freely moved to other collections, deleted or outlive the scope.
+// The memory of a deleted entity is never reused, not even inside the scope that allocated it: the arena only bumps
+// its top pointer, and a chunk goes back to the heap only once all its entities are deleted. Code creating many
+// temporary entities inside a scope thus grows the chunks until the scope ends, and a single surviving entity
+// keeps its whole chunk alive.
+class ExtrusionEntityArena
+{
+public:
+    static constexpr size_t ChunkSize = 256 * 1024;
+    // Larger allocations go to the heap.
+    static constexpr size_t MaxAllocationSize = ChunkSize / 16;
+
+    // Allocations of ExtrusionEntities by the current thread go to a new arena during the lifetime of the scope.
+    // Scopes may be nested, for example when TBB executes a task of another layer while waiting.
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        ExtrusionEntityArena *m_previous;
+    };
+
+    ExtrusionEntityArena() = default;
+    ~ExtrusionEntityArena();
+    ExtrusionEntityArena(const ExtrusionEntityArena &) = delete;
+    ExtrusionEntityArena &operator=(const ExtrusionEntityArena &) = delete;
+
+    // Allocate from the arena of the current thread, or from the heap if there is no Scope active.
+    static void *allocate(size_t size);
+    static void  deallocate(void *ptr) noexcept;
+
+    // Arena of the current thread, nullptr if no Scope is active.
+    static ExtrusionEntityArena *current();
+
+    struct Stats
+    {
+        // Chunks allocated and not yet released.
+        size_t chunks_alive;
+        // Entities allocated from the chunks and not yet deleted.
+        size_t allocations_alive;
+    };
+    static Stats stats();
+
+private:
+    struct Chunk;
+
+    void *allocate_from_chunk(size_t size);
+    void  retire_chunk();
+    static void release_chunk(Chunk *chunk) noexcept;
+
+    Chunk *m_chunk { nullptr };
+    char  *m_top   { nullptr };
+    char  *m_end   { nullptr };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_ExtrusionEntityArena_hpp_
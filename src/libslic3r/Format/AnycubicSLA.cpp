@@ -542,12 +542,16 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
         //layers
         layer_images.reserve(layer_count * LAYER_SIZE_ESTIMATE);
         image_offset = intro.image_data_offset;
+        // The layers with the same raster point to the same image.
+        std::vector<std::uint32_t> image_offsets(layer_count);
         size_t i = 0;
         for (const sla::EncodedRaster &rst : m_layers) {
             anycubicsla_format_layer l;
             std::memset(&l, 0, sizeof(l));
-            l.image_offset = image_offset;
+            const bool duplicate = i < m_layer_sources.size() && m_layer_sources[i] != i;
+            l.image_offset = duplicate ? image_offsets[m_layer_sources[i]] : image_offset;
             l.image_size = rst.size();
+            image_offsets[i] = l.image_offset;
             if (i < header.bottom_layer_count) {
                 l.exposure_time_s = header.bottom_exposure_time_s;
                 l.layer_height_mm = misc.bottom_layer_height_mm;
@@ -559,12 +563,14 @@ void AnycubicSLAArchive::export_print(const std::string     fname,
                 l.lift_distance_mm = header.lift_distance_mm;
                 l.lift_speed_mms = header.lift_speed_mms;
             }
-            image_offset += l.image_size;
             anycubicsla_write_layer(out, l);
-            // add the rle encoded layer image into the buffer
-            const char* img_start = reinterpret_cast<const char*>(rst.data());
-            const char* img_end = img_start + rst.size();
-            std::copy(img_start, img_end, std::back_inserter(layer_images));
+            if (! duplicate) {
+                image_offset += l.image_size;
+                // add the rle encoded layer image into the buffer
+                const char* img_start = reinterpret_cast<const char*>(rst.data());
+                const char* img_end = img_start + rst.size();
+                std::copy(img_start, img_end, std::back_inserter(layer_images));
+            }
             i++;
         }
         const char* img_buffer = reinterpret_cast<const char*>(layer_images.data());
@@ -168,7 +168,7 @@ std::unique_ptr<sla::RasterBase> SL1Archive::create_raster() const
 
 sla::RasterEncoder SL1Archive::get_encoder() const
 {
-    return sla::PNGRasterEncoder{};
+    return sla::PNGRasterEncoder{m_png_compression};
 }
 
 static void write_thumbnail(Zipper &zipper, const ThumbnailData &data)
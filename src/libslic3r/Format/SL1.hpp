@@ -17,6 +17,9 @@ namespace Slic3r {
 
 class SL1Archive: public SLAArchiveWriter {
     SLAPrinterConfig m_cfg;
+
+    // Any standard PNG is readable by SL1 consumers, prefer encoding speed.
+    sla::PNGCompression m_png_compression = sla::PNGCompression::Fast;
     
 protected:
     std::unique_ptr<sla::RasterBase> create_raster() const override;
@@ -36,6 +39,8 @@ public:
     explicit SL1Archive(const SLAPrinterConfig &cfg): m_cfg(cfg) {}
     explicit SL1Archive(SLAPrinterConfig &&cfg): m_cfg(std::move(cfg)) {}
 
+    void set_png_compression(sla::PNGCompression c) { m_png_compression = c; }
+
     void export_print(const std::string     fname,
                       const SLAPrint       &print,
                       const ThumbnailsList &thumbnails,
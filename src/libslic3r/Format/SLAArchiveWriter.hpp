@@ -6,6 +6,8 @@
 #define SLAARCHIVE_HPP
 
 #include <vector>
+#include <numeric>
+#include <cassert>
 
 #include "libslic3r/Config.hpp"
 #include "libslic3r/SLA/RasterBase.hpp"
@@ -21,6 +23,11 @@ class SLAArchiveWriter {
 protected:
     std::vector<sla::EncodedRaster> m_layers;
 
+    // Index of the layer whose raster is shared by each layer, see
+    // draw_layers(). Archives able to reference an image from several layers
+    // store the shared rasters only once.
+    std::vector<size_t> m_layer_sources;
+
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
@@ -28,25 +35,56 @@ public:
     virtual ~SLAArchiveWriter() = default;
 
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
+    // sources[i] is the index of a layer drawn the same way as the layer i,
+    // not greater than i, or i itself. Only the layers being their own source
+    // are drawn and encoded, the others share the raster of their source.
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
-        size_t     layer_num,
-        Fn &&      drawfn,
+        std::vector<size_t> sources,
+        Fn &&               drawfn,
         CancelFn cancelfn = []() { return false; },
-        const EP & ep       = {})
+        const EP &          ep       = {})
     {
-        m_layers.resize(layer_num);
+        m_layer_sources = std::move(sources);
+        m_layers.clear();
+        m_layers.resize(m_layer_sources.size());
+
+        std::vector<size_t> drawn;
+        for (size_t idx = 0; idx < m_layer_sources.size(); ++idx) {
+            assert(m_layer_sources[idx] <= idx);
+            assert(m_layer_sources[m_layer_sources[idx]] == m_layer_sources[idx]);
+            if (m_layer_sources[idx] == idx)
+                drawn.emplace_back(idx);
+        }
+
         execution::for_each(
-            ep, size_t(0), m_layers.size(),
-            [this, &drawfn, &cancelfn](size_t idx) {
+            ep, size_t(0), drawn.size(),
+            [this, &drawn, &drawfn, &cancelfn](size_t i) {
                 if (cancelfn()) return;
 
+                size_t              idx = drawn[i];
                 sla::EncodedRaster &enc = m_layers[idx];
                 auto                rst = create_raster();
                 drawfn(*rst, idx);
                 enc = rst->encode(get_encoder());
             },
             execution::max_concurrency(ep));
+
+        for (size_t idx = 0; idx < m_layers.size(); ++idx)
+            if (m_layer_sources[idx] != idx)
+                m_layers[idx] = m_layers[m_layer_sources[idx]];
+    }
+
+    template<class Fn, class CancelFn, class EP = ExecutionTBB>
+    void draw_layers(
+        size_t     layer_num,
+        Fn &&      drawfn,
+        CancelFn cancelfn = []() { return false; },
+        const EP & ep       = {})
+    {
+        std::vector<size_t> sources(layer_num);
+        std::iota(sources.begin(), sources.end(), size_t(0));
+        draw_layers(std::move(sources), std::forward<Fn>(drawfn), cancelfn, ep);
     }
 
     // Export the print into an archive using the provided filename.
@@ -1902,6 +1902,14 @@ void GCodeGenerator::_do_export(Print& print_mod, GCodeOutputStream &file, Thumb
     m_writer.reset();
 
     const bool export_to_binary_gcode = print.full_print_config().option("binary_gcode")->get_bool();
+    // Evaluated before the export, as the layers may be released by the low memory mode during the export.
+    bool has_support = false;
+    for (const PrintObject *object : print.objects())
+        for (const Layer *supp_layer : object->support_layers())
+            if (supp_layer->has_extrusions()) {
+                has_support = true;
+                break;
+            }
     // if exporting gcode in binary format: 
     // we generate here the data to be passed to the post-processor, who is responsible to export them to file 
     // 1) generate the thumbnails
@@ -2976,7 +2984,15 @@ void GCodeGenerator::_do_export(Print& print_mod, GCodeOutputStream &file, Thumb
                 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
                 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
                 // and export G-code into file.
+                // In low memory mode, the layers are released as soon as the G-code generator is done with them.
+                m_release_layers = print.low_memory_mode();
                 this->process_layers(print, status_monitor, print.tool_orderings().front(), print_object_instances_ordering, layers_to_print, preamble_to_put_start_layer, file);
+                m_release_layers = false;
+                // Release the last layers of each object kept for the layers above them.
+                for (std::pair<const std::pair<const PrintObject*, bool>, std::deque<const Layer*>> &queue : m_layers_to_release)
+                    for (const Layer *layer : queue.second)
+                        const_cast<Layer*>(layer)->release_geometry();
+                m_layers_to_release.clear();
             }
         }
     }
@@ -3079,14 +3095,6 @@ void GCodeGenerator::_do_export(Print& print_mod, GCodeOutputStream &file, Thumb
 
         //nematx web fields
         // has support
-        bool has_support = false;
-        for (const PrintObject *object : print.objects()) {
-            for (const Layer *supp_layer : object->support_layers()) {
-                if (supp_layer->has_extrusions()) {
-                    has_support = true;
-                }
-            }
-        }
         file.write_format("; has_support = %s\n", has_support ? "1" : "0");
 
         // if exporting gcode in ascii format, config export is done here
@@ -3140,6 +3148,28 @@ void GCodeGenerator::_move_to_print_object(std::string& gcode_out, const Print&
     this->placeholder_parser().set("current_object_idx", int(finished_objects));
 }
 
+void GCodeGenerator::release_exported_layers(const ObjectsLayerToPrint &layers)
+{
+    auto release = [this](const Layer *layer, bool support) {
+        if (layer == nullptr)
+            return;
+        std::deque<const Layer*> &queue = m_layers_to_release[std::make_pair(layer->object(), support)];
+        if (! queue.empty() && queue.back() == layer)
+            return;
+        queue.emplace_back(layer);
+        if (queue.size() > 2) {
+            // The generator accesses the layers through const pointers, but it is the only user of the layers
+            // in the low memory mode, which invalidates all the PrintObject steps after the export.
+            const_cast<Layer*>(queue.front())->release_geometry();
+            queue.pop_front();
+        }
+    };
+    for (const ObjectLayerToPrint &l : layers) {
+        release(l.object_layer, false);
+        release(l.support_layer, true);
+    }
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -3230,6 +3260,8 @@ void GCodeGenerator::process_layers(
                                                          &print_object_instances_ordering, size_t(-1));
                 result.gcode = preamble + result.gcode;
                 preamble.clear();
+                if (m_release_layers)
+                    this->release_exported_layers(layer.second);
                 return result;
             }
         });
@@ -49,6 +49,7 @@
 
 #include <memory>
 #include <map>
+#include <deque>
 #include <string>
 #include <chrono>
 
@@ -141,6 +142,8 @@ public:
     // throws std::runtime_exception on error,
     // throws CanceledException through print->throw_if_canceled().
     void            do_export(Print* print, const char* path, GCodeProcessorResult* result = nullptr, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // The final G-code is passed to the sink while it is being written, see GCodeProcessor::set_output_sink().
+    void            set_output_sink(GCodeProcessor::OutputSink sink) { m_processor.set_output_sink(std::move(sink)); }
 
     // Exported for the helper classes (OozePrevention, Wipe) and for the Perl binding for unit tests.
     const Vec2d&    origin() const { return m_origin; }
@@ -611,6 +614,12 @@ private:
     // to get extruded volume, for stats
     const WipeTowerData                *m_wipe_tower_data;
 
+    // Low memory mode: release the geometry of the layers already exported, keeping the last two layers
+    // of each object (and of its support) alive, as the G-code of a layer may reference its lower layer.
+    bool                                m_release_layers = false;
+    std::map<std::pair<const PrintObject*, bool>, std::deque<const Layer*>> m_layers_to_release;
+    void                                release_exported_layers(const ObjectsLayerToPrint &layers);
+
     // Heights (print_z) at which the skirt has already been extruded.
     std::vector<coord_t>                m_skirt_done;
     // Has the brim been extruded already? Brim is being extruded only for the first object of a multi-object print.
@@ -12,6 +12,7 @@
 #include "libslic3r/I18N.hpp"
 #include "libslic3r/Geometry/ArcWelder.hpp"
 #include "GCodeProcessor.hpp"
+#include "ParallelGCodeBinarizer.hpp"
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/log/trivial.hpp>
@@ -1258,7 +1259,7 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, std::functi
     m_result.id = ++s_result_id;
     initialize_result_moves();
     size_t parse_line_callback_cntr = 10000;
-    m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
+    auto   parse_line_callback = [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
         if (-- parse_line_callback_cntr == 0) {
             // Don't call the cancel_callback() too often, do it every at every 10000'th line.
             parse_line_callback_cntr = 10000;
@@ -1266,7 +1267,12 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, std::functi
                 cancel_callback();
         }
         this->process_gcode_line(line, true);
-    }, m_result.lines_ends);
+    };
+    if (m_parallel_parsing)
+        // The lines are tokenized by worker threads, the G-code state machine and the time estimator are executed serially.
+        m_parser.parse_file_parallel(filename, parse_line_callback, m_result.lines_ends);
+    else
+        m_parser.parse_file(filename, parse_line_callback, m_result.lines_ends);
 
     // Don't post-process the G-code to update time stamps.
     this->finalize(false);
@@ -4088,6 +4094,7 @@ void GCodeProcessor::post_process()
 
     double total_g_wipe_tower = m_status_monitor->stats().total_wipe_tower_filament_weight;
 
+    std::unique_ptr<ParallelGCodeBinarizer> gcode_binarizer;
     if (m_binarizer.is_enabled()) {
         // update print metadata
         auto stringify = [](const std::vector<double>& values) {
@@ -4132,6 +4139,8 @@ void GCodeProcessor::post_process()
         const bgcode::core::EResult res = m_binarizer.initialize(*out.f, s_binarizer_config);
         if (res != bgcode::core::EResult::Success)
             throw Slic3r::RuntimeError(format("Unable to initialize the gcode binarizer.\nError: %1%", bgcode::core::translate_result(res)));
+        // the G-code blocks are compressed in parallel, the Binarizer writes the header and the metadata blocks only
+        gcode_binarizer = std::make_unique<ParallelGCodeBinarizer>(*out.f, s_binarizer_config);
     }
 
     auto time_in_minutes = [](float time_in_seconds) {
@@ -4319,10 +4328,12 @@ void GCodeProcessor::post_process()
         size_t m_times_cache_id{ 0 };
         size_t m_out_file_pos{ 0 };
 
-        bgcode::binarize::Binarizer& m_binarizer;
+        // writes the G-code blocks of the binary G-code, nullptr when exporting ASCII G-code
+        ParallelGCodeBinarizer* m_binarizer{ nullptr };
+        OutputSink* m_output_sink{ nullptr };
 
     public:
-        ExportLines(bgcode::binarize::Binarizer& binarizer, EWriteType type, TimeMachine& machine)
+        ExportLines(ParallelGCodeBinarizer* binarizer, EWriteType type, TimeMachine& machine)
 #ifndef NDEBUG
         : m_statistics(*this), m_binarizer(binarizer), m_write_type(type), m_machine(machine) {}
 #else
@@ -4465,8 +4476,8 @@ void GCodeProcessor::post_process()
                 }
             }
 
-            if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
+            if (m_binarizer != nullptr) {
+                if (m_binarizer->append_gcode(out_string) != bgcode::core::EResult::Success)
                     throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
             }
             else {
@@ -4488,8 +4499,8 @@ void GCodeProcessor::post_process()
             m_statistics.remove_all_lines();
 #endif // NDEBUG
 
-            if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
+            if (m_binarizer != nullptr) {
+                if (m_binarizer->append_gcode(out_string) != bgcode::core::EResult::Success)
                     throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
             }
             else {
@@ -4511,22 +4522,28 @@ void GCodeProcessor::post_process()
 
         size_t get_size() const { return m_size; }
 
+        void set_output_sink(OutputSink* sink) { m_output_sink = sink; }
+
     private:
         void write_to_file(FilePtr& out, const std::string& out_string, GCodeProcessorResult& result, const std::string& out_path) {
             if (!out_string.empty()) {
-                if (!m_binarizer.is_enabled()) {
+                if (m_binarizer == nullptr) {
                     fwrite((const void*)out_string.c_str(), 1, out_string.length(), out.f);
                     if (ferror(out.f)) {
                         out.close();
                         boost::nowide::remove(out_path.c_str());
                         throw Slic3r::RuntimeError("GCode processor post process export failed.\nIs the disk full?");
                     }
+                    if (m_output_sink != nullptr && *m_output_sink && !(*m_output_sink)(out_string.data(), out_string.size()))
+                        // The consumer gave up, keep writing just the file.
+                        *m_output_sink = nullptr;
                 }
             }
         }
     };
 
-    ExportLines export_lines(m_binarizer, m_result.backtrace_enabled ? ExportLines::EWriteType::ByTime : ExportLines::EWriteType::BySize, m_time_processor.machines[0]);
+    ExportLines export_lines(gcode_binarizer.get(), m_result.backtrace_enabled ? ExportLines::EWriteType::ByTime : ExportLines::EWriteType::BySize, m_time_processor.machines[0]);
+    export_lines.set_output_sink(&m_output_sink);
 
     // replace placeholder lines with the proper final value
     // gcode_line is in/out parameter, to reduce expensive memory allocation
@@ -4828,6 +4845,9 @@ void GCodeProcessor::post_process()
     export_lines.flush(out, m_result, out_path);
 
     if (m_binarizer.is_enabled()) {
+        if (const bgcode::core::EResult res = gcode_binarizer->finalize(); res != bgcode::core::EResult::Success)
+            throw Slic3r::RuntimeError(format("Error while writing the binary gcode blocks.\nError: %1%", bgcode::core::translate_result(res)));
+        gcode_binarizer.reset();
         if (m_binarizer.finalize() != bgcode::core::EResult::Success)
             throw Slic3r::RuntimeError("Error while finalizing the gcode binarizer.");
     }
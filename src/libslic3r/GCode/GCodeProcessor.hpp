@@ -23,6 +23,7 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <functional>
 
 namespace Slic3r {
     //class StatusMonitor;
@@ -574,6 +575,7 @@ namespace Slic3r {
         GCodeReader m_parser;
         bgcode::binarize::Binarizer m_binarizer;
         static bgcode::binarize::BinarizerConfig s_binarizer_config;
+        std::function<bool(const char*, size_t)> m_output_sink;
 
         EUnits m_units;
         EPositioningType m_global_positioning_type;
@@ -672,6 +674,8 @@ namespace Slic3r {
 
         GCodeProcessorResult m_result;
         bool m_has_reset = false;
+        // Tokenize the lines of ASCII G-code files by worker threads, see GCodeReader::parse_file_parallel().
+        bool m_parallel_parsing{ true };
         static unsigned int s_result_id;
 
 #if ENABLE_GCODE_VIEWER_DATA_CHECKING
@@ -693,6 +697,8 @@ namespace Slic3r {
             return m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Stealth)].enabled;
         }
         void enable_machine_envelope_processing(bool enabled) { m_time_processor.machine_envelope_processing_enabled = enabled; }
+        // The result does not depend on it, the serial parsing is kept for reference.
+        void enable_parallel_parsing(bool enabled) { m_parallel_parsing = enabled; }
         void reset();
 
         const GCodeProcessorResult& get_result() const { return m_result; }
@@ -717,6 +723,12 @@ namespace Slic3r {
         void process_buffer(const std::string& buffer);
         void finalize(bool post_process);
 
+        // Receives the final G-code while it is being written by finalize(true), for example to upload it to a print host
+        // while the file is still being post-processed. Once the sink returns false, it is not called anymore.
+        // Only the ASCII G-code is passed to the sink, the binary G-code is written by the binarizer directly.
+        using OutputSink = std::function<bool(const char* data, size_t size)>;
+        void set_output_sink(OutputSink sink) { m_output_sink = std::move(sink); }
+
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
         std::string get_time_dhm(PrintEstimatedStatistics::ETimeMode mode) const;
         float get_travel_time(PrintEstimatedStatistics::ETimeMode mode) const;
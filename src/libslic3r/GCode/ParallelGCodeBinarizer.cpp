@@ -0,0 +1,138 @@
+#include "ParallelGCodeBinarizer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+namespace Slic3r {
+
+using bgcode::core::EResult;
+
+ParallelGCodeBinarizer::ParallelGCodeBinarizer(FILE& file, const bgcode::binarize::BinarizerConfig& config, size_t batch_size) :
+    m_file(file), m_config(config),
+    m_batch_size(batch_size > 0 ? batch_size : 2 * size_t(std::max(1, tbb::this_task_arena::max_concurrency())))
+{
+    m_cache.reserve(MAX_BLOCK_SIZE);
+}
+
+ParallelGCodeBinarizer::~ParallelGCodeBinarizer()
+{
+    m_tasks.wait();
+}
+
+EResult ParallelGCodeBinarizer::append_gcode(const std::string& gcode)
+{
+    // Same splitting into blocks as bgcode::binarize::Binarizer::append_gcode(): a block is closed before the line which would overflow it.
+    size_t begin = 0;
+    while (begin < gcode.size()) {
+        const size_t end = gcode.find('\n', begin);
+        if (end == std::string::npos)
+            return EResult::WriteError;
+        const size_t line_size = end + 1 - begin;
+        if (line_size + m_cache.size() > MAX_BLOCK_SIZE && ! m_cache.empty()) {
+            m_queued.push_back({ std::move(m_cache) });
+            m_cache.clear();
+            m_cache.reserve(MAX_BLOCK_SIZE);
+            if (m_queued.size() >= m_batch_size) {
+                if (const EResult res = this->run_queued(); res != EResult::Success)
+                    return res;
+            }
+        }
+        if (line_size > MAX_BLOCK_SIZE)
+            return EResult::WriteError;
+        m_cache.append(gcode, begin, line_size);
+        begin = end + 1;
+    }
+    return EResult::Success;
+}
+
+EResult ParallelGCodeBinarizer::finalize()
+{
+    if (! m_cache.empty()) {
+        m_queued.push_back({ std::move(m_cache) });
+        m_cache.clear();
+    }
+    if (const EResult res = this->run_queued(); res != EResult::Success)
+        return res;
+    return this->write_running();
+}
+
+void ParallelGCodeBinarizer::encode_block(Block& block) const
+{
+    bgcode::binarize::GCodeBlock gcode_block;
+    gcode_block.encoding_type = static_cast<uint16_t>(m_config.gcode_encoding);
+    gcode_block.raw_data = std::move(block.raw_data);
+#ifdef _WIN32
+    // The blocks are written by libbgcode into a FILE only and there is no memory backed FILE on Windows,
+    // let it write into a temporary file and read the block back.
+    FILE* file = std::tmpfile();
+    if (file == nullptr) {
+        block.result = EResult::WriteError;
+        return;
+    }
+    block.result = gcode_block.write(*file, m_config.compression.gcode, m_config.checksum);
+    if (block.result == EResult::Success) {
+        const long size = ftell(file);
+        if (size < 0)
+            block.result = EResult::WriteError;
+        else {
+            block.data.resize(size_t(size));
+            rewind(file);
+            if (fread(block.data.data(), 1, block.data.size(), file) != block.data.size())
+                block.result = EResult::ReadError;
+        }
+    }
+    fclose(file);
+#else
+    // The blocks are written by libbgcode into a FILE only, let it write into a memory backed FILE.
+    char*  buffer = nullptr;
+    size_t size   = 0;
+    FILE*  file   = open_memstream(&buffer, &size);
+    if (file == nullptr) {
+        block.result = EResult::WriteError;
+        return;
+    }
+    block.result = gcode_block.write(*file, m_config.compression.gcode, m_config.checksum);
+    // The buffer and its size are valid after the stream is closed.
+    if (fclose(file) != 0 && block.result == EResult::Success)
+        block.result = EResult::WriteError;
+    if (block.result == EResult::Success)
+        block.data.assign(buffer, buffer + size);
+    free(buffer);
+#endif // _WIN32
+}
+
+EResult ParallelGCodeBinarizer::run_queued()
+{
+    if (const EResult res = this->write_running(); res != EResult::Success)
+        return res;
+    if (m_queued.empty())
+        return EResult::Success;
+    std::swap(m_running, m_queued);
+    m_tasks.run([this]() {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_running.size(), 1), [this](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                this->encode_block(m_running[i]);
+        });
+    });
+    return EResult::Success;
+}
+
+EResult ParallelGCodeBinarizer::write_running()
+{
+    m_tasks.wait();
+    for (const Block& block : m_running) {
+        if (block.result != EResult::Success)
+            return block.result;
+        if (fwrite(block.data.data(), 1, block.data.size(), &m_file) != block.data.size() || ferror(&m_file))
+            return EResult::WriteError;
+    }
+    m_running.clear();
+    return EResult::Success;
+}
+
+} // namespace Slic3r
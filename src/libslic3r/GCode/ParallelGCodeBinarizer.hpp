@@ -0,0 +1,63 @@
+#ifndef slic3r_GCode_ParallelGCodeBinarizer_hpp_
+#define slic3r_GCode_ParallelGCodeBinarizer_hpp_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <LibBGCode/binarize/binarize.hpp>
+
+#include <oneapi/tbb/task_group.h>
+
+namespace Slic3r {
+
+// Writes the G-code blocks of a binary G-code file in place of bgcode::binarize::Binarizer::append_gcode().
+// The G-code is split into blocks the same way the Binarizer splits it, thus the file is identical to the one written by the Binarizer,
+// but the blocks are encoded and compressed in parallel, a batch of blocks at a time, while the caller is producing the next batch.
+// The blocks are written to the file in order.
+// The file header and the metadata blocks are written by Binarizer::initialize() before the first block is appended.
+class ParallelGCodeBinarizer
+{
+public:
+    // Max size of the G-code contained in a single block, the size of the G-code cache of bgcode::binarize::Binarizer.
+    static constexpr const size_t MAX_BLOCK_SIZE = 65536;
+
+    // batch_size: count of blocks compressed by a single parallel run, zero to derive it from the count of worker threads.
+    ParallelGCodeBinarizer(FILE& file, const bgcode::binarize::BinarizerConfig& config, size_t batch_size = 0);
+    ~ParallelGCodeBinarizer();
+
+    // Appends G-code lines, each one terminated by '\n'.
+    bgcode::core::EResult append_gcode(const std::string& gcode);
+    // Writes the remaining blocks, to be called before Binarizer::finalize().
+    bgcode::core::EResult finalize();
+
+private:
+    struct Block
+    {
+        std::string raw_data;
+        // header, encoded and compressed data and checksum, as written to the file
+        std::vector<char> data;
+        bgcode::core::EResult result{ bgcode::core::EResult::Success };
+    };
+
+    void                  encode_block(Block& block) const;
+    // Waits for the running batch, writes it, then starts the compression of the queued batch.
+    bgcode::core::EResult run_queued();
+    // Waits for the running batch and writes it.
+    bgcode::core::EResult write_running();
+
+    FILE&                                   m_file;
+    const bgcode::binarize::BinarizerConfig m_config;
+    size_t                                  m_batch_size;
+    // G-code of the block being filled
+    std::string                             m_cache;
+    // full blocks waiting for the current batch to be compressed
+    std::vector<Block>                      m_queued;
+    // blocks being compressed by m_tasks
+    std::vector<Block>                      m_running;
+    tbb::task_group                         m_tasks;
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_GCode_ParallelGCodeBinarizer_hpp_
@@ -252,12 +252,14 @@ namespace Slic3r {
 // Returns false if no post-processing script was defined.
 // Throws an exception on error.
 // host is one of "File", "PrusaLink", "Repetier", "SL1Host", "OctoPrint", "FlashAir", "Duet", "AstroBox" ...
-// For a "File" target, a temp file will be created for src_path by adding a ".pp" suffix and src_path will be updated.
+// If make_copy is set, a temp file will be created for src_path by adding a ".pp" suffix and src_path will be updated.
+// If copy_next_to_output is set as well, the temp file is created as a hidden file next to output_name instead,
+// so that it could be renamed over the target.
 // In that case the caller is responsible to delete the temp file created.
 // output_name is the final name of the G-code on SD card or when uploaded to PrusaLink or OctoPrint.
 // If uploading to PrusaLink or OctoPrint, then the file will be renamed to output_name first on the target host.
 // The post-processing script may change the output_name.
-bool run_post_process_scripts(std::string &src_path, bool make_copy, const std::string &host, std::string &output_name, const DynamicPrintConfig &config)
+bool run_post_process_scripts(std::string &src_path, bool make_copy, const std::string &host, std::string &output_name, const DynamicPrintConfig &config, bool copy_next_to_output)
 {
     const auto *post_process = config.opt<ConfigOptionStrings>("post_process");
     if (// likely running in SLA mode
@@ -269,8 +271,14 @@ bool run_post_process_scripts(std::string &src_path, bool make_copy, const std::
     std::string path;
     if (make_copy) {
         // Don't run the post-processing script on the input file, it will be memory mapped by the G-code viewer.
-        // Make a copy.
-        path = src_path + ".pp";
+        // Make a copy. If requested, place it on the filesystem of the target, so that the post-processed
+        // G-code is moved into place by an atomic rename instead of being copied once more. The copy is hidden,
+        // as it is left in the user's folder if PrusaSlicer crashes while running the script.
+        if (copy_next_to_output) {
+            boost::filesystem::path output_path(output_name);
+            path = (output_path.parent_path() / ("." + output_path.filename().string() + ".pp")).string();
+        } else
+            path = src_path + ".pp";
         // First delete an old file if it exists.
         try {
             if (boost::filesystem::exists(path))
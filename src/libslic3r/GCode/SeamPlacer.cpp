@@ -16,6 +16,7 @@
 #include <tuple>
 
 #include "libslic3r/AABBTreeLines.hpp"
+#include "libslic3r/AABBTreeWide.hpp"
 #include "libslic3r/BoundingBox.hpp"
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Color.hpp"
@@ -159,12 +160,20 @@ std::vector<float> raycast_visibility(const AABBTreeIndirect::Tree<3, float> &ra
 
     bool model_contains_negative_parts = negative_volumes_start_index < triangles.indices.size();
 
+    // The rays of a sample point share the origin and the neighboring directions are close,
+    // they are traced in packets through a wide tree.
+    AABBTreeIndirect::WideTree wide_tree;
+    if (!deactivate && !model_contains_negative_parts)
+        wide_tree.build(raycasting_tree);
+
     std::vector<float> result(samples.positions.size());
     tbb::parallel_for(tbb::blocked_range<size_t>(0, result.size()),
             [&triangles, &precomputed_sample_directions, model_contains_negative_parts, negative_volumes_start_index,
-                    &raycasting_tree, &result, &samples, deactivate](tbb::blocked_range<size_t> r) {
+                    &raycasting_tree, &wide_tree, &result, &samples, deactivate](tbb::blocked_range<size_t> r) {
                 // Maintaining hits memory outside of the loop, so it does not have to be reallocated for each query.
                 std::vector<igl::Hit> hits;
+                std::vector<Vec3d> ray_origins;
+                std::vector<Vec3d> ray_dirs;
                 for (size_t s_idx = r.begin(); s_idx < r.end(); ++s_idx) {
                     result[s_idx] = 1.0f;
                     if (deactivate) {
@@ -179,49 +188,56 @@ std::vector<float> raycast_visibility(const AABBTreeIndirect::Tree<3, float> &ra
                     Frame f;
                     f.set_from_z(normal);
 
-                    for (const auto &dir : precomputed_sample_directions) {
-                        Vec3f final_ray_dir = (f.to_world(dir));
-                        if (!model_contains_negative_parts) {
-                            igl::Hit hitpoint;
-                            // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
-                            // direction.
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            bool hit = AABBTreeIndirect::intersect_ray_first_hit(triangles.vertices,
-                                    triangles.indices, raycasting_tree, ray_origin_d, final_ray_dir_d, hitpoint);
-                            if (hit && its_face_normal(triangles, hitpoint.id).dot(final_ray_dir) <= 0) {
+                    if (!model_contains_negative_parts) {
+                        // FIXME: This AABBTTreeIndirect query will not compile for float ray origin and
+                        // direction.
+                        ray_origins.assign(precomputed_sample_directions.size(),
+                                (center + normal * 0.01f).cast<double>()); // start above surface.
+                        ray_dirs.clear();
+                        for (const auto &dir : precomputed_sample_directions)
+                            ray_dirs.emplace_back(f.to_world(dir).cast<double>());
+                        AABBTreeIndirect::intersect_rays_first_hit(triangles.vertices, triangles.indices, wide_tree,
+                                ray_origins, ray_dirs, hits);
+                        for (size_t ray_idx = 0; ray_idx < hits.size(); ++ray_idx) {
+                            if (hits[ray_idx].id != -1 &&
+                                    its_face_normal(triangles, hits[ray_idx].id).dot(ray_dirs[ray_idx].cast<float>()) <= 0) {
                                 result[s_idx] -= decrease_step;
                             }
-                        } else { //TODO improve logic for order based boolean operations - consider order of volumes
-                            bool casting_from_negative_volume = samples.triangle_indices[s_idx]
-                                    >= negative_volumes_start_index;
-
-                            Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
-                            if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
-                                final_ray_dir = -1.0 * final_ray_dir;
-                                ray_origin_d = (center - normal * 0.01f).cast<double>();
-                            }
-                            Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
-                            bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
-                                    triangles.indices, raycasting_tree,
-                                    ray_origin_d, final_ray_dir_d, hits);
-                            if (some_hit) {
-                                int counter = 0;
-                                // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
-                                //  It cannot be inside model, and it cannot be inside negative volume
-                                for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
-                                    Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
-                                    if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
-                                        counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
-                                        // which in reverse hit analysis means, that we are entering negative space :) and vice versa
-                                    } else {
-                                        counter += sgn(face_normal.dot(final_ray_dir));
-                                    }
-                                }
-                                if (counter == 0) {
-                                    result[s_idx] -= decrease_step;
+                        }
+                        continue;
+                    }
+
+                    for (const auto &dir : precomputed_sample_directions) {
+                        Vec3f final_ray_dir = (f.to_world(dir));
+                        //TODO improve logic for order based boolean operations - consider order of volumes
+                        bool casting_from_negative_volume = samples.triangle_indices[s_idx]
+                                >= negative_volumes_start_index;
+
+                        Vec3d ray_origin_d = (center + normal * 0.01f).cast<double>(); // start above surface.
+                        if (casting_from_negative_volume) { // if casting from negative volume face, invert direction, change start pos
+                            final_ray_dir = -1.0 * final_ray_dir;
+                            ray_origin_d = (center - normal * 0.01f).cast<double>();
+                        }
+                        Vec3d final_ray_dir_d = final_ray_dir.cast<double>();
+                        bool some_hit = AABBTreeIndirect::intersect_ray_all_hits(triangles.vertices,
+                                triangles.indices, raycasting_tree,
+                                ray_origin_d, final_ray_dir_d, hits);
+                        if (some_hit) {
+                            int counter = 0;
+                            // NOTE: iterating in reverse, from the last hit for one simple reason: We know the state of the ray at that point;
+                            //  It cannot be inside model, and it cannot be inside negative volume
+                            for (int hit_index = int(hits.size()) - 1; hit_index >= 0; --hit_index) {
+                                Vec3f face_normal = its_face_normal(triangles, hits[hit_index].id);
+                                if (hits[hit_index].id >= int(negative_volumes_start_index)) { //negative volume hit
+                                    counter -= sgn(face_normal.dot(final_ray_dir)); // if volume face aligns with ray dir, we are leaving negative space
+                                    // which in reverse hit analysis means, that we are entering negative space :) and vice versa
+                                } else {
+                                    counter += sgn(face_normal.dot(final_ray_dir));
                                 }
                             }
+                            if (counter == 0) {
+                                result[s_idx] -= decrease_step;
+                            }
                         }
                     }
                 }
@@ -1250,7 +1266,7 @@ void pick_random_seam_point(const std::vector<SeamCandidate> &perimeter_points,
 // Store results in the SeamPlacer variables m_seam_per_object
 void SeamPlacer::gather_seam_candidates(const PrintObject *po, const SeamPlacerImpl::GlobalModelInfo &global_model_info, SeamPosition configured_seam_preference) {
     using namespace SeamPlacerImpl;
-    PrintObjectSeamData &seam_data = m_seam_per_object.emplace(po, PrintObjectSeamData { }).first->second;
+    PrintObjectSeamData &seam_data = *m_seam_per_object.emplace(po, std::make_shared<PrintObjectSeamData>()).first->second;
     seam_data.layers.resize(po->layer_count());
     
     // use an antomic idx instead of the range, to avoid a thread being very late because it's on the difficult layers.
@@ -1283,7 +1299,7 @@ void SeamPlacer::calculate_candidates_visibility(const PrintObject *po,
         const SeamPlacerImpl::GlobalModelInfo &global_model_info) {
     using namespace SeamPlacerImpl;
 
-    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
             [&layers, &global_model_info](tbb::blocked_range<size_t> r) {
                 for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
@@ -1299,7 +1315,7 @@ void SeamPlacer::calculate_overhangs_and_layer_embedding(const PrintObject *po)
     using namespace SeamPlacerImpl;
     using PerimeterDistancer = AABBTreeLines::LinesDistancer<Linef>;
 
-    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
             [po, &layers](tbb::blocked_range<size_t> r) {
                 std::unique_ptr<PerimeterDistancer> prev_layer_distancer;
@@ -1424,7 +1440,7 @@ std::optional<std::pair<size_t, size_t>> SeamPlacer::find_next_seam_in_layer(
 // get the nearests points from layers above & below. stop when the seam_align_tolerable_dist_factor don't allow to jump to a point, 
 std::vector<std::pair<size_t, size_t>> SeamPlacer::find_seam_string(const PrintObject *po,
         std::pair<size_t, size_t> start_seam, const SeamPlacerImpl::SeamComparator &comparator) const {
-    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object.find(po)->second.layers;
+    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object.find(po)->second->layers;
     int layer_idx = start_seam.first;
 
     //initialize searching for seam string - cluster of nearby seams on previous and next layers
@@ -1508,7 +1524,7 @@ void SeamPlacer::align_seam_points(const PrintObject *po, const SeamPlacerImpl::
 #endif
 
     //gather vector of all seams on the print_object - pair of layer_index and seam__index within that layer
-    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+    const std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
     std::vector<std::pair<size_t, size_t>> seams;
     for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx) {
         const std::vector<SeamCandidate> &layer_perimeter_points = layers[layer_idx].points;
@@ -1769,6 +1785,11 @@ void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_can
                          {std::to_string(obj_idx + 1), std::to_string(print.objects().size())},
                          PrintBase::SlicingStatus::SECONDARY_STATE);
         throw_if_canceled_func();
+        if (po->seam_data()) {
+            // Nothing the seams depend on changed since the last export.
+            m_seam_per_object.emplace(po, po->seam_data());
+            continue;
+        }
         SeamPosition configured_seam_preference = po->config().seam_position.value;
         SeamComparator comparator { configured_seam_preference, *po };
 
@@ -1807,7 +1828,7 @@ void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_can
             BOOST_LOG_TRIVIAL(debug)
             << "SeamPlacer: pick_seam_point : start";
             //pick seam point
-            std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po].layers;
+            std::vector<PrintObjectSeamData::LayerSeams> &layers = m_seam_per_object[po]->layers;
             tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()),
                     [&layers, configured_seam_preference, comparator, po](tbb::blocked_range<size_t> r) {
                         for (size_t layer_idx = r.begin(); layer_idx < r.end(); ++layer_idx) {
@@ -1833,8 +1854,9 @@ void SeamPlacer::init(const Print &print, std::function<void(void)> throw_if_can
         }
 
 #ifdef DEBUG_FILES
-        debug_export_points(m_seam_per_object[po].layers, po->bounding_box(), comparator);
+        debug_export_points(m_seam_per_object[po]->layers, po->bounding_box(), comparator);
 #endif
+        po->set_seam_data(m_seam_per_object[po]);
     }
 }
 
@@ -2041,7 +2063,7 @@ Point SeamPlacer::place_seam(const Layer *layer, const ExtrusionLoop &loop, cons
     };
 
     const PrintObjectSeamData::LayerSeams &layer_perimeters =
-            m_seam_per_object.find(layer->object())->second.layers[layer_index];
+            m_seam_per_object.find(layer->object())->second->layers[layer_index];
 
     // Find the closest perimeter in the SeamPlacer to this loop.
     // Repeat search until two consecutive points of the loop are found, that result in the same closest_perimeter
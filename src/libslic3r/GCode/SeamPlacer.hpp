@@ -179,7 +179,8 @@ public:
     static constexpr size_t seam_align_mm_per_segment = 4.0f;
 
     //The following data structures hold all perimeter points for all PrintObject.
-    std::unordered_map<const PrintObject*, PrintObjectSeamData> m_seam_per_object;
+    // Shared with the PrintObject, which keeps them for the next G-code export, see PrintObject::seam_data().
+    std::unordered_map<const PrintObject*, std::shared_ptr<PrintObjectSeamData>> m_seam_per_object;
 
     // if it's expected, we need to randomized at the external perimeter.
     bool external_perimeters_first = false;
@@ -11,9 +11,17 @@
 #include <iostream>
 #include <iomanip>
 #include "Utils.hpp"
+#include "Thread.hpp"
 
 #include "LocalesUtils.hpp"
 
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_group.h>
+
 #include <fast_float/fast_float.h>
 
 namespace Slic3r {
@@ -39,6 +47,19 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
 }
 
 const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    const char *c = this->tokenize_line_internal(ptr, end, gline, command);
+
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.m_raw << std::endl;
+
+    return c;
+}
+
+const char* GCodeReader::tokenize_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const
 {
     assert(is_decimal_separator_point());
     
@@ -94,9 +115,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
@@ -111,22 +129,25 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
-void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command)
+bool GCodeReader::updates_coordinates(const std::pair<const char*, const char*> &command)
 {
     if (*command.first == 'G') {
         int cmd_len = int(command.second - command.first);
-        if ((cmd_len == 2 && (command.first[1] == '0' || command.first[1] == '1' || command.first[1] == '2' || command.first[1] == '3')) ||
-            (cmd_len == 3 &&  command.first[1] == '9' && command.first[2] == '2')) {
-            for (size_t i = 0; i < NUM_AXES; ++ i)
-                if (gline.has(Axis(i)))
-                    m_position[i] = gline.value(Axis(i));
-        }
+        return (cmd_len == 2 && (command.first[1] == '0' || command.first[1] == '1' || command.first[1] == '2' || command.first[1] == '3')) ||
+               (cmd_len == 3 &&  command.first[1] == '9' && command.first[2] == '2');
+    }
+    return false;
+}
+
+void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    if (updates_coordinates(command)) {
+        for (size_t i = 0; i < NUM_AXES; ++ i)
+            if (gline.has(Axis(i)))
+                m_position[i] = gline.value(Axis(i));
     }
 }
 
@@ -217,6 +238,164 @@ bool GCodeReader::parse_file_raw(const std::string &filename, raw_line_callback_
         [](size_t){});
 }
 
+namespace {
+
+// Lines of a single chunk of a memory mapped G-code file, tokenized by a worker thread.
+struct TokenizedChunk
+{
+    std::vector<GCodeReader::GCodeLine> lines;
+    // Does the line update the reader position (G0, G1, G2, G3, G92)?
+    std::vector<uint8_t>                updates_coordinates;
+    // File position after the line's '\n' or size_t(-1) if the line was not terminated by '\n'.
+    std::vector<size_t>                 line_ends;
+};
+
+using TokenizedBatch = std::vector<TokenizedChunk>;
+
+// Find the beginning of the line following pos.
+static inline const char* next_line_start(const char *pos, const char *end)
+{
+    for (; pos != end && *pos != '\n'; ++ pos);
+    return pos == end ? end : pos + 1;
+}
+
+} // namespace
+
+template<typename LineEndCallback>
+bool GCodeReader::parse_file_parallel_internal(const std::string &filename, callback_t &callback, LineEndCallback line_end_callback)
+{
+    // Tokenizing a batch of chunks produces GCodeLines that take several times the memory of the source text,
+    // thus the file is processed in batches of limited size. Each batch is split into chunks for the worker threads.
+    static constexpr const size_t batch_size = 32 * 1024 * 1024;
+    static constexpr const size_t chunk_size = 512 * 1024;
+
+    boost::system::error_code ec;
+    const uintmax_t file_size = boost::filesystem::file_size(filename, ec);
+    if (ec)
+        return false;
+    m_parsing = true;
+    if (file_size == 0)
+        return true;
+
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(boost::filesystem::path(filename));
+    } catch (const std::exception &) {
+        return false;
+    }
+    if (! file.is_open())
+        return false;
+
+    const char *data     = file.data();
+    const char *data_end = data + file.size();
+
+    auto tokenize_batch = [this, data, data_end](const char *batch_begin, TokenizedBatch &batch) {
+        // Split the batch into chunks at line boundaries.
+        std::vector<const char*> chunk_starts { batch_begin };
+        const char *batch_end = batch_begin;
+        for (size_t i = 0; i < batch_size / chunk_size && batch_end != data_end; ++ i) {
+            batch_end = next_line_start(std::min(batch_end + chunk_size, data_end), data_end);
+            chunk_starts.emplace_back(batch_end);
+        }
+        batch.assign(chunk_starts.size() - 1, TokenizedChunk());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size(), 1), [this, data, data_end, &chunk_starts, &batch](const tbb::blocked_range<size_t> &range) {
+            for (size_t chunk_id = range.begin(); chunk_id < range.end(); ++ chunk_id) {
+                TokenizedChunk &chunk     = batch[chunk_id];
+                const char     *it        = chunk_starts[chunk_id];
+                const char     *chunk_end = chunk_starts[chunk_id + 1];
+                // Estimate of the number of lines, to avoid excessive reallocation.
+                chunk.lines.reserve((chunk_end - it) / 24);
+                std::pair<const char*, const char*> cmd;
+                std::string                         last_line;
+                while (it != chunk_end) {
+                    // Find end of line, the same way parse_file_raw() does.
+                    const char *it_end = it;
+                    for (; it_end != chunk_end && *it_end != '\r' && *it_end != '\n'; ++ it_end);
+                    chunk.lines.emplace_back();
+                    if (it_end == data_end) {
+                        // The last line of the file is not terminated. Copy it into a zero terminated string, so that the tokenizer
+                        // does not read past the memory mapped region.
+                        last_line.assign(it, it_end);
+                        this->tokenize_line_internal(last_line.c_str(), last_line.c_str() + last_line.size(), chunk.lines.back(), cmd);
+                    } else
+                        this->tokenize_line_internal(it, it_end, chunk.lines.back(), cmd);
+                    chunk.updates_coordinates.emplace_back(updates_coordinates(cmd));
+                    // Skip EOL.
+                    it = it_end;
+                    if (it != chunk_end && *it == '\r')
+                        ++ it;
+                    if (it != chunk_end && *it == '\n') {
+                        ++ it;
+                        chunk.line_ends.emplace_back(it - data);
+                    } else
+                        chunk.line_ends.emplace_back(size_t(-1));
+                }
+            }
+        });
+        return batch_end;
+    };
+
+    // It registers a handler that sets locales to "C" before any TBB thread starts participating in tokenization.
+    TBBLocalesSetter locales_setter;
+
+    TokenizedBatch   batch;
+    TokenizedBatch   next_batch;
+    const char      *next_batch_begin = tokenize_batch(data, batch);
+    tbb::task_group  background;
+    try {
+        for (;;) {
+            // Tokenize the next batch in the background while the callbacks are being executed on this batch.
+            const bool has_next_batch = next_batch_begin != data_end;
+            if (has_next_batch)
+                background.run([&tokenize_batch, &next_batch_begin, &next_batch]() { next_batch_begin = tokenize_batch(next_batch_begin, next_batch); });
+            for (TokenizedChunk &chunk : batch) {
+                for (size_t i = 0; i < chunk.lines.size(); ++ i) {
+                    GCodeLine &gline = chunk.lines[i];
+                    if (gline.has(E) && m_config.use_relative_e_distances)
+                        m_position[E] = 0;
+                    if (m_verbose)
+                        std::cout << gline.m_raw << std::endl;
+                    callback(*this, gline);
+                    if (chunk.updates_coordinates[i])
+                        for (size_t axis = 0; axis < NUM_AXES; ++ axis)
+                            if (gline.has(Axis(axis)))
+                                m_position[axis] = gline.value(Axis(axis));
+                    if (! m_parsing) {
+                        // The callback wishes to exit.
+                        background.wait();
+                        return true;
+                    }
+                    if (chunk.line_ends[i] != size_t(-1))
+                        line_end_callback(chunk.line_ends[i]);
+                }
+                // Release the memory of the processed chunk early.
+                chunk = TokenizedChunk();
+            }
+            background.wait();
+            if (! has_next_batch)
+                break;
+            std::swap(batch, next_batch);
+        }
+    } catch (...) {
+        // The callback may throw (for example on cancellation). Don't leave the background task running on the stack variables.
+        background.wait();
+        throw;
+    }
+    return true;
+}
+
+bool GCodeReader::parse_file_parallel(const std::string &file, callback_t callback)
+{
+    return this->parse_file_parallel_internal(file, callback, [](size_t){});
+}
+
+bool GCodeReader::parse_file_parallel(const std::string &file, callback_t callback, std::vector<std::vector<size_t>> &lines_ends)
+{
+    lines_ends.clear();
+    lines_ends.push_back(std::vector<size_t>());
+    return this->parse_file_parallel_internal(file, callback, [&lines_ends](size_t file_pos) { lines_ends.front().emplace_back(file_pos); });
+}
+
 const char* GCodeReader::axis_pos(const char *raw_str, char axis)
 {
     const char *c = raw_str;
@@ -159,6 +159,12 @@ public:
     bool parse_file(const std::string& file, callback_t callback, std::vector<std::vector<size_t>>& lines_ends);
     // Just read the G-code file line by line, calls callback (const char *begin, const char *end). Returns false if reading the file failed.
     bool parse_file_raw(const std::string &file, raw_line_callback_t callback);
+    // Same as parse_file(), but the file is memory mapped and split into chunks at line boundaries, which are tokenized into GCodeLines
+    // by worker threads. The callback is called serially on the tokenized lines in the order of the file, while the next batch of chunks
+    // is being tokenized in the background. The sequence of callbacks, the reader state seen by the callbacks and lines_ends
+    // are the same as with parse_file().
+    bool parse_file_parallel(const std::string &file, callback_t callback);
+    bool parse_file_parallel(const std::string &file, callback_t callback, std::vector<std::vector<size_t>> &lines_ends);
 
     // To be called by the callback to stop parsing.
     void quit_parsing() { m_parsing = false; }
@@ -186,8 +192,15 @@ private:
     template<typename ParseLineCallback, typename LineEndCallback>
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
+    template<typename LineEndCallback>
+    bool        parse_file_parallel_internal(const std::string &filename, callback_t &callback, LineEndCallback line_end_callback);
+
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Side effect free part of parse_line_internal(), which may be called from worker threads.
+    const char* tokenize_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const;
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Does the command (G0, G1, G2, G3, G92) update the reader position?
+    static bool updates_coordinates(const std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
     static bool         is_end_of_line(char c)          { return c == '\r' || c == '\n' || c == 0; }
@@ -189,6 +189,29 @@ Layer::~Layer()
     m_regions.clear();
 }
 
+void Layer::release_geometry()
+{
+    std::vector<LayerSliceIslandPtr>().swap(m_islands);
+    ExPolygons().swap(m_lslices);
+    CurledLines().swap(this->curled_lines);
+    for (LayerRegion *region : m_regions)
+        region->release_geometry();
+}
+
+void Layer::release_infill_data()
+{
+    for (LayerSliceIslandPtr &island : m_islands)
+        ExPolygons().swap(island->m_fill_no_overlap_expolygons);
+    for (LayerRegion *region : m_regions)
+        region->release_infill_data();
+}
+
+void Layer::release_support_data()
+{
+    for (LayerRegion *region : m_regions)
+        Polylines().swap(region->m_unsupported_bridge_edges);
+}
+
 coord_t Layer::scale_to_layer_coord(double z) {
     assert(z < 10000);
     assert(z >= 0);
@@ -1007,6 +1030,42 @@ void Layer::make_perimeters() {
 
 }
 
+void Layer::copy_perimeters(const Layer &source)
+{
+    BOOST_LOG_TRIVIAL(trace) << "Copying perimeters of layer " << source.id() << " to layer " << this->id();
+    assert(m_islands.size() == source.m_islands.size() && m_regions.size() == source.m_regions.size());
+
+    // LayerRegion of this layer at the index of a LayerRegion of the source layer.
+    auto region_of = [this, &source](const LayerRegion *source_region) -> const LayerRegion* {
+        auto it = std::find(source.m_regions.begin(), source.m_regions.end(), source_region);
+        assert(it != source.m_regions.end());
+        return m_regions[it - source.m_regions.begin()];
+    };
+    for (size_t island_idx = 0; island_idx < m_islands.size(); ++ island_idx) {
+        LayerSliceIsland       &island        = *m_islands[island_idx];
+        const LayerSliceIsland &source_island = *source.m_islands[island_idx];
+        island.regions_islands().clear();
+        for (const LayerRegionIslandPtr &source_region_island : source_island.regions_islands()) {
+            LayerRegionSetConstPtrs regions;
+            for (const LayerRegion *source_region : source_region_island->regions())
+                regions.insert(region_of(source_region));
+            LayerRegionIsland &region_island  = island.add_new_region_island(regions, source_region_island->extruder_id());
+            // Deep copy of the extrusions.
+            region_island.m_extrusion_regions = source_region_island->m_extrusion_regions;
+            region_island.can_be_used_to_wipe = source_region_island->can_be_used_to_wipe;
+        }
+        island.m_fill_expolygons            = source_island.m_fill_expolygons;
+        island.m_fill_expolygons_bboxes     = source_island.m_fill_expolygons_bboxes;
+        island.m_fill_no_overlap_expolygons = source_island.m_fill_no_overlap_expolygons;
+        island.m_perimeter_slices           = source_island.m_perimeter_slices;
+        island.m_wave_overhang_filled_area  = source_island.m_wave_overhang_filled_area;
+    }
+    for (size_t region_idx = 0; region_idx < m_regions.size(); ++ region_idx) {
+        m_regions[region_idx]->m_fill_surfaces              = source.m_regions[region_idx]->m_fill_surfaces;
+        m_regions[region_idx]->m_fill_no_overlap_expolygons = source.m_regions[region_idx]->m_fill_no_overlap_expolygons;
+    }
+}
+
 void LayerSliceIsland::make_perimeters(LayerRegionIsland &region_island) {
 
     const PrintConfig       &print_config  = this->m_layer->object()->print()->config();
@@ -99,6 +99,11 @@ public:
     // Trim surfaces by trimming polygons (shrunk by an elephant foot compensation step), but don't shrink narrow parts so much that no perimeter would fit.
     void    elephant_foot_compensation_step(const float elephant_foot_compensation_perimeter_step, const Polygons &trimming_polygons);
 
+    // Low memory mode: free the slices and surfaces once the layer was exported to G-code.
+    void    release_geometry();
+    // Low memory mode: free the data only needed by the infill generation, once all the layers were filled.
+    void    release_infill_data();
+
     void    export_region_slices_to_svg(const char *path) const;
     void    export_region_fill_surfaces_to_svg(const char *path) const;
     // Export to "out/LayerRegion-name-%d.svg" with an increasing index with every export.
@@ -225,6 +230,7 @@ using LayerRegionIslandPtr = std::unique_ptr<LayerRegionIsland>;
 // kind of similar as old's LayerSlice
 class LayerSliceIsland
 {
+    friend class Layer;
 public:
     // only filled when Layer's LayerSliceIsland are locked.
     // used by supportspotgenerator (badly)
@@ -373,6 +379,9 @@ public:
     // Slices merged into islands, to be used by the elephant foot compensation to trim the individual surfaces with the shrunk merged slices.
     ExPolygons              merged(coordf_t offset_scaled = 0) const;
     void                    make_perimeters();
+    // Copy the perimeters, gap fills and fill areas generated by make_perimeters() for a source layer with the same slices,
+    // regions and layer height, sandwiched between the same slices. See PrintObject::make_perimeters().
+    void                    copy_perimeters(const Layer &source);
     void                    make_milling_post_process();
     void                    make_fills(FillAdaptive::Octree     *adaptive_fill_octree,
                                        FillAdaptive::Octree     *support_fill_octree,
@@ -405,6 +414,14 @@ public:
     // Is there any valid extrusion assigned to any island-region?
     bool            has_extrusions() const;
 
+    // Low memory mode: free the slices, the islands and their extrusions once the layer was exported to G-code.
+    // The layer stays in its PrintObject, but all the steps of the PrintObject have to be invalidated afterwards.
+    void            release_geometry();
+    // Low memory mode: free the data only needed by the infill generation, once all the layers were filled.
+    void            release_infill_data();
+    // Low memory mode: free the data only needed by the support generation, once the support was generated.
+    void            release_support_data();
+
     void simplify_extrusion_path() {
         for (LayerSliceIslandPtr &island_ptr : m_islands)
             for (LayerRegionIslandPtr &regisland : island_ptr->regions_islands())
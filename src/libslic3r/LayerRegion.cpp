@@ -31,6 +31,25 @@ void LayerRegion::clear() {
     this->m_fill_surfaces.clear();
 }
 
+void LayerRegion::release_geometry()
+{
+    ExPolygons().swap(m_raw_slices);
+    Surfaces().swap(m_slices.surfaces);
+    ExPolygons().swap(m_fill_no_overlap_expolygons);
+    Surfaces().swap(m_fill_surfaces.surfaces);
+    Polylines().swap(m_unsupported_bridge_edges);
+    ExPolygons().swap(m_cache_fill_expolygons);
+    m_cache_fill_expolygons_computed = 0;
+}
+
+void LayerRegion::release_infill_data()
+{
+    ExPolygons().swap(m_fill_no_overlap_expolygons);
+    // Only a cache, it is computed again on demand.
+    ExPolygons().swap(m_cache_fill_expolygons);
+    m_cache_fill_expolygons_computed = 0;
+}
+
 Flow LayerRegion::flow(FlowRole role) const
 {
     return this->flow(role, (float)m_layer->unscaled_height());
@@ -2360,6 +2360,50 @@ bool model_mmu_segmentation_data_changed(const ModelObject& mo, const ModelObjec
         [](const ModelVolume &mv_old, const ModelVolume &mv_new){ return mv_old.mm_segmentation_facets.timestamp_matches(mv_new.mm_segmentation_facets); });
 }
 
+static bool facets_annotations_equal(const FacetsAnnotation &fa1, const FacetsAnnotation &fa2)
+{
+    return fa1.timestamp_matches(fa2) || fa1.get_data() == fa2.get_data();
+}
+
+static bool model_configs_equal(const ModelConfig &config1, const ModelConfig &config2)
+{
+    return config1.timestamp() == config2.timestamp() || config1.get() == config2.get();
+}
+
+bool model_objects_print_equal(const ModelObject &mo1, const ModelObject &mo2)
+{
+    if (mo1.volumes.size() != mo2.volumes.size() || mo1.origin_translation != mo2.origin_translation ||
+        ! model_configs_equal(mo1.config, mo2.config) ||
+        mo1.layer_height_profile.get() != mo2.layer_height_profile.get() ||
+        mo1.layer_config_ranges.size() != mo2.layer_config_ranges.size())
+        return false;
+    for (auto it1 = mo1.layer_config_ranges.begin(), it2 = mo2.layer_config_ranges.begin(); it1 != mo1.layer_config_ranges.end(); ++ it1, ++ it2)
+        if (it1->first != it2->first || ! model_configs_equal(it1->second, it2->second))
+            return false;
+    for (size_t i = 0; i < mo1.volumes.size(); ++ i) {
+        const ModelVolume &mv1 = *mo1.volumes[i];
+        const ModelVolume &mv2 = *mo2.volumes[i];
+        if (mv1.type() != mv2.type() || mv1.get_matrix().matrix() != mv2.get_matrix().matrix() ||
+            ! model_configs_equal(mv1.config, mv2.config) ||
+            ! facets_annotations_equal(mv1.supported_facets, mv2.supported_facets) ||
+            ! facets_annotations_equal(mv1.seam_facets, mv2.seam_facets) ||
+            ! facets_annotations_equal(mv1.mm_segmentation_facets, mv2.mm_segmentation_facets))
+            return false;
+        // Copy / pasted volumes share their mesh, otherwise compare the content: The cheap statistics first,
+        // then the cached hashes, thus the full comparison only runs for meshes with equal hashes.
+        if (mv1.get_mesh_shared_ptr() != mv2.get_mesh_shared_ptr()) {
+            const TriangleMesh &mesh1 = mv1.mesh();
+            const TriangleMesh &mesh2 = mv2.mesh();
+            if (mesh1.facets_count() != mesh2.facets_count() || mesh1.its.vertices.size() != mesh2.its.vertices.size() ||
+                mesh1.stats().min != mesh2.stats().min || mesh1.stats().max != mesh2.stats().max ||
+                mesh1.content_hash() != mesh2.content_hash() ||
+                mesh1.its.indices != mesh2.its.indices || mesh1.its.vertices != mesh2.its.vertices)
+                return false;
+        }
+    }
+    return true;
+}
+
 bool model_has_parameter_modifiers_in_objects(const Model &model)
 {
     for (const auto& model_object : model.objects)
@@ -1429,6 +1429,11 @@ bool model_custom_seam_data_changed(const ModelObject& mo, const ModelObject& mo
 // The function assumes that volumes list is synchronized.
 extern bool model_mmu_segmentation_data_changed(const ModelObject& mo, const ModelObject& mo_new);
 
+// Test whether the two ModelObjects would be sliced the same, thus they may share their PrintObjects:
+// The same volumes with the same meshes, transformations, configs and painted data, the same object config,
+// layer ranges, layer height profile and origin translation. Instances and names are not compared.
+bool model_objects_print_equal(const ModelObject &mo1, const ModelObject &mo2);
+
 // If the model has object(s) which contains a modofoer, then it is currently not supported by the SLA mode.
 // Either the model cannot be loaded, or a SLA printer has to be activated.
 bool model_has_parameter_modifiers_in_objects(const Model& model);
@@ -18,6 +18,7 @@
 #include <unordered_set>
 
 #include <boost/log/trivial.hpp>
+#include <boost/functional/hash.hpp>
 #include <oneapi/tbb/parallel_for.h>
 #include <mutex>
 #include <boost/thread/lock_guard.hpp>
@@ -1237,7 +1238,89 @@ static bool has_layer_only_one_color(const std::vector<ColoredLines> &colored_po
     return true;
 }
 
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+static size_t mm_segmentation_params_hash(const PrintObject &print_object, const coordf_t resolution, const size_t num_extruders)
+{
+    size_t seed = 0;
+    const Transform3d &trafo = print_object.trafo();
+    for (int i = 0; i < 16; ++i)
+        boost::hash_combine(seed, trafo.data()[i]);
+    boost::hash_combine(seed, print_object.center_offset().x());
+    boost::hash_combine(seed, print_object.center_offset().y());
+    boost::hash_combine(seed, resolution);
+    boost::hash_combine(seed, num_extruders);
+    return seed;
+}
+
+static size_t mm_segmentation_layer_input_hash(const double slice_z, const ExPolygons &input_expolygons, const BoundingBox &edge_grid_bbox)
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, slice_z);
+    for (const Point &pt : { edge_grid_bbox.min, edge_grid_bbox.max }) {
+        boost::hash_combine(seed, pt.x());
+        boost::hash_combine(seed, pt.y());
+    }
+    for (const ExPolygon &expolygon : input_expolygons)
+        for (const Polygon &polygon : to_polygons(expolygon)) {
+            boost::hash_combine(seed, polygon.size());
+            for (const Point &pt : polygon.points) {
+                boost::hash_combine(seed, pt.x());
+                boost::hash_combine(seed, pt.y());
+            }
+        }
+    return seed;
+}
+
+// Painted triangles of all extruders sorted by their hash, to be compared with the painted triangles of the previous run.
+static std::vector<MMSegmentationCache::PaintedFacet> mm_segmentation_painted_facets(const std::vector<std::vector<std::array<Vec3f, 3>>> &painted_facets)
+{
+    std::vector<MMSegmentationCache::PaintedFacet> out;
+    for (size_t extruder_idx = 0; extruder_idx < painted_facets.size(); ++extruder_idx)
+        for (const std::array<Vec3f, 3> &facet : painted_facets[extruder_idx]) {
+            size_t seed = extruder_idx;
+            for (const Vec3f &pt : facet)
+                for (int i = 0; i < 3; ++i)
+                    boost::hash_combine(seed, pt[i]);
+            // Vertices are sorted by z-axis.
+            out.push_back({ seed, facet[0].z(), facet[2].z() });
+        }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+// Returns the cached segmentation for each layer that could be reused, nullptr for layers that have to be segmented.
+// A layer could be reused if its input polygons did not change and if no added or removed painted triangle intersects it.
+static std::vector<const MMSegmentationCache::LayerSegmentation*> mm_segmentation_reusable_layers(const MMSegmentationCache::Data &cached,
+                                                                                                  const MMSegmentationCache::Data &current,
+                                                                                                  const SpanOfConstPtrs<Layer>     &layers,
+                                                                                                  const std::vector<size_t>        &input_hashes)
+{
+    std::vector<const MMSegmentationCache::LayerSegmentation*> out(layers.size(), nullptr);
+    if (cached.layers.empty() || cached.params_hash != current.params_hash)
+        return out;
+
+    std::vector<MMSegmentationCache::PaintedFacet> changed;
+    std::set_symmetric_difference(cached.painted_facets.begin(), cached.painted_facets.end(), current.painted_facets.begin(), current.painted_facets.end(), std::back_inserter(changed));
+
+    // Layers intersected by the changed triangles, using the same tolerance as the projection of painted triangles.
+    std::vector<char> layer_changed(layers.size(), false);
+    for (const MMSegmentationCache::PaintedFacet &facet : changed) {
+        auto first_layer = std::upper_bound(layers.begin(), layers.end(), float(facet.min_z - EPSILON), [](float z, const Layer *l1) { return z < l1->slice_z; });
+        auto last_layer  = std::upper_bound(layers.begin(), layers.end(), float(facet.max_z + EPSILON), [](float z, const Layer *l1) { return z < l1->slice_z; });
+        for (auto layer_it = first_layer; layer_it < last_layer; ++layer_it)
+            layer_changed[layer_it - layers.begin()] = true;
+    }
+
+    for (size_t layer_idx = 0; layer_idx < layers.size(); ++layer_idx)
+        if (!layer_changed[layer_idx]) {
+            const double slice_z = layers[layer_idx]->slice_z;
+            auto it = lower_bound_by_predicate(cached.layers.begin(), cached.layers.end(), [slice_z](const MMSegmentationCache::LayerSegmentation &l) { return l.slice_z < slice_z; });
+            if (it != cached.layers.end() && it->slice_z == slice_z && it->input_hash == input_hashes[layer_idx])
+                out[layer_idx] = &(*it);
+        }
+    return out;
+}
+
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback, MMSegmentationCache *cache)
 {
     const size_t                          num_extruders = print_object.print()->config().nozzle_diameter.size();
     const size_t                          num_layers    = print_object.layers().size();
@@ -1295,9 +1378,10 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
         layer_bboxes[layer_idx].merge(get_extents(input_expolygons[layer_idx]));
     }
 
+    std::vector<BoundingBox> edge_grid_bboxes(num_layers);
     for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
-        throw_on_cancel_callback();
-        BoundingBox bbox = layer_bboxes[layer_idx];
+        BoundingBox &bbox = edge_grid_bboxes[layer_idx];
+        bbox = layer_bboxes[layer_idx];
         // Projected triangles could, in rare cases (as in GH issue #7299), belongs to polygons printed in the previous or the next layer.
         // Let's merge the bounding box of the current layer with bounding boxes of the previous and the next layer to ensure that
         // every projected triangle will be inside the resulting bounding box.
@@ -1305,104 +1389,137 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
         if (layer_idx < num_layers - 1) bbox.merge(layer_bboxes[layer_idx + 1]);
         // Projected triangles may slightly exceed the input polygons.
         bbox.offset(20 * SCALED_EPSILON);
-        edge_grids[layer_idx].set_bbox(bbox);
-        edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
     }
 
-    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - projection of painted triangles - begin";
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - collecting painted triangles - begin";
+    // Painted triangles transformed into the coordinate system of the PrintObject, indexed by the extruder ID.
+    // Vertices of each triangle are sorted by z-axis for simplification of projected_facet on slices.
+    std::vector<std::vector<std::array<Vec3f, 3>>> painted_facets(num_extruders + 1);
     for (const ModelVolume *mv : print_object.model_object()->volumes) {
+        if (!mv->is_model_part())
+            continue;
         //can reuse the TriangleSelector for each extruder_idx
         TriangleSelector tri_selector(mv->mesh());
         mv->mm_segmentation_facets.set_facets_selector(tri_selector);
-        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&mv, &print_object, &layers, &edge_grids, &painted_lines, &painted_lines_mutex, &input_expolygons, &resolution, &tri_selector , &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        const Transform3f tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
+        tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&tri_selector, &tr, &painted_facets, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
             for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++extruder_idx) {
                 throw_on_cancel_callback();
                 const indexed_triangle_set custom_facets = tri_selector.get_facets(EnforcerBlockerType(extruder_idx));
-                if (!mv->is_model_part() || custom_facets.indices.empty())
-                    continue;
-
-                const Transform3f tr = print_object.trafo().cast<float>() * mv->get_matrix().cast<float>();
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, custom_facets.indices.size()), [&tr, &custom_facets, &print_object, &layers, &edge_grids, &input_expolygons, &painted_lines, &painted_lines_mutex, &extruder_idx, &resolution](const tbb::blocked_range<size_t> &range) {
-                    for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
-                        float min_z = std::numeric_limits<float>::max();
-                        float max_z = std::numeric_limits<float>::lowest();
-
-                        std::array<Vec3f, 3> facet;
-                        for (int p_idx = 0; p_idx < 3; ++p_idx) {
-                            facet[p_idx] = tr * custom_facets.vertices[custom_facets.indices[facet_idx](p_idx)];
-                            max_z        = std::max(max_z, facet[p_idx].z());
-                            min_z        = std::min(min_z, facet[p_idx].z());
-                        }
+                std::vector<std::array<Vec3f, 3>> &facets = painted_facets[extruder_idx];
+                facets.reserve(facets.size() + custom_facets.indices.size());
+                for (const stl_triangle_vertex_indices &indices : custom_facets.indices) {
+                    std::array<Vec3f, 3> &facet = facets.emplace_back();
+                    for (int p_idx = 0; p_idx < 3; ++p_idx)
+                        facet[p_idx] = tr * custom_facets.vertices[indices(p_idx)];
+                    std::sort(facet.begin(), facet.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
+                }
+            }
+        }); // end of parallel_for
+    }
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - collecting painted triangles - end";
+
+    // Find the layers not affected by a painting change since the last run, which may reuse the cached segmentation.
+    MMSegmentationCache::Data cached;
+    if (cache)
+        cached = cache->take();
+    MMSegmentationCache::Data current;
+    current.params_hash = mm_segmentation_params_hash(print_object, resolution, num_extruders);
+    current.painted_facets = mm_segmentation_painted_facets(painted_facets);
+    std::vector<size_t> input_hashes(num_layers);
+    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+        input_hashes[layer_idx] = mm_segmentation_layer_input_hash(layers[layer_idx]->slice_z, input_expolygons[layer_idx], edge_grid_bboxes[layer_idx]);
+    std::vector<const MMSegmentationCache::LayerSegmentation*> reused_layers = mm_segmentation_reusable_layers(cached, current, layers, input_hashes);
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - reused layers count: "
+                             << std::count_if(reused_layers.begin(), reused_layers.end(), [](const auto *l) { return l != nullptr; });
+    throw_on_cancel_callback();
 
-                        // Sort the vertices by z-axis for simplification of projected_facet on slices
-                        std::sort(facet.begin(), facet.end(), [](const Vec3f &p1, const Vec3f &p2) { return p1.z() < p2.z(); });
+    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
+        throw_on_cancel_callback();
+        if (reused_layers[layer_idx] == nullptr) {
+            edge_grids[layer_idx].set_bbox(edge_grid_bboxes[layer_idx]);
+            edge_grids[layer_idx].create(input_expolygons[layer_idx], coord_t(scale_(10.)));
+        }
+    }
 
-                        // Find lowest slice not below the triangle.
-                        auto first_layer = std::upper_bound(layers.begin(), layers.end(), float(min_z - EPSILON),
-                                                            [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        auto last_layer  = std::upper_bound(layers.begin(), layers.end(), float(max_z + EPSILON),
-                                                           [](float z, const Layer *l1) { return z < l1->slice_z; });
-                        --last_layer;
+    BOOST_LOG_TRIVIAL(debug) << "MM segmentation - projection of painted triangles - begin";
+    tbb::parallel_for(tbb::blocked_range<size_t>(1, num_extruders + 1), [&print_object, &layers, &edge_grids, &painted_facets, &painted_lines, &painted_lines_mutex, &input_expolygons, &reused_layers, &resolution, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t extruder_idx = range.begin(); extruder_idx < range.end(); ++extruder_idx) {
+            throw_on_cancel_callback();
+            const std::vector<std::array<Vec3f, 3>> &facets = painted_facets[extruder_idx];
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, facets.size()), [&facets, &print_object, &layers, &edge_grids, &input_expolygons, &reused_layers, &painted_lines, &painted_lines_mutex, &extruder_idx, &resolution](const tbb::blocked_range<size_t> &range) {
+                for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++facet_idx) {
+                    const std::array<Vec3f, 3> &facet = facets[facet_idx];
+                    const float                 min_z = facet[0].z();
+                    const float                 max_z = facet[2].z();
+
+                    // Find lowest slice not below the triangle.
+                    auto first_layer = std::upper_bound(layers.begin(), layers.end(), float(min_z - EPSILON),
+                                                        [](float z, const Layer *l1) { return z < l1->slice_z; });
+                    auto last_layer  = std::upper_bound(layers.begin(), layers.end(), float(max_z + EPSILON),
+                                                       [](float z, const Layer *l1) { return z < l1->slice_z; });
+                    --last_layer;
+
+                    for (auto layer_it = first_layer; layer_it != (last_layer + 1); ++layer_it) {
+                        const Layer *layer     = *layer_it;
+                        size_t       layer_idx = layer_it - layers.begin();
+                        if (reused_layers[layer_idx] != nullptr || input_expolygons[layer_idx].empty() || facet[0].z() > layer->slice_z || layer->slice_z > facet[2].z())
+                            continue;
+
+                        // https://kandepet.com/3d-printing-slicing-3d-objects/
+                        float t            = (float(layer->slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
+                        Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
+                        Vec3f line_end_f;
+
+                        if (facet[1].z() > layer->slice_z) {
+                            // [P0, P2] and [P0, P1]
+                            float t1   = (float(layer->slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
+                            line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
+                        } else {
+                            // [P0, P2] and [P1, P2]
+                            float t2   = (float(layer->slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
+                            line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
+                        }
 
-                        for (auto layer_it = first_layer; layer_it != (last_layer + 1); ++layer_it) {
-                            const Layer *layer     = *layer_it;
-                            size_t       layer_idx = layer_it - layers.begin();
-                            if (input_expolygons[layer_idx].empty() || facet[0].z() > layer->slice_z || layer->slice_z > facet[2].z())
+                        Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
+                                          Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
+                        line_to_test.translate(-print_object.center_offset());
+
+                        // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
+                        // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
+                        // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
+                        // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
+                        if (const BoundingBox &edge_grid_bbox = edge_grids[layer_idx].bbox(); !edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
+                            // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
+                            if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
+                                !line_to_test.clip_with_bbox(edge_grid_bbox))
                                 continue;
+                        }
 
-                            // https://kandepet.com/3d-printing-slicing-3d-objects/
-                            float t            = (float(layer->slice_z) - facet[0].z()) / (facet[2].z() - facet[0].z());
-                            Vec3f line_start_f = facet[0] + t * (facet[2] - facet[0]);
-                            Vec3f line_end_f;
-
-                            if (facet[1].z() > layer->slice_z) {
-                                // [P0, P2] and [P0, P1]
-                                float t1   = (float(layer->slice_z) - facet[0].z()) / (facet[1].z() - facet[0].z());
-                                line_end_f = facet[0] + t1 * (facet[1] - facet[0]);
-                            } else {
-                                // [P0, P2] and [P1, P2]
-                                float t2   = (float(layer->slice_z) - facet[1].z()) / (facet[2].z() - facet[1].z());
-                                line_end_f = facet[1] + t2 * (facet[2] - facet[1]);
-                            }
-
-                            Line line_to_test(Point(scale_(line_start_f.x()), scale_(line_start_f.y())),
-                                              Point(scale_(line_end_f.x()), scale_(line_end_f.y())));
-                            line_to_test.translate(-print_object.center_offset());
-
-                            // BoundingBoxes for EdgeGrids are computed from printable regions. It is possible that the painted line (line_to_test) could
-                            // be outside EdgeGrid's BoundingBox, for example, when the negative volume is used on the painted area (GH #7618).
-                            // To ensure that the painted line is always inside EdgeGrid's BoundingBox, it is clipped by EdgeGrid's BoundingBox in cases
-                            // when any of the endpoints of the line are outside the EdgeGrid's BoundingBox.
-                            if (const BoundingBox &edge_grid_bbox = edge_grids[layer_idx].bbox(); !edge_grid_bbox.contains(line_to_test.a) || !edge_grid_bbox.contains(line_to_test.b)) {
-                                // If the painted line (line_to_test) is entirely outside EdgeGrid's BoundingBox, skip this painted line.
-                                if (!edge_grid_bbox.overlap(BoundingBox(Points{line_to_test.a, line_to_test.b})) ||
-                                    !line_to_test.clip_with_bbox(edge_grid_bbox))
-                                    continue;
-                            }
-
-                            size_t mutex_idx = layer_idx & 0x3F;
-                            assert(mutex_idx < painted_lines_mutex.size());
+                        size_t mutex_idx = layer_idx & 0x3F;
+                        assert(mutex_idx < painted_lines_mutex.size());
 
-                            PaintedLineVisitor visitor(edge_grids[layer_idx], painted_lines[layer_idx], painted_lines_mutex[mutex_idx], 16);
-                            visitor.resolution = resolution; // note: multiply that if there is still problem with artifact on mmu paint with low resolution (high resolution value).
-                            visitor.line_to_test = line_to_test;
-                            visitor.color        = int(extruder_idx);
-                            edge_grids[layer_idx].visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
-                        }
+                        PaintedLineVisitor visitor(edge_grids[layer_idx], painted_lines[layer_idx], painted_lines_mutex[mutex_idx], 16);
+                        visitor.resolution = resolution; // note: multiply that if there is still problem with artifact on mmu paint with low resolution (high resolution value).
+                        visitor.line_to_test = line_to_test;
+                        visitor.color        = int(extruder_idx);
+                        edge_grids[layer_idx].visit_cells_intersecting_line(line_to_test.a, line_to_test.b, visitor);
                     }
-                }); // end of parallel_for 
-            }
-        }); // end of parallel_for
-    }
+                }
+            }); // end of parallel_for
+        }
+    }); // end of parallel_for
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - projection of painted triangles - end";
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - painted layers count: "
                              << std::count_if(painted_lines.begin(), painted_lines.end(), [](const std::vector<PaintedLine> &pl) { return !pl.empty(); });
 
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers segmentation in parallel - begin";
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&edge_grids, &input_expolygons, &painted_lines, &segmented_regions, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_layers), [&edge_grids, &input_expolygons, &painted_lines, &segmented_regions, &reused_layers, &num_extruders, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
         for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++layer_idx) {
             throw_on_cancel_callback();
-            if (!painted_lines[layer_idx].empty()) {
+            if (const MMSegmentationCache::LayerSegmentation *reused = reused_layers[layer_idx]; reused != nullptr) {
+                segmented_regions[layer_idx] = reused->segmentation;
+            } else if (!painted_lines[layer_idx].empty()) {
 #ifdef MM_SEGMENTATION_DEBUG_PAINTED_LINES
                 export_painted_lines_to_svg(debug_out_path("mm-painted-lines-%d-%d.svg", layer_idx, iRun), {painted_lines[layer_idx]}, input_expolygons[layer_idx]);
 #endif // MM_SEGMENTATION_DEBUG_PAINTED_LINES
@@ -1437,6 +1554,14 @@ std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(con
     BOOST_LOG_TRIVIAL(debug) << "MM segmentation - layers segmentation in parallel - end";
     throw_on_cancel_callback();
 
+    if (cache) {
+        // Store the side segmentation before it is cut and merged with the top and bottom layers.
+        current.layers.reserve(num_layers);
+        for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx)
+            current.layers.push_back({ layers[layer_idx]->slice_z, input_hashes[layer_idx], segmented_regions[layer_idx] });
+        cache->store(std::move(current));
+    }
+
     if (auto max_width = print_object.config().mmu_segmented_region_max_width, interlocking_depth = print_object.config().mmu_segmented_region_interlocking_depth; max_width > 0.f) {
         cut_segmented_layers(input_expolygons, segmented_regions, float(scale_(max_width)), float(scale_(interlocking_depth)), throw_on_cancel_callback);
         throw_on_cancel_callback();
@@ -5,14 +5,17 @@
 #ifndef slic3r_MultiMaterialSegmentation_hpp_
 #define slic3r_MultiMaterialSegmentation_hpp_
 
+#include <functional>
+#include <mutex>
 #include <utility>
 #include <vector>
 
+#include "ExPolygon.hpp"
+#include "Line.hpp"
+
 namespace Slic3r {
 
 class PrintObject;
-class ExPolygon;
-using ExPolygons = std::vector<ExPolygon>;
 
 struct ColoredLine
 {
@@ -24,8 +27,56 @@ struct ColoredLine
 
 using ColoredLines = std::vector<ColoredLine>;
 
+// Segmentation of the individual layers by the painted sides of the object, kept between slicing runs.
+// When the painting changes, only the layers intersected by the added or removed painted triangles
+// are segmented again, the segmentation of the other layers is reused.
+class MMSegmentationCache
+{
+public:
+    // Painted triangle, identified by a hash of its transformed vertices and its extruder.
+    struct PaintedFacet
+    {
+        size_t hash;
+        float  min_z;
+        float  max_z;
+
+        bool operator<(const PaintedFacet &rhs) const { return hash < rhs.hash; }
+    };
+
+    struct LayerSegmentation
+    {
+        double                  slice_z;
+        // Hash of the layer input polygons and of the bounding box of its EdgeGrid.
+        size_t                  input_hash;
+        // Indexed by the extruder ID, the zero item is for the default extruder.
+        std::vector<ExPolygons> segmentation;
+    };
+
+    struct Data
+    {
+        // Hash of the object transformation, of the resolution and of the number of extruders.
+        size_t                         params_hash { 0 };
+        // Sorted by hash.
+        std::vector<PaintedFacet>      painted_facets;
+        // Sorted by slice_z.
+        std::vector<LayerSegmentation> layers;
+    };
+
+    // Move the cached data out of the cache, so that the cache is not locked during the segmentation.
+    // PrintObjects sharing the cache (instances rotated around Z) may be sliced in parallel,
+    // the later one will find the cache empty and segment all its layers.
+    Data take()              { std::lock_guard<std::mutex> lock(m_mutex); return std::exchange(m_data, Data{}); }
+    void store(Data &&data)  { std::lock_guard<std::mutex> lock(m_mutex); m_data = std::move(data); }
+    void clear()             { std::lock_guard<std::mutex> lock(m_mutex); m_data = Data{}; }
+
+private:
+    std::mutex m_mutex;
+    Data       m_data;
+};
+
 // Returns MMU segmentation based on painting in MMU segmentation gizmo
-std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+// If cache is provided, the side segmentation of layers not affected by a painting change is reused from the previous run.
+std::vector<std::vector<ExPolygons>> multi_material_segmentation_by_painting(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback, MMSegmentationCache *cache = nullptr);
 
 } // namespace Slic3r
 
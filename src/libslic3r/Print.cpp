@@ -1257,12 +1257,14 @@ void Print::process()
     name_tbb_thread_pool_threads_set_locale();
     bool something_done = !is_step_done_unguarded(psSkirtBrim);
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
+    m_memory_by_step.clear();
     secondary_status_counter_reset();
     Slic3r::parallel_for(size_t(0), m_objects.size(),
         [this](const size_t idx) {
             m_objects[idx]->make_perimeters();
         }
     );
+    this->log_step_memory("slicing & perimeters");
 #ifdef _DEBUG
     for (const PrintObject* obj : m_objects)
         for (const Layer* lay : obj->layers())
@@ -1277,12 +1279,18 @@ void Print::process()
             m_objects[idx]->infill();
         }
     );
+    this->log_step_memory("infill");
     secondary_status_counter_reset();
     Slic3r::parallel_for(size_t(0), m_objects.size(),
         [this](const size_t idx) {
             m_objects[idx]->ironing();
         }
     );
+    if (m_low_memory_mode) {
+        for (PrintObject *obj : m_objects)
+            obj->release_data_after_step(posIroning);
+        this->log_step_memory("releasing the infill data");
+    }
 
     // The following step writes to m_shared_regions, it should not run in parallel.
     //FIXME: only run it when the support is needed.
@@ -1299,6 +1307,12 @@ void Print::process()
             m_objects[idx]->generate_support_material();
         }
     );
+    this->log_step_memory("support material");
+    if (m_low_memory_mode) {
+        for (PrintObject *obj : m_objects)
+            obj->release_data_after_step(posSupportMaterial);
+        this->log_step_memory("releasing the support data");
+    }
     secondary_status_counter_reset();
     Slic3r::parallel_for(size_t(0), m_objects.size(),
         [this](const size_t idx) {
@@ -1504,6 +1518,7 @@ void Print::process()
 #endif
 
     m_timestamp_last_change = std::time(0);
+    this->log_step_memory("slicing process");
     BOOST_LOG_TRIVIAL(info) << "Slicing process finished." << log_memory_info();
     //notify gui that the slicing/preview structs are ready to be drawed
     if (something_done)
@@ -1514,7 +1529,8 @@ void Print::process()
 // The export_gcode may die for various reasons (fails to process output_filename_format,
 // write error into the G-code, cannot execute post-processing scripts).
 // It is up to the caller to show an error message.
-std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
+std::string Print::export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb,
+                                std::function<bool(const char*, size_t)> output_sink)
 {
     // output everything to a G-code file
     // The following call may die if the output_filename_format template substitution fails.
@@ -1530,7 +1546,17 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
 
     // Create GCode on heap, it has quite a lot of data.
     std::unique_ptr<GCodeGenerator> gcode(new GCodeGenerator());
+    if (output_sink)
+        gcode->set_output_sink(std::move(output_sink));
     gcode->do_export(this, path.c_str(), result, thumbnail_cb);
+    gcode.reset();
+    this->log_step_memory("G-code export");
+
+    if (m_low_memory_mode) {
+        // The layers were released by the G-code generator, they have to be sliced again if needed.
+        for (PrintObject *object : m_objects)
+            object->invalidate_all_steps();
+    }
 
     if (m_conflict_result.has_value())
         result->conflict_result = *m_conflict_result;
@@ -1538,6 +1564,13 @@ std::string Print::export_gcode(const std::string& path_template, GCodeProcessor
     return path.c_str();
 }
 
+void Print::log_step_memory(const char *step)
+{
+    size_t resident = resident_memory();
+    m_memory_by_step.emplace_back(step, resident);
+    BOOST_LOG_TRIVIAL(info) << "Memory usage after " << step << ": " << format_memsize_MB(resident);
+}
+
 bool has_brim_patch(const PrintObject &obj, ModelVolumeType brim_type)
 {
     bool found = false;
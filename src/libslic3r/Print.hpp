@@ -58,6 +58,7 @@ class Layer;
 class ModelObject;
 class Print;
 class PrintObject;
+struct PrintObjectSeamData;
 class SupportLayer;
 class WipeTower2;
 
@@ -297,10 +298,14 @@ public:
 
     std::optional<GeneratedSupportPoints> generated_support_points;
 
+    // Per layer MMU segmentation of the painted sides, reused when only a part of the painting changes.
+    MMSegmentationCache                   mm_segmentation_cache;
+
     void clear() {
         all_regions.clear();
         layer_ranges.clear();
         cached_volume_ids.clear();
+        mm_segmentation_cache.clear();
     }
 
 private:
@@ -404,6 +409,9 @@ public:
 
     // Called by make_perimeters()
     void slice();
+    // For each layer the index of a layer with the same perimeters to copy them from, or the layer's own index
+    // if its perimeters are generated. See Print::set_reuse_perimeters().
+    std::vector<size_t>         perimeters_source_layers() const;
 
     // Helpers to slice support enforcer / blocker meshes by the support generator.
     std::vector<ExPolygons>     slice_support_volumes(const ModelVolumeType model_volume_type) const;
@@ -413,6 +421,15 @@ public:
     // Helpers to project custom facets on slices
     std::vector<Polygons> project_and_append_custom_facets(bool seam, EnforcerBlockerType type) const;
 
+    // Seam candidates and seams computed by the SeamPlacer during the last G-code export, reused by the next export
+    // until the slices, the perimeters, the seam painting or the seam options change.
+    // set_seam_data() is const, as it is called by SeamPlacer::init() during the G-code export, which has a const access
+    // to the PrintObject only. It is not synchronized: The seam data is only invalidated by Print::apply() and by
+    // the invalidation of the steps, which cancel the background processing and wait for it before invalidating it.
+    const std::shared_ptr<PrintObjectSeamData>& seam_data() const { return m_seam_data; }
+    void set_seam_data(std::shared_ptr<PrintObjectSeamData> seam_data) const { m_seam_data = std::move(seam_data); }
+    void invalidate_seam_data() { m_seam_data.reset(); }
+
     /// skirts if done per copy and not per platter
     const std::optional<ExtrusionEntityCollection>& skirt_first_layer() const { return m_skirt_first_layer; }
     const ExtrusionEntityCollection& skirt() const { return m_skirt; }
@@ -459,6 +476,8 @@ private:
     void estimate_curled_extrusions();
     void calculate_overhanging_perimeters();
     void simplify_extrusion_path();
+    // Low memory mode: free the data of the layers which is not needed by the steps after the given one.
+    void release_data_after_step(PrintObjectStep step);
 
     void slice_volumes();
     // Has any support (not counting the raft).
@@ -519,6 +538,8 @@ private:
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     // filled by prepare_lightning_infill_data() (in bridge_over_infill() in prepare_infill()) and used in infill()
     FillLightning::GeneratorPtr m_lightning_generator;
+    // Written by the G-code export, which has a const access to the PrintObject only. See seam_data().
+    mutable std::shared_ptr<PrintObjectSeamData> m_seam_data;
 };
 
 
@@ -702,7 +723,22 @@ public:
 
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
-    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // If output_sink is set, the final G-code is passed to it while it is being written, for example to stream it to a print host.
+    std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr,
+                                     std::function<bool(const char*, size_t)> output_sink = nullptr);
+
+    // Low memory mode of the command line: process() releases the intermediate data of the layers at the step
+    // boundaries, once no later step needs it, and the geometry of the object layers is released during the G-code
+    // export, as soon as the G-code generator does not need it anymore. The steps are thus not idempotent anymore,
+    // all the PrintObject steps are invalidated after the export.
+    void                set_low_memory_mode(bool low_memory) { m_low_memory_mode = low_memory; }
+    bool                low_memory_mode() const { return m_low_memory_mode; }
+    // Layers with the same slices as the layer two layers below, sandwiched between the same slices, copy the perimeters
+    // of that layer instead of generating them. Enabled by default, disabled to compare against the generated perimeters.
+    void                set_reuse_perimeters(bool reuse) { m_reuse_perimeters = reuse; }
+    bool                reuse_perimeters() const { return m_reuse_perimeters; }
+    // Resident memory of the process after the main steps of the last process() and export_gcode() calls.
+    const std::vector<std::pair<std::string, size_t>>& memory_by_step() const { return m_memory_by_step; }
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -740,9 +776,15 @@ public:
     SpanOfConstPtrs<PrintObject> objects() const { return SpanOfConstPtrs<PrintObject>(const_cast<const PrintObject* const* const>(m_objects.data()), m_objects.size()); }
     PrintObject*                get_object(size_t idx) { return const_cast<PrintObject*>(m_objects[idx]); }
     const PrintObject*          get_object(size_t idx) const { return m_objects[idx]; }
+    // Identical ModelObjects share the PrintObjects of the first of them, search the instances as well.
     const PrintObject*          get_print_object_by_model_object_id(ObjectID object_id) const {
         auto it = std::find_if(m_objects.begin(), m_objects.end(),
                                [object_id](const PrintObject* obj) { return obj->model_object()->id() == object_id; });
+        if (it == m_objects.end())
+            it = std::find_if(m_objects.begin(), m_objects.end(), [object_id](const PrintObject *obj) {
+                return std::any_of(obj->instances().begin(), obj->instances().end(),
+                                   [object_id](const PrintInstance &pi) { return pi.model_instance->get_object()->id() == object_id; });
+            });
         return (it == m_objects.end()) ? nullptr : *it;
     }
     // PrintObject by its ObjectID, to be used to uniquely bind slicing warnings to their source PrintObjects
@@ -881,6 +923,11 @@ private:
     friend class PrintObject;
 
     std::optional<ConflictResult> m_conflict_result;
+
+    void                                    log_step_memory(const char *step);
+    bool                                    m_low_memory_mode { false };
+    bool                                    m_reuse_perimeters { true };
+    std::vector<std::pair<std::string, size_t>> m_memory_by_step;
 };
 
 //for testing purpose (in printobject)
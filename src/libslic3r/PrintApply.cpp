@@ -135,22 +135,24 @@ struct PrintObjectTrafoAndInstances
     bool operator<(const PrintObjectTrafoAndInstances &rhs) const { return transform3d_lower(this->trafo, rhs.trafo); }
 };
 
-// Generate a list of trafos and XY offsets for instances of a ModelObject
-static std::vector<PrintObjectTrafoAndInstances> print_objects_from_model_object(const ModelObject &model_object)
+// Generate a list of trafos and XY offsets for instances of ModelObjects sharing their PrintObjects.
+// The first ModelObject owns the PrintObjects, the others are sliced the same (see model_objects_print_equal()).
+static std::vector<PrintObjectTrafoAndInstances> print_objects_from_model_objects(const std::vector<const ModelObject*> &model_objects)
 {
     std::set<PrintObjectTrafoAndInstances> trafos;
     PrintObjectTrafoAndInstances           trafo;
-    for (ModelInstance *model_instance : model_object.instances)
-        if (model_instance->is_printable()) {
-            trafo.trafo = model_instance->get_matrix();
-            auto shift = Point::new_scale(trafo.trafo.data()[12], trafo.trafo.data()[13]);
-            // Reset the XY axes of the transformation.
-            trafo.trafo.data()[12] = 0;
-            trafo.trafo.data()[13] = 0;
-            // Search or insert a trafo.
-            auto it = trafos.emplace(trafo).first;
-            const_cast<PrintObjectTrafoAndInstances&>(*it).instances.emplace_back(PrintInstance{ nullptr, model_instance, shift });
-        }
+    for (const ModelObject *model_object : model_objects)
+        for (ModelInstance *model_instance : model_object->instances)
+            if (model_instance->is_printable()) {
+                trafo.trafo = model_instance->get_matrix();
+                auto shift = Point::new_scale(trafo.trafo.data()[12], trafo.trafo.data()[13]);
+                // Reset the XY axes of the transformation.
+                trafo.trafo.data()[12] = 0;
+                trafo.trafo.data()[13] = 0;
+                // Search or insert a trafo.
+                auto it = trafos.emplace(trafo).first;
+                const_cast<PrintObjectTrafoAndInstances&>(*it).instances.emplace_back(PrintInstance{ nullptr, model_instance, shift });
+            }
     return std::vector<PrintObjectTrafoAndInstances>(trafos.begin(), trafos.end());
 }
 
@@ -460,6 +462,41 @@ private:
     std::multiset<PrintObjectStatus> m_db;
 };
 
+// Group ModelObjects, which are sliced the same (copy / pasted or the same file imported multiple times), to share a single set of PrintObjects.
+// Returns the groups in the order of model_objects, the owner of the shared PrintObjects first in its group.
+// A ModelObject already owning some PrintObjects is preferred as the owner to keep its slicing results.
+static std::vector<std::vector<const ModelObject*>> model_objects_sharing_print_objects(const ModelObjectPtrs &model_objects, const PrintObjectStatusDB &print_object_status_db)
+{
+    // Cheap key to limit the full comparison of ModelObjects to likely candidates.
+    auto signature = [](const ModelObject &mo) {
+        size_t facets = 0;
+        for (const ModelVolume *mv : mo.volumes)
+            facets += mv->mesh().facets_count();
+        return std::make_pair(mo.volumes.size(), facets);
+    };
+    std::vector<std::vector<const ModelObject*>>         groups;
+    std::map<std::pair<size_t, size_t>, std::vector<size_t>> groups_by_signature;
+    for (const ModelObject *model_object : model_objects) {
+        std::vector<size_t> &candidates = groups_by_signature[signature(*model_object)];
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&groups, model_object](size_t idx) { return model_objects_print_equal(*groups[idx].front(), *model_object); });
+        if (it == candidates.end()) {
+            candidates.emplace_back(groups.size());
+            groups.push_back({ model_object });
+        } else
+            groups[*it].emplace_back(model_object);
+    }
+    for (std::vector<const ModelObject*> &group : groups)
+        if (group.size() > 1) {
+            auto it_owner = std::find_if(group.begin(), group.end(), [&print_object_status_db](const ModelObject *mo) {
+                auto range = print_object_status_db.get_range(*mo);
+                return std::any_of(range.begin(), range.end(), [](const PrintObjectStatus &pos) { return pos.status != PrintObjectStatus::Deleted; });
+            });
+            if (it_owner != group.end())
+                std::rotate(group.begin(), it_owner, it_owner + 1);
+        }
+    return groups;
+}
+
 static inline bool model_volume_solid_or_modifier(const ModelVolume &mv)
 {
     ModelVolumeType type = mv.type();
@@ -1253,6 +1290,9 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
                 }
             } else if (model_custom_seam_data_changed(model_object, model_object_new)) {
                 update_apply_status(this->invalidate_step(psGCodeExport));
+                // The seam enforcers and blockers are baked into the seam candidates.
+                for (const PrintObjectStatus &print_object_status : print_objects_range)
+                    print_object_status.print_object->invalidate_seam_data();
             }
         }
         if (! solid_or_modifier_differ) {
@@ -1316,9 +1356,11 @@ Print::ApplyStatus Print::apply(const Model &model, DynamicPrintConfig new_full_
         print_objects_new.reserve(std::max(m_objects.size(), m_model.objects.size()));
         bool new_objects = false;
         // Walk over all new model objects and check, whether there are matching PrintObjects.
-        for (ModelObject *model_object : m_model.objects) {
+        // Instances of ModelObjects sliced the same are added to the PrintObjects of the first of them.
+        for (const std::vector<const ModelObject*> &model_objects : model_objects_sharing_print_objects(m_model.objects, print_object_status_db)) {
+            ModelObject       *model_object        = const_cast<ModelObject*>(model_objects.front());
             ModelObjectStatus &model_object_status = const_cast<ModelObjectStatus&>(model_object_status_db.reuse(*model_object));
-            model_object_status.print_instances    = print_objects_from_model_object(*model_object);
+            model_object_status.print_instances    = print_objects_from_model_objects(model_objects);
             std::vector<const PrintObjectStatus*> old;
             old.reserve(print_object_status_db.count(*model_object));
             for (const PrintObjectStatus &print_object_status : print_object_status_db.get_range(*model_object))
@@ -12532,6 +12532,11 @@ CLIMiscConfigDef::CLIMiscConfigDef()
                      "For example. loglevel=2 logs fatal, error and warning level messages.");
     def->min = 0;
 
+    def = this->add("low_memory", coBool);
+    def->label = L("Low memory mode");
+    def->tooltip = L("Release the data of the sliced objects as soon as the later slicing steps and the G-code export do not need it anymore "
+                     "and print the memory usage after each slicing step. Useful for very large prints on machines with little memory.");
+
 #if (defined(_MSC_VER) || defined(__MINGW32__)) && defined(SLIC3R_GUI)
     def = this->add("sw_renderer", coBool);
     def->label = L("Render with a software renderer");
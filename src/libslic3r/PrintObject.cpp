@@ -55,6 +55,7 @@
 #include <functional>
 #include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -178,6 +179,60 @@ std::vector<std::reference_wrapper<const PrintRegion>> PrintObject::all_regions(
     return out;
 }
 
+// Test whether two layers have the same height, slices and regions, including the extra perimeters counters of the region slices.
+static bool layer_slices_equal(const Layer &layer1, const Layer &layer2)
+{
+    if (layer1.scaled_height() != layer2.scaled_height() || layer1.region_count() != layer2.region_count() ||
+        layer1.islands().size() != layer2.islands().size() || layer1.lslices() != layer2.lslices())
+        return false;
+    for (size_t region_id = 0; region_id < layer1.region_count(); ++ region_id) {
+        const LayerRegion &layerm1 = *layer1.get_region(region_id);
+        const LayerRegion &layerm2 = *layer2.get_region(region_id);
+        if (&layerm1.region() != &layerm2.region() || layerm1.slices().surfaces.size() != layerm2.slices().surfaces.size() ||
+            layerm1.get_raw_slices() != layerm2.get_raw_slices())
+            return false;
+        for (size_t i = 0; i < layerm1.slices().surfaces.size(); ++ i) {
+            const Surface &surface1 = layerm1.slices().surfaces[i];
+            const Surface &surface2 = layerm2.slices().surfaces[i];
+            if (surface1.surface_type != surface2.surface_type || surface1.extra_perimeters != surface2.extra_perimeters ||
+                surface1.expolygon != surface2.expolygon)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Prismatic parts have long runs of layers with the same slices. The perimeters of a layer depend on its slices, on the slices
+// of the layers below and above, on the regions, on the layer height and on the parity of the layer ID (direction of some perimeters).
+// A layer may copy the perimeters of the layer two layers below if the slices of these two layers, of the layers below them
+// and of the layers above them are the same.
+std::vector<size_t> PrintObject::perimeters_source_layers() const
+{
+    auto                layers = this->layers();
+    std::vector<size_t> source(layers.size());
+    std::iota(source.begin(), source.end(), 0);
+    // Fuzzy skin is random, spiral vase depends on the layer height from the bed.
+    if (! this->print()->reuse_perimeters() || this->print()->config().spiral_vase || layers.size() < 5)
+        return source;
+    // Lowest layer ID not influenced by the first layer, raft and bottom solid layers specific code of the perimeter generator.
+    size_t min_layer_id = size_t(this->config().raft_layers.value) + 1;
+    for (size_t region_id = 0; region_id < this->num_printing_regions(); ++ region_id) {
+        const PrintRegionConfig &config = this->printing_region(region_id).config();
+        if (config.fuzzy_skin.value != FuzzySkinType::None)
+            return source;
+        min_layer_id = std::max(min_layer_id, size_t(std::max(0, config.bottom_solid_layers.value)));
+    }
+    // Layer at index i has the same slices as the layer at index i - 2.
+    std::vector<char> same_slices(layers.size(), false);
+    Slic3r::parallel_for(size_t(2), layers.size(), [&layers, &same_slices](const size_t layer_idx) {
+        same_slices[layer_idx] = layer_slices_equal(*layers[layer_idx], *layers[layer_idx - 2]);
+    });
+    for (size_t layer_idx = 3; layer_idx + 1 < layers.size(); ++ layer_idx)
+        if (layers[layer_idx - 2]->id() >= min_layer_id && same_slices[layer_idx - 1] && same_slices[layer_idx] && same_slices[layer_idx + 1])
+            source[layer_idx] = source[layer_idx - 2];
+    return source;
+}
+
 // 1) Merges typed region slices into stInternal type.
 // 2) Increases an "extra perimeters" counter at region slices where needed.
 // 3) Generates perimeters, gap fills and fill regions (fill regions of type stInternal).
@@ -278,24 +333,53 @@ void PrintObject::make_perimeters()
         BOOST_LOG_TRIVIAL(debug) << "Generating extra perimeters for region " << region_id << " in parallel - end";
     }
 
+    // Layers with the same perimeters as a layer below copy them after they were generated.
+    const std::vector<size_t> perimeters_source = this->perimeters_source_layers();
+    auto update_perimeters_progress = [this]() {
+        int32_t nb_layers_done = m_print->secondary_status_counter_increment();
+        m_print->set_status( int((nb_layers_done * 100) / m_print->secondary_status_counter_get_max()), L("Generating perimeters: layer %s / %s"), 
+            { std::to_string(nb_layers_done), std::to_string(m_print->secondary_status_counter_get_max()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+    };
+
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - start";
     Slic3r::parallel_for(size_t(0), m_layers.size(),
-        [this](const size_t layer_idx) {
+        [this, &perimeters_source, &update_perimeters_progress](const size_t layer_idx) {
+                if (perimeters_source[layer_idx] != layer_idx)
+                    return;
                 PRINT_OBJECT_TIME_LIMIT_MILLIS(PRINT_OBJECT_TIME_LIMIT_DEFAULT);
                 m_print->throw_if_canceled();
 
                 // updating progress
-                int32_t nb_layers_done = m_print->secondary_status_counter_increment();
-                m_print->set_status( int((nb_layers_done * 100) / m_print->secondary_status_counter_get_max()), L("Generating perimeters: layer %s / %s"), 
-                    { std::to_string(nb_layers_done), std::to_string(m_print->secondary_status_counter_get_max()) }, PrintBase::SlicingStatus::SECONDARY_STATE);
+                update_perimeters_progress();
 
                 // make perimeters
+                ExtrusionEntityArena::Scope arena_scope;
                 m_layers[layer_idx]->make_perimeters();
         }
     );
     m_print->throw_if_canceled();
     BOOST_LOG_TRIVIAL(debug) << "Generating perimeters in parallel - end";
 
+    size_t num_copied = 0;
+    for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+        if (perimeters_source[layer_idx] != layer_idx)
+            ++ num_copied;
+    if (num_copied > 0) {
+        Slic3r::parallel_for(size_t(0), m_layers.size(),
+            [this, &perimeters_source, &update_perimeters_progress](const size_t layer_idx) {
+                if (perimeters_source[layer_idx] == layer_idx)
+                    return;
+                m_print->throw_if_canceled();
+                update_perimeters_progress();
+                ExtrusionEntityArena::Scope arena_scope;
+                m_layers[layer_idx]->copy_perimeters(*m_layers[perimeters_source[layer_idx]]);
+            }
+        );
+        m_print->throw_if_canceled();
+    }
+    BOOST_LOG_TRIVIAL(info) << "Perimeters of " << num_copied << " of " << m_layers.size() << " layers copied from layers with the same slices ("
+        << (m_layers.empty() ? 0 : 100 * num_copied / m_layers.size()) << "% reused)";
+
     if (print()->config().milling_diameter.size() > 0) {
         BOOST_LOG_TRIVIAL(debug) << "Generating milling post-process in parallel - start";
         Slic3r::parallel_for(size_t(0), m_layers.size(),
@@ -872,6 +956,7 @@ void PrintObject::infill()
 
                     std::chrono::time_point<std::chrono::system_clock> start_make_fill = std::chrono::system_clock::now();
                     m_print->throw_if_canceled();
+                    ExtrusionEntityArena::Scope arena_scope;
                     m_layers[layer_idx]->make_fills(adaptive_fill_octree.get(), support_fill_octree.get(), this->m_lightning_generator.get());
             }
         );
@@ -1063,6 +1148,30 @@ void PrintObject::simplify_extrusion_path()
     }
 }
 
+void PrintObject::release_data_after_step(PrintObjectStep step)
+{
+    switch (step) {
+    case posIroning:
+        // The infill and the ironing are done, nothing reads the infill helpers anymore.
+        m_adaptive_fill_octrees = {};
+        m_lightning_generator.reset();
+        Slic3r::parallel_for(size_t(0), m_layers.size(),
+            [this](const size_t layer_idx) {
+                m_layers[layer_idx]->release_infill_data();
+            }
+        );
+        break;
+    case posSupportMaterial:
+        for (Layer *layer : m_layers)
+            layer->release_support_data();
+        // Shared by the PrintObjects of one ModelObject, released once the support of all of them was generated.
+        m_shared_regions->generated_support_points.reset();
+        break;
+    default:
+        break;
+    }
+}
+
 void PrintObject::estimate_curled_extrusions()
 {
     if (this->set_started(posEstimateCurledExtrusions)) {
@@ -1755,10 +1864,8 @@ bool PrintObject::invalidate_state_by_config_options(
                 || opt_key == "print_retract_lift"
                 || opt_key == "print_temperature"
                 || opt_key == "region_gcode"
-                || opt_key == "seam_position"
                 //|| opt_key == "seam_preferred_direction"
                 //|| opt_key == "seam_preferred_direction_jitter"
-                || opt_key == "seam_angle_cost"
                 || opt_key == "seam_notch_all"
                 || opt_key == "seam_notch_angle"
                 || opt_key == "seam_notch_inner"
@@ -1766,8 +1873,6 @@ bool PrintObject::invalidate_state_by_config_options(
                 || opt_key == "seam_slope_type"
                 || opt_key == "seam_slope_min_height"
                 || opt_key == "seam_slope_max_length"
-                || opt_key == "seam_travel_cost"
-                || opt_key == "seam_visibility"
                 || opt_key == "small_area_infill_flow_compensation_model"
                 || opt_key == "small_perimeter_speed"
                 || opt_key == "small_perimeter_min_length"
@@ -1783,6 +1888,14 @@ bool PrintObject::invalidate_state_by_config_options(
                 || opt_key == "travel_acceleration"
                 || opt_key == "travel_deceleration_use_target") {
             invalidated |= m_print->invalidate_step(psGCodeExport);
+        } else if (
+                opt_key == "seam_position"
+                || opt_key == "seam_angle_cost"
+                || opt_key == "seam_travel_cost"
+                || opt_key == "seam_visibility") {
+            // The seams picked by the SeamPlacer depend on these.
+            invalidated |= m_print->invalidate_step(psGCodeExport);
+            this->invalidate_seam_data();
         } else if (
                 opt_key == "infill_first"
                 || opt_key == "wipe_into_infill"
@@ -1834,6 +1947,7 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
     
     // propagate to dependent steps
     if (step == posPerimeters) {
+        this->invalidate_seam_data();
 		invalidated |= this->invalidate_steps({ posPrepareInfill, posInfill, posIroning,
             posSupportSpotsSearch, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters, posSimplifyPath });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
@@ -1847,6 +1961,7 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
                                                posSupportMaterial, posEstimateCurledExtrusions, posCalculateOverhangingPerimeters,
                                                posSimplifyPath });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
+        this->invalidate_seam_data();
         m_slicing_params->valid = false;
     } else if (step == posSupportMaterial) {
         invalidated |= m_print->invalidate_steps({ psSkirtBrim,  });
@@ -1871,6 +1986,7 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params->valid = false;
+    this->invalidate_seam_data();
 	return result;
 }
 
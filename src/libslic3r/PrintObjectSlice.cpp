@@ -48,11 +48,13 @@ LayerPtrs new_layers(
 }
 
 // Slice single triangle mesh.
+// If facet_z_index of the volume mesh is provided, only the faces spanning the range of zs are sliced.
 static std::vector<ExPolygons> slice_volume(
     const ModelVolume             &volume,
     const std::vector<float>      &zs, 
     const MeshSlicingParamsEx     &params,
-    const std::function<void()>   &throw_on_cancel_callback)
+    const std::function<void()>   &throw_on_cancel_callback,
+    const FacetZIndex             *facet_z_index = nullptr)
 {
     std::vector<ExPolygons> layers;
     if (! zs.empty()) {
@@ -62,7 +64,9 @@ static std::vector<ExPolygons> slice_volume(
             params2.trafo = params2.trafo * volume.get_matrix();
             if (params2.trafo.rotation().determinant() < 0.)
                 its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
+            layers = facet_z_index ?
+                slice_mesh_ex(its, *facet_z_index, zs, params2, throw_on_cancel_callback) :
+                slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
             throw_on_cancel_callback();
         }
     }
@@ -99,7 +103,10 @@ static std::vector<ExPolygons> slice_volume(
                     n_filtered.emplace_back(std::make_pair(first, i));
             }
             if (! n_filtered.empty()) {
-                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, throw_on_cancel_callback);
+                // Just the layer ranges are sliced, the index of faces sorted by z is cached with the mesh and reused
+                // when the volume is sliced again.
+                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, throw_on_cancel_callback,
+                                                              volume.mesh().facet_z_index().get());
                 out.assign(z.size(), ExPolygons());
                 i = 0;
                 for (const std::pair<size_t, size_t> &span : n_filtered)
@@ -1300,10 +1307,10 @@ void PrintObject::_transform_hole_to_polyholes()
 }
 
 template<typename ThrowOnCancel>
-void apply_mm_segmentation(PrintObject &print_object, ThrowOnCancel throw_on_cancel)
+void apply_mm_segmentation(PrintObject &print_object, MMSegmentationCache &cache, ThrowOnCancel throw_on_cancel)
 {
     // Returns MMU segmentation based on painting in MMU segmentation gizmo
-    std::vector<std::vector<ExPolygons>> segmentation = multi_material_segmentation_by_painting(print_object, throw_on_cancel);
+    std::vector<std::vector<ExPolygons>> segmentation = multi_material_segmentation_by_painting(print_object, throw_on_cancel, &cache);
     assert(segmentation.size() == print_object.layer_count());
     tbb::parallel_for(
         tbb::blocked_range<size_t>(0, segmentation.size(), std::max(segmentation.size() / 128, size_t(1))),
@@ -1721,7 +1728,7 @@ void PrintObject::slice_volumes()
         }
 
         BOOST_LOG_TRIVIAL(debug) << "Slicing volumes - MMU segmentation";
-        apply_mm_segmentation(*this, [print]() { print->throw_if_canceled(); });
+        apply_mm_segmentation(*this, m_shared_regions->mm_segmentation_cache, [print]() { print->throw_if_canceled(); });
     }
 
 
@@ -5,8 +5,11 @@
 #include "QuadricEdgeCollapse.hpp"
 #include <tuple>
 #include <optional>
+#include <numeric>
+#include <atomic>
 #include "MutablePriorityQueue.hpp"
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
 
 using namespace Slic3r;
 
@@ -119,8 +122,33 @@ namespace QuadricEdgeCollapse {
     // calculate error for vertex and quadrics, triangle quadrics and triangle vertex give zero, only pozitive number
     double vertex_error(const SymMat &q, const Vec3d &vertex);
     SymMat create_quadric(const Triangle &t, const Vec3d& n, const Vertices &vertices);
+    using SymMats = std::vector<SymMat>;
     std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-    init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+    init(const indexed_triangle_set &its, const SymMats *vertex_quadrics, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn);
+
+    // Optional data per vertex for collapse(), each vector is either empty or of size of vertices
+    struct VertexData {
+        std::vector<bool> locked; // IN: vertices which can't be moved nor removed
+        std::vector<uint32_t> ids; // IN/OUT: compacted together with vertices
+        SymMats quadrics; // IN: used instead of quadrics from triangles, OUT: quadrics of the left vertices
+    };
+    // reduce edges of mesh by priority of error, return error of the last collapsed edge
+    float collapse(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+        VertexData *vertex_data, ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+
+    // Spatial partitioning of mesh for parallel collapse
+    struct Cell {
+        indexed_triangle_set its;
+        VertexData vertex_data;
+        uint32_t triangle_count = 0; // wanted count of triangles in cell
+        float last_error = 0.f;
+    };
+    using Cells = std::vector<Cell>;
+    // split triangles by median of centers along the longest side of their bounding box
+    std::vector<std::vector<uint32_t>> create_cell_triangles(const indexed_triangle_set &its, size_t max_cell_triangle_count);
+    Cells create_cells(const indexed_triangle_set &its, uint32_t triangle_count, size_t max_cell_triangle_count);
+    // join reduced cells back together, shared vertices are merged with sum of their quadrics
+    void merge_cells(Cells &cells, size_t vertex_count, indexed_triangle_set &its, SymMats &quadrics);
     std::optional<uint32_t> find_triangle_index1(uint32_t vi, const VertexInfo& v_info,
         uint32_t ti, const EdgeInfos& e_infos, const Indices& indices);
     void reorder_edges(EdgeInfos &e_infos, const VertexInfo &v_info, uint32_t ti0, uint32_t ti1);
@@ -157,6 +185,12 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // parallel collapse
+    const size_t max_cell_triangle_count = 100000; // default size of cell for partitioning
+    const size_t min_triangle_count_to_partition = 1000000; // smaller meshes are reduced serially
+    const int status_cells_size = 80; // in percents
+    // part of reduction inside of cells left for the whole mesh, to balance errors between cells
+    const double cell_reserve = 0.1;
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -167,6 +201,30 @@ void Slic3r::its_quadric_edge_collapse(
     float *                   max_error,
     std::function<void(void)> throw_on_cancel,
     std::function<void(int)>  status_fn)
+{
+    if (its.indices.size() >= min_triangle_count_to_partition &&
+        tbb::this_task_arena::max_concurrency() > 1)
+        return its_quadric_edge_collapse_parallel(its, triangle_count, max_error,
+                                                  throw_on_cancel, status_fn);
+
+    // check input
+    if (triangle_count >= its.indices.size()) return;
+    float maximal_error = (max_error == nullptr)? std::numeric_limits<float>::max() : *max_error;
+    if (maximal_error <= 0.f) return;
+    if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
+    if (status_fn == nullptr) status_fn = [](int) {};
+
+    float last_collapsed_error = collapse(its, triangle_count, maximal_error, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+void Slic3r::its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count,
+    float *                   max_error,
+    std::function<void(void)> throw_on_cancel,
+    std::function<void(int)>  status_fn,
+    size_t                    cell_triangle_count)
 {
     // check input
     if (triangle_count >= its.indices.size()) return;
@@ -174,6 +232,64 @@ void Slic3r::its_quadric_edge_collapse(
     if (maximal_error <= 0.f) return;
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
+    if (cell_triangle_count == 0) cell_triangle_count = max_cell_triangle_count;
+
+    if (cell_triangle_count >= its.indices.size()) {
+        // only one cell
+        float last_collapsed_error = collapse(its, triangle_count, maximal_error, nullptr, throw_on_cancel, status_fn);
+        if (max_error != nullptr) *max_error = last_collapsed_error;
+        return;
+    }
+
+    Cells cells = create_cells(its, triangle_count, cell_triangle_count);
+    throw_on_cancel();
+
+    // collapse edges inside of cells, vertices shared with other cells are locked
+    std::atomic<size_t> finished_cells(0);
+    StatusFn no_status_fn = [](int) {};
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            Cell &cell = cells[i];
+            cell.last_error = collapse(cell.its, cell.triangle_count, maximal_error,
+                                       &cell.vertex_data, throw_on_cancel, no_status_fn);
+            status_fn(static_cast<int>(++finished_cells * status_cells_size / cells.size()));
+        }
+    }); // END parallel for
+
+    float last_collapsed_error = 0.f;
+    for (const Cell &cell : cells)
+        last_collapsed_error = std::max(last_collapsed_error, cell.last_error);
+
+    SymMats quadrics;
+    merge_cells(cells, its.vertices.size(), its, quadrics);
+    throw_on_cancel();
+
+    // collapse the rest with edges between cells, quadrics of vertices are kept from cells
+    if (triangle_count < its.indices.size()) {
+        StatusFn final_status_fn = [&](int percent) {
+            status_fn(status_cells_size + percent * (100 - status_cells_size) / 100);
+        };
+        VertexData vertex_data;
+        vertex_data.quadrics = std::move(quadrics);
+        last_collapsed_error = std::max(last_collapsed_error,
+            collapse(its, triangle_count, maximal_error, &vertex_data, throw_on_cancel, final_status_fn));
+    }
+    status_fn(100);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse(indexed_triangle_set &its,
+                                    uint32_t              triangle_count,
+                                    float                 maximal_error,
+                                    VertexData *          vertex_data,
+                                    ThrowOnCancel &       throw_on_cancel,
+                                    StatusFn &            status_fn)
+{
+    const std::vector<bool> *locked = (vertex_data == nullptr || vertex_data->locked.empty()) ?
+                                      nullptr : &vertex_data->locked;
+    const SymMats *vertex_quadrics = (vertex_data == nullptr || vertex_data->quadrics.empty()) ?
+                                     nullptr : &vertex_data->quadrics;
 
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
@@ -184,7 +300,7 @@ void Slic3r::its_quadric_edge_collapse(
     VertexInfos   v_infos;
     EdgeInfos     e_infos;
     Errors        errors;
-    std::tie(t_infos, v_infos, e_infos, errors) = init(its, throw_on_cancel, init_status_fn);
+    std::tie(t_infos, v_infos, e_infos, errors) = init(its, vertex_quadrics, throw_on_cancel, init_status_fn);
     throw_on_cancel();
     status_fn(status_init_size);
 
@@ -251,9 +367,12 @@ void Slic3r::its_quadric_edge_collapse(
         Vec3f new_vertex0 = calculate_vertex(vi0, vi1, q, its.vertices);
         // set of triangle indices that change quadric
         uint32_t ti1 = -1; // triangle 1 index
-        auto ti1_opt = (v_info0.count < v_info1.count)?
-            find_triangle_index1(vi1, v_info0, ti0, e_infos, its.indices) :
-            find_triangle_index1(vi0, v_info1, ti0, e_infos, its.indices) ;
+        std::optional<uint32_t> ti1_opt;
+        // locked edge is processed as edge without second triangle
+        if (locked == nullptr || (!(*locked)[vi0] && !(*locked)[vi1]))
+            ti1_opt = (v_info0.count < v_info1.count)?
+                find_triangle_index1(vi1, v_info0, ti0, e_infos, its.indices) :
+                find_triangle_index1(vi0, v_info1, ti0, e_infos, its.indices) ;
         if (ti1_opt.has_value()) { 
             ti1 = *ti1_opt;
             reorder_edges(e_infos, v_info0, ti0, ti1);
@@ -345,9 +464,27 @@ void Slic3r::its_quadric_edge_collapse(
 #endif // EXPENSIVE_DEBUG_CHECKS
     }
 
+    if (vertex_data != nullptr) {
+        // keep data only for not deleted vertices in the same order as compact
+        VertexData &vd = *vertex_data;
+        vd.quadrics.resize(v_infos.size());
+        uint32_t vi_new = 0;
+        for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
+            const VertexInfo &v_info = v_infos[vi];
+            if (v_info.is_deleted()) continue;
+            vd.quadrics[vi_new] = v_info.q;
+            if (!vd.ids.empty()) vd.ids[vi_new] = vd.ids[vi];
+            if (!vd.locked.empty()) vd.locked[vi_new] = vd.locked[vi];
+            ++vi_new;
+        }
+        vd.quadrics.resize(vi_new);
+        if (!vd.ids.empty()) vd.ids.resize(vi_new);
+        if (!vd.locked.empty()) vd.locked.resize(vi_new);
+    }
+
     // compact triangle
     compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+    return last_collapsed_error;
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -442,7 +579,7 @@ SymMat QuadricEdgeCollapse::create_quadric(const Triangle &t,
 }
 
 std::tuple<TriangleInfos, VertexInfos, EdgeInfos, Errors> 
-QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
+QuadricEdgeCollapse::init(const indexed_triangle_set &its, const SymMats *vertex_quadrics, ThrowOnCancel& throw_on_cancel, StatusFn& status_fn)
 {
     int status_offset = 0;
     TriangleInfos t_infos(its.indices.size());
@@ -483,6 +620,12 @@ QuadricEdgeCollapse::init(const indexed_triangle_set &its, ThrowOnCancel& throw_
         status_offset += status_sum_quadric;
     } // remove triangle quadrics
 
+    if (vertex_quadrics != nullptr) {
+        assert(vertex_quadrics->size() == v_infos.size());
+        for (size_t i = 0; i < v_infos.size(); ++i)
+            v_infos[i].q = (*vertex_quadrics)[i];
+    }
+
     // set offseted starts
     uint32_t triangle_start = 0;
     for (VertexInfo &v_info : v_infos) {
@@ -867,6 +1010,152 @@ void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
     its.indices.erase(its.indices.begin() + ti_new, its.indices.end());
 }
 
+std::vector<std::vector<uint32_t>> QuadricEdgeCollapse::create_cell_triangles(
+    const indexed_triangle_set &its, size_t max_cell_triangle_count)
+{
+    std::vector<Vec3f> centers(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+            const Triangle &t = its.indices[i];
+            centers[i] = (its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]) / 3.f;
+        }
+    }); // END parallel for
+
+    std::vector<uint32_t> order(its.indices.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::vector<std::vector<uint32_t>> cells;
+    // ranges of order to split, the first one is on the back
+    std::vector<std::pair<size_t, size_t>> ranges{{0, order.size()}};
+    while (!ranges.empty()) {
+        auto [begin, end] = ranges.back();
+        ranges.pop_back();
+        if (end - begin <= max_cell_triangle_count) {
+            cells.emplace_back(order.begin() + begin, order.begin() + end);
+            std::sort(cells.back().begin(), cells.back().end());
+            continue;
+        }
+
+        Vec3f min = centers[order[begin]], max = min;
+        for (size_t i = begin + 1; i < end; ++i) {
+            min = min.cwiseMin(centers[order[i]]);
+            max = max.cwiseMax(centers[order[i]]);
+        }
+        int axis;
+        (max - min).maxCoeff(&axis);
+
+        size_t middle = (begin + end) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+            [&centers, axis](uint32_t ti1, uint32_t ti2) { return centers[ti1][axis] < centers[ti2][axis]; });
+        ranges.emplace_back(middle, end);
+        ranges.emplace_back(begin, middle);
+    }
+    return cells;
+}
+
+Cells QuadricEdgeCollapse::create_cells(const indexed_triangle_set &its,
+                                        uint32_t                    triangle_count,
+                                        size_t                      max_cell_triangle_count)
+{
+    std::vector<std::vector<uint32_t>> cell_triangles = create_cell_triangles(its, max_cell_triangle_count);
+
+    // vertex used by triangles from more cells is shared
+    const uint32_t no_cell = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> vertex_cell(its.vertices.size(), no_cell);
+    std::vector<bool> shared(its.vertices.size(), false);
+    for (uint32_t ci = 0; ci < cell_triangles.size(); ++ci)
+        for (uint32_t ti : cell_triangles[ci])
+            for (int vi : its.indices[ti]) {
+                uint32_t &cell = vertex_cell[vi];
+                if (cell == no_cell) cell = ci;
+                else if (cell != ci) shared[vi] = true;
+            }
+
+    // triangles touching shared vertices are reduced later with the whole mesh
+    double ratio = triangle_count / static_cast<double>(its.indices.size());
+    Cells cells(cell_triangles.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cells.size(), 1),
+    [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t ci = range.begin(); ci < range.end(); ++ci) {
+            const std::vector<uint32_t> &triangles = cell_triangles[ci];
+            Cell &cell = cells[ci];
+            std::vector<uint32_t> &ids = cell.vertex_data.ids;
+            ids.reserve(triangles.size());
+            for (uint32_t ti : triangles)
+                for (int vi : its.indices[ti]) ids.push_back(vi);
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+            cell.its.vertices.reserve(ids.size());
+            cell.vertex_data.locked.reserve(ids.size());
+            for (uint32_t vi : ids) {
+                cell.its.vertices.push_back(its.vertices[vi]);
+                cell.vertex_data.locked.push_back(shared[vi]);
+            }
+
+            uint32_t border_count = 0;
+            cell.its.indices.reserve(triangles.size());
+            for (uint32_t ti : triangles) {
+                const Triangle &t = its.indices[ti];
+                Triangle cell_t;
+                for (size_t j = 0; j < 3; ++j)
+                    cell_t[j] = std::lower_bound(ids.begin(), ids.end(), uint32_t(t[j])) - ids.begin();
+                if (shared[t[0]] || shared[t[1]] || shared[t[2]]) ++border_count;
+                cell.its.indices.push_back(cell_t);
+            }
+            double cell_ratio = ratio + (1. - ratio) * cell_reserve;
+            cell.triangle_count = border_count + static_cast<uint32_t>(
+                std::round(cell_ratio * (triangles.size() - border_count)));
+        }
+    }); // END parallel for
+    return cells;
+}
+
+void QuadricEdgeCollapse::merge_cells(Cells &               cells,
+                                      size_t                vertex_count,
+                                      indexed_triangle_set &its,
+                                      SymMats &             quadrics)
+{
+    size_t cells_vertex_count = 0, cells_triangle_count = 0;
+    for (const Cell &cell : cells) {
+        cells_vertex_count += cell.its.vertices.size();
+        cells_triangle_count += cell.its.indices.size();
+    }
+    its.clear();
+    its.vertices.reserve(cells_vertex_count);
+    its.indices.reserve(cells_triangle_count);
+    quadrics.clear();
+    quadrics.reserve(cells_vertex_count);
+
+    // index of shared vertex in its, by vertex index before partitioning
+    const uint32_t no_index = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> shared_indices(vertex_count, no_index);
+    std::vector<uint32_t> cell_2_its;
+    for (Cell &cell : cells) {
+        const VertexData &vd = cell.vertex_data;
+        cell_2_its.resize(cell.its.vertices.size());
+        for (size_t vi = 0; vi < cell.its.vertices.size(); ++vi) {
+            if (vd.locked[vi]) {
+                uint32_t &shared_index = shared_indices[vd.ids[vi]];
+                if (shared_index != no_index) {
+                    // quadric of shared vertex is summed from triangles of all cells
+                    quadrics[shared_index] += vd.quadrics[vi];
+                    cell_2_its[vi] = shared_index;
+                    continue;
+                }
+                shared_index = its.vertices.size();
+            }
+            cell_2_its[vi] = its.vertices.size();
+            its.vertices.push_back(cell.its.vertices[vi]);
+            quadrics.push_back(vd.quadrics[vi]);
+        }
+        for (const Triangle &t : cell.its.indices)
+            its.indices.emplace_back(cell_2_its[t[0]], cell_2_its[t[1]], cell_2_its[t[2]]);
+        cell = Cell(); // free memory
+    }
+}
+
 #ifdef EXPENSIVE_DEBUG_CHECKS
 
 // store triangle surrounding to file
@@ -34,6 +34,26 @@ void its_quadric_edge_collapse(
     std::function<void(void)> throw_on_cancel = nullptr,
     std::function<void(int)>  statusfn        = nullptr);
 
+/// <summary>
+/// Simplify mesh by Quadric metric in parallel.
+/// Mesh is split into spatial cells with similar triangle count. Edges inside
+/// of cells are collapsed concurrently, vertices shared by cells stay untouched.
+/// Then the rest of reduction (mainly around borders of cells) is made over the
+/// whole mesh with quadrics collected in cells.
+/// Used by its_quadric_edge_collapse for big meshes.
+/// </summary>
+/// <param name="cell_triangle_count">Maximal count of triangles in one cell.
+/// When zero then default count is used</param>
+/// Other parameters are the same as for its_quadric_edge_collapse,
+/// throw_on_cancel and statusfn are called from more threads.
+void its_quadric_edge_collapse_parallel(
+    indexed_triangle_set &    its,
+    uint32_t                  triangle_count      = 0,
+    float *                   max_error           = nullptr,
+    std::function<void(void)> throw_on_cancel     = nullptr,
+    std::function<void(int)>  statusfn            = nullptr,
+    size_t                    cell_triangle_count = 0);
+
 } // namespace Slic3r
 #endif // slic3r_quadric_edge_collapse_hpp_
 
@@ -7,18 +7,240 @@
 #define SLARASTER_CPP
 
 #include <functional>
+#include <cstring>
 
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
 
 // minz image write:
 #include <miniz.h>
 
 namespace Slic3r { namespace sla {
 
+namespace {
+
+// PNG filter types used by the fast encoder.
+enum PNGFilter : uint8_t { pfSub = 1, pfUp = 2 };
+
+// Filter a single row into dst (without the filter type byte). SLA masks
+// consist of large uniform areas: repeated rows are encoded with the Up
+// filter as all zeros, other rows with the Sub filter, which turns uniform
+// runs into zero runs and leaves non zero bytes only at the (anti aliased)
+// edges. Both compress very well with RLE. Evaluating the usual minimum sum
+// of absolute differences heuristic would cost more than the deflate itself.
+static uint8_t filter_row(const uint8_t *row, const uint8_t *prev_row,
+                          size_t rowbytes, size_t bpp, uint8_t *dst)
+{
+    if (prev_row && std::memcmp(row, prev_row, rowbytes) == 0) {
+        std::memset(dst, 0, rowbytes);
+        return pfUp;
+    }
+
+    std::copy(row, row + std::min(bpp, rowbytes), dst);
+    for (size_t i = bpp; i < rowbytes; ++i)
+        dst[i] = uint8_t(row[i] - row[i - bpp]);
+
+    return pfSub;
+}
+
+// Same as adler32_combine() from zlib: the checksum of two concatenated
+// buffers from the checksums of the parts.
+static uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2)
+{
+    static constexpr uint64_t Base = 65521;
+
+    uint64_t rem  = len2 % Base;
+    uint64_t sum1 = adler1 & 0xffff;
+    uint64_t sum2 = (rem * sum1) % Base;
+    sum1 += (adler2 & 0xffff) + Base - 1;
+    sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + Base - rem;
+    if (sum1 >= Base) sum1 -= Base;
+    if (sum1 >= Base) sum1 -= Base;
+    if (sum2 >= (Base << 1)) sum2 -= (Base << 1);
+    if (sum2 >= Base) sum2 -= Base;
+
+    return uint32_t(sum1 | (sum2 << 16));
+}
+
+// Adler-32 of data consisting mostly of zero runs (filtered SLA masks). Zero
+// bytes don't change s1 and add s1 to s2 each, thus aligned all zero windows
+// are accounted for in constant time and only the rest is summed up.
+static uint32_t adler32_sparse(uint32_t adler, const uint8_t *data, size_t len)
+{
+    static constexpr size_t   Window = 32;
+    static constexpr uint64_t Base   = 65521;
+
+    size_t dense_begin = 0;
+    size_t zeros       = 0;
+    auto flush = [&](size_t dense_end) {
+        if (zeros > 0) {
+            uint64_t s1 = adler & 0xffff;
+            uint64_t s2 = ((adler >> 16) + s1 * (zeros % Base)) % Base;
+            adler = uint32_t(s1 | (s2 << 16));
+            zeros = 0;
+        }
+        if (dense_end > dense_begin)
+            adler = uint32_t(mz_adler32(adler, data + dense_begin, dense_end - dense_begin));
+    };
+
+    size_t i = 0;
+    for (; i + Window <= len; i += Window) {
+        uint64_t w[Window / sizeof(uint64_t)];
+        std::memcpy(w, data + i, Window);
+        if ((w[0] | w[1] | w[2] | w[3]) == 0) {
+            if (dense_begin < i)
+                flush(i);
+            zeros += Window;
+            dense_begin = i + Window;
+        } else if (zeros > 0)
+            flush(i);
+    }
+    flush(len);
+
+    return adler;
+}
+
+static void append_u32_be(std::vector<uint8_t> &buf, uint32_t v)
+{
+    buf.insert(buf.end(), {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)});
+}
+
+static void append_png_chunk(std::vector<uint8_t> &buf, const char *type,
+                             const uint8_t *data, size_t len)
+{
+    append_u32_be(buf, uint32_t(len));
+    size_t type_pos = buf.size();
+    buf.insert(buf.end(), type, type + 4);
+    if (len > 0)
+        buf.insert(buf.end(), data, data + len);
+    append_u32_be(buf, uint32_t(mz_crc32(MZ_CRC32_INIT, buf.data() + type_pos, len + 4)));
+}
+
+// Rows of the image are filtered and deflated in independent blocks in
+// parallel. Each block but the last one is terminated by a sync flush, so
+// the concatenation of the blocks is a single valid deflate stream.
+static EncodedRaster encode_png_parallel(const void *ptr, size_t w, size_t h,
+                                         size_t num_components,
+                                         PNGCompression compression)
+{
+    static constexpr size_t BlockBytes = 256 * 1024;
+
+    uint8_t color_type = 0;
+    switch (num_components) {
+    case 1: color_type = 0; break; // grayscale
+    case 2: color_type = 4; break; // grayscale + alpha
+    case 3: color_type = 2; break; // RGB
+    case 4: color_type = 6; break; // RGBA
+    default: return EncodedRaster({}, "png");
+    }
+
+    if (w == 0 || h == 0)
+        return EncodedRaster({}, "png");
+
+    auto         img            = static_cast<const uint8_t *>(ptr);
+    const size_t rowbytes       = w * num_components;
+    const size_t rows_per_block = std::max(size_t(1), BlockBytes / (rowbytes + 1));
+    const size_t num_blocks     = (h + rows_per_block - 1) / rows_per_block;
+
+    struct Block {
+        std::vector<uint8_t> deflated;
+        uint32_t             adler = 1;
+        size_t               filtered_len = 0;
+        bool                 ok = false;
+    };
+    std::vector<Block> blocks(num_blocks);
+
+    execution::for_each(ex_tbb, size_t(0), num_blocks,
+        [&](size_t block_idx) {
+            Block &block = blocks[block_idx];
+
+            size_t row_begin = block_idx * rows_per_block;
+            size_t row_end   = std::min(h, row_begin + rows_per_block);
+
+            std::vector<uint8_t> filtered((row_end - row_begin) * (rowbytes + 1));
+            uint8_t *dst = filtered.data();
+            for (size_t r = row_begin; r < row_end; ++r) {
+                const uint8_t *row  = img + r * rowbytes;
+                const uint8_t *prev = r > 0 ? row - rowbytes : nullptr;
+                *dst = filter_row(row, prev, rowbytes, num_components, dst + 1);
+                dst += rowbytes + 1;
+            }
+
+            block.filtered_len = filtered.size();
+            block.adler = adler32_sparse(MZ_ADLER32_INIT, filtered.data(), filtered.size());
+
+            std::unique_ptr<tdefl_compressor, void (*)(tdefl_compressor *)>
+                comp{tdefl_compressor_alloc(), tdefl_compressor_free};
+            if (!comp)
+                return;
+
+            // Raw deflate (negative window bits), either the greedy single
+            // probe fast path of miniz or RLE matches only.
+            mz_uint flags = tdefl_create_comp_flags_from_zip_params(
+                1, -MZ_DEFAULT_WINDOW_BITS,
+                compression == PNGCompression::Compact ? MZ_RLE : MZ_DEFAULT_STRATEGY);
+            block.deflated.reserve(filtered.size() / 8);
+            auto put_buf = [](const void *buf, int len, void *user) -> mz_bool {
+                auto out = static_cast<std::vector<uint8_t> *>(user);
+                auto b   = static_cast<const uint8_t *>(buf);
+                out->insert(out->end(), b, b + len);
+                return MZ_TRUE;
+            };
+
+            if (tdefl_init(comp.get(), put_buf, &block.deflated, int(flags)) != TDEFL_STATUS_OKAY)
+                return;
+
+            tdefl_flush flush = block_idx + 1 == num_blocks ? TDEFL_FINISH : TDEFL_SYNC_FLUSH;
+            tdefl_status st = tdefl_compress_buffer(comp.get(), filtered.data(), filtered.size(), flush);
+            block.ok = st == (flush == TDEFL_FINISH ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+        }, 1);
+
+    size_t   zlib_size = 2 + 4;
+    uint32_t adler     = MZ_ADLER32_INIT;
+    for (const Block &block : blocks) {
+        if (!block.ok)
+            return EncodedRaster({}, "png");
+        zlib_size += block.deflated.size();
+        adler = adler32_combine(adler, block.adler, block.filtered_len);
+    }
+
+    // zlib stream: header (deflate, 32K window), deflate blocks, adler32 of the filtered data.
+    std::vector<uint8_t> zlib;
+    zlib.reserve(zlib_size);
+    zlib.insert(zlib.end(), {0x78, 0x01});
+    for (Block &block : blocks) {
+        zlib.insert(zlib.end(), block.deflated.begin(), block.deflated.end());
+        block.deflated = {};
+    }
+    append_u32_be(zlib, adler);
+
+    static const uint8_t Signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+    std::vector<uint8_t> ihdr;
+    append_u32_be(ihdr, uint32_t(w));
+    append_u32_be(ihdr, uint32_t(h));
+    // bit depth, color type, compression, filter method, interlace
+    ihdr.insert(ihdr.end(), {8, color_type, 0, 0, 0});
+
+    std::vector<uint8_t> buf;
+    buf.reserve(sizeof(Signature) + 3 * 12 + ihdr.size() + zlib.size());
+    buf.insert(buf.end(), std::begin(Signature), std::end(Signature));
+    append_png_chunk(buf, "IHDR", ihdr.data(), ihdr.size());
+    append_png_chunk(buf, "IDAT", zlib.data(), zlib.size());
+    append_png_chunk(buf, "IEND", nullptr, 0);
+
+    return EncodedRaster(std::move(buf), "png");
+}
+
+} // namespace
+
 EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
                                            size_t      num_components)
 {
+    if (compression != PNGCompression::Default)
+        return encode_png_parallel(ptr, w, h, num_components, compression);
+
     std::vector<uint8_t> buf;
     size_t s = 0;
     
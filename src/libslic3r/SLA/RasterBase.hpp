@@ -20,18 +20,19 @@ namespace Slic3r {
 namespace sla {
 
 // Raw byte buffer paired with its size. Suitable for compressed image data.
+// The buffer is immutable, copies of an encoded raster share it.
 class EncodedRaster {
 protected:
-    std::vector<uint8_t> m_buffer;
+    std::shared_ptr<const std::vector<uint8_t>> m_buffer;
     std::string m_ext;
 public:
     EncodedRaster() = default;
     explicit EncodedRaster(std::vector<uint8_t> &&buf, std::string ext)
-        : m_buffer(std::move(buf)), m_ext(std::move(ext))
+        : m_buffer(std::make_shared<const std::vector<uint8_t>>(std::move(buf))), m_ext(std::move(ext))
     {}
     
-    size_t size() const { return m_buffer.size(); }
-    const void * data() const { return m_buffer.data(); }
+    size_t size() const { return m_buffer ? m_buffer->size() : 0; }
+    const void * data() const { return m_buffer ? m_buffer->data() : nullptr; }
     const char * extension() const { return m_ext.c_str(); }
 };
 
@@ -101,7 +102,25 @@ public:
     virtual EncodedRaster encode(RasterEncoder encoder) const = 0;
 };
 
+// Speed / size trade-off of the PNG raster encoding. All of them produce
+// standard 8 bit PNG images.
+enum class PNGCompression {
+    // Single threaded miniz encoder at its default level, no row filtering.
+    Default,
+    // Row filters tuned for masks with large uniform areas, greedy single
+    // probe deflate, row blocks compressed in parallel. Fastest, files are
+    // somewhat larger than with Default.
+    Fast,
+    // Same row filtering and parallel row blocks as Fast, but with RLE only
+    // deflate. Usually smaller files than Default for SLA masks.
+    Compact
+};
 struct PNGRasterEncoder {
+    PNGCompression compression = PNGCompression::Default;
+
+    PNGRasterEncoder() = default;
+    explicit PNGRasterEncoder(PNGCompression c) : compression{c} {}
+
     EncodedRaster operator()(const void *ptr, size_t w, size_t h, size_t num_components);
 };
 
@@ -16,7 +16,9 @@
 #include "libslic3r/PrintConfig.hpp"
 
 #include <libslic3r/Geometry.hpp>
+#include <libslic3r/QuadricEdgeCollapse.hpp>
 
+#include <numeric>
 #include <thread>
 
 namespace Slic3r { namespace sla {
@@ -179,6 +181,132 @@ double get_supportedness_onfloor_score(const TriangleMesh &mesh,
     return S / facecount;
 }
 
+// Meshes with less faces are always evaluated at full resolution.
+constexpr size_t COARSE_FACE_THRESHOLD = 50000;
+
+// Target face count of the decimated proxy mesh.
+constexpr uint32_t PROXY_FACE_COUNT = 20000;
+
+// Number of best coarse candidates evaluated on the full mesh.
+constexpr size_t FINE_CANDIDATES = 8;
+
+// The best full resolution candidate is refined on a local grid of
+// (2 * LOCAL_STEPS + 1)^2 points spanning one coarse grid step around it.
+constexpr int    LOCAL_STEPS = 2;
+constexpr size_t LOCAL_CANDIDATES = (2 * LOCAL_STEPS + 1) * (2 * LOCAL_STEPS + 1) - 1;
+
+// Area weighted histogram of the face normals. The scores depending only on
+// the face normals and areas (misalignment and supportedness without the floor
+// contact) are evaluated on the bins instead of on every face of the mesh.
+// The bins are cells of a cube map, each represented by its area weighted
+// mean normal.
+struct NormalHistogram
+{
+    struct Bin
+    {
+        Vec3f  normal    = Vec3f::Zero();
+        double area      = 0.;
+        double sqrt_area = 0.;
+    };
+
+    std::vector<Bin> bins;
+    size_t           facecount = 0;
+};
+
+NormalHistogram create_normal_histogram(const TriangleMesh &mesh, size_t resolution = 32)
+{
+    const size_t binscount = 6 * resolution * resolution;
+
+    auto binidx = [resolution](const Vec3f &n) {
+        int   axis   = 0;
+        n.cwiseAbs().maxCoeff(&axis);
+        float major  = n[axis];
+        size_t face  = 2 * axis + (major < 0.f ? 1 : 0);
+        float u      = n[(axis + 1) % 3] / std::abs(major);
+        float v      = n[(axis + 2) % 3] / std::abs(major);
+        auto  cell   = [resolution](float c) {
+            return std::min(resolution - 1, size_t(std::max(0.f, (c + 1.f) * .5f * resolution)));
+        };
+        return (face * resolution + cell(u)) * resolution + cell(v);
+    };
+
+    struct Acc { Vec3d normal = Vec3d::Zero(); double area = 0., sqrt_area = 0.; };
+
+    size_t facecount = mesh.its.indices.size();
+    size_t Nthreads  = std::max(size_t(1), size_t(std::thread::hardware_concurrency()));
+    size_t chunksize = facecount / Nthreads + 1;
+    std::vector<std::vector<Acc>> partial(Nthreads);
+
+    execution::for_each(ex_tbb, size_t(0), Nthreads, [&](size_t chunk) {
+        std::vector<Acc> &acc = partial[chunk];
+        acc.assign(binscount, Acc{});
+        size_t to = std::min(facecount, (chunk + 1) * chunksize);
+        for (size_t fi = chunk * chunksize; fi < to; ++fi) {
+            Facestats fc{get_triangle_vertices(mesh, fi)};
+            if (!fc.normal.allFinite())
+                continue;
+            Acc &a = acc[binidx(fc.normal)];
+            a.normal += fc.area * fc.normal.cast<double>();
+            a.area += fc.area;
+            a.sqrt_area += std::sqrt(fc.area);
+        }
+    }, 1);
+
+    NormalHistogram ret;
+    ret.facecount = facecount;
+    for (size_t b = 0; b < binscount; ++b) {
+        Acc sum;
+        for (const std::vector<Acc> &acc : partial) {
+            sum.normal += acc[b].normal;
+            sum.area += acc[b].area;
+            sum.sqrt_area += acc[b].sqrt_area;
+        }
+        if (sum.area > 0. && sum.normal.squaredNorm() > 0.)
+            ret.bins.push_back({sum.normal.normalized().cast<float>(), sum.area, sum.sqrt_area});
+    }
+
+    return ret;
+}
+
+// Histogram variant of get_misalginment_score()
+double get_misalginment_score(const NormalHistogram &hist, const Transform3f &tr)
+{
+    if (hist.facecount == 0) return NaNd;
+
+    double S = 0.;
+    for (const NormalHistogram::Bin &bin : hist.bins) {
+        Vec3f n = tr.linear() * bin.normal;
+        S += bin.area * (std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z()));
+    }
+
+    return S / hist.facecount;
+}
+
+// Histogram variant of get_supportedness_score()
+double get_supportedness_score(const NormalHistogram &hist, const Transform3f &tr)
+{
+    if (hist.facecount == 0) return NaNd;
+
+    double S = 0.;
+    for (const NormalHistogram::Bin &bin : hist.bins) {
+        float cosphi = std::clamp((tr.linear() * bin.normal).dot(DOWN), -1.f, 1.f);
+        float phi    = 1.f - std::acos(cosphi) / float(PI);
+        S += bin.sqrt_area * POINTS_PER_UNIT_AREA * phi * phi * phi;
+    }
+
+    return S / hist.facecount;
+}
+
+// Decimated copy of the mesh used to rank candidate rotations with the
+// scores depending on the mesh geometry (floor contact).
+TriangleMesh create_proxy_mesh(const TriangleMesh &mesh)
+{
+    indexed_triangle_set its = mesh.its;
+    its_quadric_edge_collapse(its, PROXY_FACE_COUNT);
+
+    return TriangleMesh{std::move(its)};
+}
+
 using XYRotation = std::array<double, 2>;
 
 // prepare the rotation transformation
@@ -284,6 +412,86 @@ std::array<double, N> find_min_score(Fn &&fn, It from, It to, StopCond &&stopfn)
     return ret;
 }
 
+// Evaluate coarsefn for each input and return the inputs ordered from the
+// best to the worst score, at most max_count of them.
+template<class Fn, class It, class StopCond>
+std::vector<XYRotation> rank_scores(Fn &&fn, It from, It to, size_t max_count, StopCond &&stopfn)
+{
+    size_t dist = std::distance(from, to);
+    std::vector<double> scores(dist, std::numeric_limits<double>::max());
+
+    execution::for_each(
+        ex_tbb, size_t(0), dist, [&stopfn, &scores, &fn, &from](size_t i) {
+            if (stopfn()) return;
+
+            scores[i] = fn(*(from + i));
+        });
+
+    std::vector<size_t> order(dist);
+    std::iota(order.begin(), order.end(), size_t(0));
+    max_count = std::min(max_count, dist);
+    std::partial_sort(order.begin(), order.begin() + max_count, order.end(),
+                      [&scores](size_t a, size_t b) { return scores[a] < scores[b]; });
+
+    auto ret = reserve_vector<XYRotation>(max_count);
+    for (size_t i = 0; i < max_count; ++i)
+        ret.emplace_back(*(from + order[i]));
+
+    return ret;
+}
+
+// Coarse to fine variant of the brute force grid search over the X and Y
+// rotations in <-PI, PI>. The whole grid is ranked by the cheap coarsefn,
+// the best candidates are evaluated by finefn on the full mesh and the best
+// of them is refined by finefn on a local grid spanning one grid step around
+// it. Both functions are minimized.
+template<class CoarseFn, class FineFn, class StatusFn, class StopCond>
+XYRotation find_min_score_coarse_to_fine(size_t     gridsize,
+                                         CoarseFn &&coarsefn,
+                                         FineFn   &&finefn,
+                                         StatusFn &&statusfn,
+                                         StopCond &&stopfn)
+{
+    gridsize = std::max(gridsize, size_t(2));
+    const double step = 2. * PI / (gridsize - 1);
+
+    auto grid = reserve_vector<XYRotation>(gridsize * gridsize);
+    for (size_t iy = 0; iy < gridsize; ++iy)
+        for (size_t ix = 0; ix < gridsize; ++ix)
+            grid.push_back({-PI + ix * step, -PI + iy * step});
+
+    std::vector<XYRotation> candidates =
+        rank_scores(coarsefn, grid.begin(), grid.end(), FINE_CANDIDATES, stopfn);
+
+    // Placeholders for the local grid around the best full resolution candidate.
+    candidates.resize(candidates.size() + LOCAL_CANDIDATES);
+
+    // Identity if the search is stopped before the first evaluation or all the scores are NaN.
+    XYRotation best       = {0., 0.};
+    double     best_score = std::numeric_limits<double>::max();
+    size_t     ncoarse    = std::min(FINE_CANDIDATES, grid.size());
+    for (size_t i = 0; i < candidates.size() && !stopfn(); ++i) {
+        if (i == ncoarse) {
+            // All coarse candidates have been evaluated, generate the local grid.
+            size_t k = ncoarse;
+            for (int iy = -LOCAL_STEPS; iy <= LOCAL_STEPS; ++iy)
+                for (int ix = -LOCAL_STEPS; ix <= LOCAL_STEPS; ++ix)
+                    if (ix != 0 || iy != 0)
+                        candidates[k++] = {best[0] + ix * step / LOCAL_STEPS,
+                                           best[1] + iy * step / LOCAL_STEPS};
+        }
+
+        statusfn();
+        double score = finefn(candidates[i]);
+        if (score < best_score) {
+            best_score = score;
+            best       = candidates[i];
+        }
+    }
+
+    return best;
+}
+
 } // namespace
 
 
@@ -328,6 +536,12 @@ struct RotfinderBoilerplate {
     }
 
     bool stopcond() { return ! params.statuscb()(-1); }
+
+    // Is the mesh big enough to be searched at a coarse resolution first?
+    bool use_coarse_search() const
+    {
+        return params.multi_resolution() && mesh.its.indices.size() > COARSE_FACE_THRESHOLD;
+    }
 };
 
 Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
@@ -337,6 +551,27 @@ Vec2d find_best_misalignment_rotation(const ModelObject &      mo,
 
     // Preparing the optimizer.
     size_t gridsize = std::sqrt(bp.max_tries);
+
+    if (bp.use_coarse_search()) {
+        NormalHistogram hist = create_normal_histogram(bp.mesh);
+
+        // The candidate evaluations are the only lengthy part.
+        bp.max_tries = FINE_CANDIDATES + LOCAL_CANDIDATES;
+
+        // The score is maximized, the search minimizes.
+        XYRotation rot = find_min_score_coarse_to_fine(
+            gridsize,
+            [&hist](const XYRotation &rot) {
+                return -get_misalginment_score(hist, to_transform3f(rot));
+            },
+            [&bp](const XYRotation &rot) {
+                return -get_misalginment_score(bp.mesh, to_transform3f(rot));
+            },
+            [&bp] { bp.statusfn(); }, [&bp] { return bp.stopcond(); });
+
+        return {rot[0], rot[1]};
+    }
+
     opt::Optimizer<opt::AlgBruteForce> solver(
         opt::StopCriteria{}.max_iterations(bp.max_tries)
                            .stop_condition([&bp] { return bp.stopcond(); }),
@@ -380,6 +615,18 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
         // If the model can be placed on the bed directly, we only need to
         // check the 3D convex hull face rotations.
 
+        if (bp.use_coarse_search()) {
+            // Rank the rotations on a decimated mesh, evaluate only the best
+            // ones at full resolution.
+            TriangleMesh proxy = create_proxy_mesh(bp.mesh);
+            inputs = rank_scores([&proxy](const XYRotation &rot) {
+                return get_supportedness_onfloor_score(proxy, to_transform3f(rot));
+            }, inputs.begin(), inputs.end(), FINE_CANDIDATES, [&bp] {
+                return bp.stopcond();
+            });
+            bp.max_tries = inputs.size();
+        }
+
         auto objfn = [&bp](const XYRotation &rot) {
             bp.statusfn();
             Transform3f tr = to_transform3f(rot);
@@ -390,6 +637,21 @@ Vec2d find_least_supports_rotation(const ModelObject &      mo,
             return bp.stopcond();
         });
 
+    } else if (bp.use_coarse_search()) {
+        NormalHistogram hist = create_normal_histogram(bp.mesh);
+        size_t gridsize = std::sqrt(bp.max_tries);
+        bp.max_tries = FINE_CANDIDATES + LOCAL_CANDIDATES;
+
+        rot = find_min_score_coarse_to_fine(
+            gridsize,
+            [&hist](const XYRotation &rot) {
+                return get_supportedness_score(hist, to_transform3f(rot));
+            },
+            [&bp](const XYRotation &rot) {
+                return get_supportedness_score(bp.mesh, to_transform3f(rot));
+            },
+            [&bp] { bp.statusfn(); }, [&bp] { return bp.stopcond(); });
+
     } else {
         // Preparing the optimizer.
         size_t gridsize = std::sqrt(bp.max_tries); // 2D grid has gridsize^2 calls
@@ -23,12 +23,19 @@ using RotOptimizeStatusCB = std::function<bool(int)>;
 
 class RotOptimizeParams {
     float m_accuracy = 1.;
+    bool  m_multi_resolution = true;
     const DynamicPrintConfig *m_print_config = nullptr;
     RotOptimizeStatusCB m_statuscb = [](int) { return true; };
 
 public:
 
     RotOptimizeParams &accuracy(float a) { m_accuracy = a; return *this; }
+
+    // For big meshes, search on a coarse representation of the mesh (normal
+    // histogram or decimated proxy) first and evaluate only the best
+    // candidates on the full resolution mesh. Disabling it evaluates every
+    // candidate rotation on the full mesh.
+    RotOptimizeParams &multi_resolution(bool m) { m_multi_resolution = m; return *this; }
     RotOptimizeParams &print_config(const DynamicPrintConfig *c)
     {
         m_print_config = c;
@@ -41,6 +48,7 @@ public:
     }
 
     float accuracy() const { return m_accuracy; }
+    bool  multi_resolution() const { return m_multi_resolution; }
     const DynamicPrintConfig * print_config() const { return m_print_config; }
     const RotOptimizeStatusCB &statuscb() const { return m_statuscb; }
 };
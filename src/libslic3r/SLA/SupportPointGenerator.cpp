@@ -17,6 +17,8 @@
 #include "libslic3r.h"
 
 #include <iostream>
+#include <mutex>
+#include <numeric>
 #include <random>
 
 namespace Slic3r {
@@ -115,6 +117,51 @@ void SupportPointGenerator::project_onto_mesh(std::vector<sla::SupportPoint>& po
     }, gransize);
 }
 
+// Calls fn(i, j) for the pairs of bounding boxes a[i], b[j] which overlap.
+// Both sets are swept along the x axis, so only the boxes overlapping in x
+// are tested against each other.
+template<class Fn>
+static void for_each_overlapping_pair(const std::vector<BoundingBox> &a,
+                                      const std::vector<BoundingBox> &b,
+                                      Fn &&fn)
+{
+    // Index into b is offset by the size of a.
+    auto events = reserve_vector<std::pair<coord_t, size_t>>(a.size() + b.size());
+    for (size_t i = 0; i < a.size(); ++ i)
+        events.emplace_back(a[i].min.x(), i);
+    for (size_t i = 0; i < b.size(); ++ i)
+        events.emplace_back(b[i].min.x(), a.size() + i);
+    std::sort(events.begin(), events.end());
+
+    std::vector<size_t> active[2];
+    for (const auto &[x, id] : events) {
+        const bool                      in_b   = id >= a.size();
+        const size_t                    idx    = in_b ? id - a.size() : id;
+        const BoundingBox              &bbox   = in_b ? b[idx] : a[idx];
+        const std::vector<BoundingBox> &others = in_b ? a : b;
+        std::vector<size_t>            &other_active = active[! in_b];
+        other_active.erase(std::remove_if(other_active.begin(), other_active.end(),
+                                          [&others, x = x](size_t j) { return others[j].max.x() < x; }),
+                           other_active.end());
+        for (size_t j : other_active)
+            if (bbox.min.y() <= others[j].max.y() && others[j].min.y() <= bbox.max.y()) {
+                if (in_b)
+                    fn(j, idx);
+                else
+                    fn(idx, j);
+            }
+        active[in_b].emplace_back(idx);
+    }
+}
+
+static std::vector<BoundingBox> island_bboxes(const SupportPointGenerator::MyLayer &layer, coord_t inflate = 0)
+{
+    auto out = reserve_vector<BoundingBox>(layer.islands.size());
+    for (const SupportPointGenerator::Structure &island : layer.islands)
+        out.emplace_back(island.bbox.inflated(inflate));
+    return out;
+}
+
 static std::vector<SupportPointGenerator::MyLayer> make_layers(
     const std::vector<ExPolygons>& slices, const std::vector<float>& heights,
     std::function<void(void)> throw_on_cancel)
@@ -155,9 +202,16 @@ static std::vector<SupportPointGenerator::MyLayer> make_layers(
         }
     }, 32 /*gransize*/);
 
+    std::vector<std::vector<BoundingBox>> bboxes(layers.size());
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&layers, &bboxes](size_t layer_id) {
+        bboxes[layer_id] = island_bboxes(layers[layer_id]);
+    }, 32 /*gransize*/);
+
     // Calculate overlap of successive layers. Link overlapping islands.
+    // Each task only writes the islands_below links of its top layer,
+    // islands_above are filled in from them in the following pass.
     execution::for_each(ex_tbb, size_t(1), layers.size(),
-                      [&layers, &heights, throw_on_cancel] (size_t layer_id)
+                      [&layers, &heights, &bboxes, throw_on_cancel] (size_t layer_id)
     {
       if ((layer_id % 2) == 0)
           // Don't call the following function too often as it flushes CPU write caches due to synchronization primitves.
@@ -170,15 +224,20 @@ static std::vector<SupportPointGenerator::MyLayer> make_layers(
       const coordf_t between_layers_offset = scale_d(layer_height * std::tan(safe_angle));
       const float slope_angle = 75.f * (float(M_PI)/180.f); // smaller number - less supports
       const coordf_t slope_offset = scale_d(layer_height * std::tan(slope_angle));
-      //FIXME This has a quadratic time complexity, it will be excessively slow for many tiny islands.
+      // Only the islands with overlapping bounding boxes are intersected,
+      // in the order of the top and the bottom islands.
+      std::vector<std::pair<size_t, size_t>> candidates;
+      for_each_overlapping_pair(bboxes[layer_id], bboxes[layer_id - 1],
+                                [&candidates](size_t top, size_t bottom) { candidates.emplace_back(top, bottom); });
+      std::sort(candidates.begin(), candidates.end());
+      for (const auto &[top_idx, bottom_idx] : candidates) {
+          SupportPointGenerator::Structure &top    = layer_above.islands[top_idx];
+          SupportPointGenerator::Structure &bottom = layer_below.islands[bottom_idx];
+          float overlap_area = top.overlap_area(bottom);
+          if (overlap_area > 0)
+              top.islands_below.emplace_back(&bottom, overlap_area);
+      }
       for (SupportPointGenerator::Structure &top : layer_above.islands) {
-          for (SupportPointGenerator::Structure &bottom : layer_below.islands) {
-              float overlap_area = top.overlap_area(bottom);
-              if (overlap_area > 0) {
-                  top.islands_below.emplace_back(&bottom, overlap_area);
-                  bottom.islands_above.emplace_back(&top, overlap_area);
-              }
-          }
           if (! top.islands_below.empty()) {
               Polygons bottom_polygons = top.polygons_below();
               top.overhangs = diff_ex(*top.polygon, bottom_polygons);
@@ -222,9 +281,108 @@ static std::vector<SupportPointGenerator::MyLayer> make_layers(
             }
     }, 8 /* gransize */);
 
+    execution::for_each(ex_tbb, size_t(1), layers.size(), [&layers](size_t layer_id) {
+        for (SupportPointGenerator::Structure &top : layers[layer_id].islands)
+            for (const SupportPointGenerator::Structure::Link &below : top.islands_below)
+                below.island->islands_above.emplace_back(&top, below.overlap_area);
+    }, 32 /*gransize*/);
+
     return layers;
 }
 
+// The largest distance at which a support point may refuse a sample in
+// uniformly_cover(), the Poisson radius is only decreased from there.
+static float max_poisson_radius(const SupportPointGenerator::Config &config)
+{
+    const float density_horizontal = config.tear_pressure() / config.support_force();
+    //FIXME why?
+    return std::max(config.minimal_distance, 1.f / (5.f * density_horizontal));
+}
+
+static size_t find_root(std::vector<size_t> &parents, size_t idx)
+{
+    while (parents[idx] != idx)
+        idx = parents[idx] = parents[parents[idx]];
+    return idx;
+}
+
+// Split the islands into chains, which may be covered with support points
+// independently: an island is in the same chain as the islands it is linked
+// to and as all the islands, whose support points could be closer to its own
+// than the spacing radius.
+static std::vector<SupportPointGenerator::IslandChain> make_island_chains(
+    std::vector<SupportPointGenerator::MyLayer> &layers, float radius,
+    std::function<void(void)> throw_on_cancel)
+{
+    using Structure = SupportPointGenerator::Structure;
+
+    std::vector<size_t> first_island(layers.size() + 1, 0);
+    for (size_t i = 0; i < layers.size(); ++ i)
+        first_island[i + 1] = first_island[i] + layers[i].islands.size();
+
+    auto island_idx = [&layers, &first_island](const Structure &s) {
+        return first_island[s.layer->layer_id] + size_t(&s - layers[s.layer->layer_id].islands.data());
+    };
+
+    // Support points lie in the bounding boxes of their islands, thus only
+    // the islands with bounding boxes closer than radius and layers closer
+    // than radius may affect each other.
+    std::vector<std::vector<BoundingBox>> bboxes(layers.size()), bboxes_inflated(layers.size());
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&](size_t layer_id) {
+        bboxes[layer_id]          = island_bboxes(layers[layer_id]);
+        bboxes_inflated[layer_id] = island_bboxes(layers[layer_id], scaled(radius));
+    }, 32 /*gransize*/);
+
+    std::vector<std::vector<std::pair<size_t, size_t>>> edges(layers.size());
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&](size_t layer_id) {
+        if ((layer_id % 8) == 0)
+            throw_on_cancel();
+
+        const SupportPointGenerator::MyLayer &layer = layers[layer_id];
+        for (const Structure &s : layer.islands)
+            for (const Structure::Link &below : s.islands_below)
+                edges[layer_id].emplace_back(island_idx(s), island_idx(*below.island));
+
+        for (size_t below_id = layer_id + 1; below_id -- > 0;) {
+            if (layer.print_z - layers[below_id].print_z >= radius)
+                break;
+            for_each_overlapping_pair(bboxes_inflated[layer_id], bboxes[below_id],
+                                      [&](size_t i, size_t j) {
+                                          if (below_id != layer_id || i < j)
+                                              edges[layer_id].emplace_back(first_island[layer_id] + i,
+                                                                           first_island[below_id] + j);
+                                      });
+        }
+    }, 8 /*gransize*/);
+
+    std::vector<size_t> parents(first_island.back());
+    std::iota(parents.begin(), parents.end(), size_t(0));
+    // Groups of the islands of a layer, joined by the edges inside the layer only.
+    std::vector<size_t> layer_parents = parents;
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id)
+        for (const auto &[a, b] : edges[layer_id]) {
+            parents[find_root(parents, a)] = find_root(parents, b);
+            if (b >= first_island[layer_id])
+                layer_parents[find_root(layer_parents, a)] = find_root(layer_parents, b);
+        }
+
+    // Chains are ordered by their lowest island.
+    std::vector<SupportPointGenerator::IslandChain> chains;
+    std::vector<size_t> chain_of_root(parents.size(), std::numeric_limits<size_t>::max());
+    for (SupportPointGenerator::MyLayer &layer : layers)
+        for (Structure &s : layer.islands) {
+            size_t &chain_idx = chain_of_root[find_root(parents, island_idx(s))];
+            if (chain_idx == std::numeric_limits<size_t>::max()) {
+                chain_idx = chains.size();
+                chains.emplace_back();
+            }
+            chains[chain_idx].islands.emplace_back(&s);
+            chains[chain_idx].layer_groups.emplace_back(find_root(layer_parents, island_idx(s)));
+        }
+
+    return chains;
+}
+
 void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const std::vector<float>& heights)
 {
 #ifdef SLA_SUPPORTPOINTGEN_DEBUG
@@ -232,70 +390,129 @@ void SupportPointGenerator::process(const std::vector<ExPolygons>& slices, const
 #endif /* SLA_SUPPORTPOINTGEN_DEBUG */
 
     std::vector<SupportPointGenerator::MyLayer> layers = make_layers(slices, heights, m_throw_on_cancel);
+    std::vector<IslandChain> chains = make_island_chains(layers, max_poisson_radius(m_config), m_throw_on_cancel);
+
+    size_t islands_cnt = 0;
+    for (IslandChain &chain : chains) {
+        // Seeded in the order of the chains and of their islands, so the support points
+        // only depend on the seed, not on the order the islands are processed in.
+        chain.seeds.reserve(chain.islands.size());
+        for (size_t i = 0; i < chain.islands.size(); ++ i)
+            chain.seeds.emplace_back(m_rng());
+        chain.grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+        islands_cnt += chain.islands.size();
+    }
 
-    PointGrid3D point_grid;
-    point_grid.cell_size = Vec3f(10.f, 10.f, 10.f);
+    std::mutex status_mutex;
+    size_t     islands_done = 0;
+    auto       report_islands_done = [this, &status_mutex, &islands_done, islands_cnt](size_t cnt) {
+        std::lock_guard lk(status_mutex);
+        islands_done += cnt;
+        m_statusfn(int(std::round(100. * islands_done / islands_cnt)));
+    };
 
-    double increment = 100.0 / layers.size();
-    double status    = 0;
+    execution::for_each(ex_tbb, size_t(0), chains.size(), [this, &chains, &report_islands_done](size_t chain_idx) {
+        process_chain(chains[chain_idx], report_islands_done);
+    });
 
-    for (unsigned int layer_id = 0; layer_id < layers.size(); ++ layer_id) {
-        SupportPointGenerator::MyLayer *layer_top     = &layers[layer_id];
-        SupportPointGenerator::MyLayer *layer_bottom  = (layer_id > 0) ? &layers[layer_id - 1] : nullptr;
-        std::vector<float>        support_force_bottom;
-        if (layer_bottom != nullptr) {
-            support_force_bottom.assign(layer_bottom->islands.size(), 0.f);
-            for (size_t i = 0; i < layer_bottom->islands.size(); ++ i)
-                support_force_bottom[i] = layer_bottom->islands[i].supports_force_total();
-        }
-        for (Structure &top : layer_top->islands)
+    for (IslandChain &chain : chains)
+        append(m_output, std::move(chain.points));
+}
+
+void SupportPointGenerator::process_chain(IslandChain &chain, const std::function<void(size_t)> &islands_done)
+{
+    // The islands of the chain are processed layer by layer from the bottom,
+    // with the support force propagated from the islands of the layer below.
+    auto below_begin = chain.islands.begin();
+    auto below_end   = below_begin;
+    for (auto top_begin = chain.islands.begin(); top_begin != chain.islands.end();) {
+        MyLayer *layer_top = (*top_begin)->layer;
+        auto     top_end   = std::find_if(top_begin, chain.islands.end(),
+                                          [layer_top](const Structure *s) { return s->layer != layer_top; });
+        if (below_begin == below_end || (*below_begin)->layer->layer_id + 1 != layer_top->layer_id)
+            // The chain has no islands in the layer below.
+            below_begin = below_end = top_begin;
+
+        std::vector<float> support_force_bottom;
+        support_force_bottom.reserve(below_end - below_begin);
+        for (auto it = below_begin; it != below_end; ++ it)
+            support_force_bottom.emplace_back((*it)->supports_force_total());
+        for (auto it = top_begin; it != top_end; ++ it) {
+            Structure &top = **it;
             for (Structure::Link &bottom_link : top.islands_below) {
                 Structure &bottom = *bottom_link.island;
                 //float centroids_dist = (bottom.centroid - top.centroid).norm();
                 // Penalization resulting from centroid offset:
 //                  bottom.supports_force *= std::min(1.f, 1.f - std::min(1.f, (1600.f * layer_height) * centroids_dist * centroids_dist / bottom.area));
-                float &support_force = support_force_bottom[&bottom - layer_bottom->islands.data()];
+                float &support_force = support_force_bottom[std::lower_bound(below_begin, below_end, &bottom) - below_begin];
 //FIXME this condition does not reflect a bifurcation into a one large island and one tiny island well, it incorrectly resets the support force to zero.
 // One should rather work with the overlap area vs overhang area.
 //                support_force *= std::min(1.f, 1.f - std::min(1.f, 0.1f * centroids_dist * centroids_dist / bottom.area));
                 // Penalization resulting from increasing polygon area:
                 support_force *= std::min(1.f, 20.f * bottom.area / top.area);
             }
+        }
         // Let's assign proper support force to each of them:
-        if (layer_id > 0) {
-            for (Structure &below : layer_bottom->islands) {
-                float below_support_force = support_force_bottom[&below - layer_bottom->islands.data()];
-                float above_overlap_area = 0.f;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_overlap_area += above_link.overlap_area;
-                for (Structure::Link &above_link : below.islands_above)
-                    above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
-            }
+        for (auto it = below_begin; it != below_end; ++ it) {
+            Structure &below = **it;
+            float below_support_force = support_force_bottom[it - below_begin];
+            float above_overlap_area = 0.f;
+            for (Structure::Link &above_link : below.islands_above)
+                above_overlap_area += above_link.overlap_area;
+            for (Structure::Link &above_link : below.islands_above)
+                above_link.island->supports_force_inherited += below_support_force * above_link.overlap_area / above_overlap_area;
         }
         // Now iterate over all polygons and append new points if needed.
-        for (Structure &s : layer_top->islands) {
-            // Penalization resulting from large diff from the last layer:
-            s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
-
-            add_support_points(s, point_grid);
+        // The support points of an island may only refuse the samples of the islands in its group,
+        // thus the groups are covered in parallel. The groups are ordered by their first island.
+        std::vector<std::pair<size_t, size_t>> group_islands;
+        group_islands.reserve(top_end - top_begin);
+        for (auto it = top_begin; it != top_end; ++ it) {
+            size_t island_id = it - chain.islands.begin();
+            group_islands.emplace_back(chain.layer_groups[island_id], island_id);
+        }
+        std::sort(group_islands.begin(), group_islands.end());
+        std::vector<IslandGroup> groups;
+        for (size_t i = 0; i < group_islands.size(); ++ i) {
+            if (i == 0 || group_islands[i].first != group_islands[i - 1].first) {
+                groups.emplace_back();
+                groups.back().grid_below     = &chain.grid;
+                groups.back().grid.cell_size = chain.grid.cell_size;
+            }
+            groups.back().islands.emplace_back(group_islands[i].second);
+        }
+        std::sort(groups.begin(), groups.end(), [](const IslandGroup &l, const IslandGroup &r) { return l.islands.front() < r.islands.front(); });
+        auto cover_group = [this, &chain](IslandGroup &group) {
+            for (size_t island_id : group.islands) {
+                Structure &s = *chain.islands[island_id];
+                // Penalization resulting from large diff from the last layer:
+                s.supports_force_inherited /= std::max(1.f, 0.17f * (s.overhangs_area) / s.area);
+
+                group.rng.seed(chain.seeds[island_id]);
+                add_support_points(s, group);
+            }
+        };
+        if (groups.size() == 1)
+            cover_group(groups.front());
+        else
+            execution::for_each(ex_tbb, size_t(0), groups.size(), [&groups, &cover_group](size_t group_idx) {
+                cover_group(groups[group_idx]);
+            });
+        for (IslandGroup &group : groups) {
+            append(chain.points, std::move(group.points));
+            chain.grid.grid.insert(group.grid.grid.begin(), group.grid.grid.end());
         }
 
         m_throw_on_cancel();
+        islands_done(top_end - top_begin);
 
-        status += increment;
-        m_statusfn(int(std::round(status)));
-
-#ifdef SLA_SUPPORTPOINTGEN_DEBUG
-        /*std::string layer_num_str = std::string((i<10 ? "0" : "")) + std::string((i<100 ? "0" : "")) + std::to_string(i);
-        output_expolygons(expolys_top, "top" + layer_num_str + ".svg");
-        output_expolygons(diff, "diff" + layer_num_str + ".svg");
-        if (!islands.empty())
-            output_expolygons(islands, "islands" + layer_num_str + ".svg");*/
-#endif /* SLA_SUPPORTPOINTGEN_DEBUG */
+        below_begin = top_begin;
+        below_end   = top_end;
+        top_begin   = top_end;
     }
 }
 
-void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::PointGrid3D &grid3d)
+void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure &s, SupportPointGenerator::IslandGroup &group)
 {
     // Select each type of surface (overrhang, dangling, slope), derive the support
     // force deficit for it and call uniformly conver with the right params
@@ -306,12 +523,12 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
     if (s.islands_below.empty()) {
         // completely new island - needs support no doubt
         // deficit is full, there is nothing below that would hold this island
-        uniformly_cover({ *s.polygon }, s, s.area * tp, grid3d, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
+        uniformly_cover({ *s.polygon }, s, s.area * tp, group, IslandCoverageFlags(icfIsNew | icfWithBoundary) );
         return;
     }
 
     if (! s.overhangs.empty()) {
-        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, grid3d);
+        uniformly_cover(s.overhangs, s, s.overhangs_area * tp, group);
     }
 
     auto areafn = [](double sum, auto &p) { return sum + p.area() * SCALING_FACTOR * SCALING_FACTOR; };
@@ -322,13 +539,13 @@ void SupportPointGenerator::add_support_points(SupportPointGenerator::Structure
         // What we now have in polygons needs support, regardless of what the forces are, so we can add them.
 
         double a = std::accumulate(s.dangling_areas.begin(), s.dangling_areas.end(), 0., areafn);
-        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.dangling_areas, s, a * tp - a * current * s.area, group, icfWithBoundary);
     }
 
     current = s.supports_force_total();
     if (! s.overhangs_slopes.empty()) {
         double a = std::accumulate(s.overhangs_slopes.begin(), s.overhangs_slopes.end(), 0., areafn);
-        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, grid3d, icfWithBoundary);
+        uniformly_cover(s.overhangs_slopes, s, a * tp - a * current / s.area, group, icfWithBoundary);
     }
 }
 
@@ -543,7 +760,7 @@ static inline std::vector<Vec2f> poisson_disk_from_samples(const std::vector<Vec
 }
 
 
-void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags)
+void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, IslandGroup &group, IslandCoverageFlags flags)
 {
     //int num_of_points = std::max(1, (int)((island.area()*pow(SCALING_FACTOR, 2) * m_config.tear_pressure)/m_config.support_force));
 
@@ -567,9 +784,7 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     // Number of newly added points.
     const size_t poisson_samples_target = size_t(ceil(support_force_deficit / m_config.support_force()));
 
-    const float density_horizontal = m_config.tear_pressure() / m_config.support_force();
-    //FIXME why?
-    float poisson_radius		= std::max(m_config.minimal_distance, 1.f / (5.f * density_horizontal));
+    float poisson_radius		= max_poisson_radius(m_config);
 //    const float poisson_radius     = 1.f / (15.f * density_horizontal);
     const float samples_per_mm2 = 30.f / (float(M_PI) * poisson_radius * poisson_radius);
     // Minimum distance between samples, in 3D space.
@@ -581,14 +796,15 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
     std::vector<Vec2f> raw_samples =
         flags & icfWithBoundary ?
             sample_expolygon_with_boundary(islands, samples_per_mm2,
-                                           5.f / poisson_radius, m_rng) :
-            sample_expolygon(islands, samples_per_mm2, m_rng);
+                                           5.f / poisson_radius, group.rng) :
+            sample_expolygon(islands, samples_per_mm2, group.rng);
 
     std::vector<Vec2f>  poisson_samples;
     for (size_t iter = 0; iter < 4; ++ iter) {
         poisson_samples = poisson_disk_from_samples(raw_samples, poisson_radius,
-            [&structure, &grid3d, min_spacing](const Vec2f &pos) {
-                return grid3d.collides_with(pos, structure.layer->print_z, min_spacing);
+            [&structure, &group, min_spacing](const Vec2f &pos) {
+                return group.grid_below->collides_with(pos, structure.layer->print_z, min_spacing) ||
+                       group.grid.collides_with(pos, structure.layer->print_z, min_spacing);
             });
         if (poisson_samples.size() >= poisson_samples_target || m_config.minimal_distance > poisson_radius-EPSILON)
             break;
@@ -614,13 +830,13 @@ void SupportPointGenerator::uniformly_cover(const ExPolygons& islands, Structure
 
 //    assert(! poisson_samples.empty());
     if (poisson_samples_target < poisson_samples.size()) {
-        std::shuffle(poisson_samples.begin(), poisson_samples.end(), m_rng);
+        std::shuffle(poisson_samples.begin(), poisson_samples.end(), group.rng);
         poisson_samples.erase(poisson_samples.begin() + poisson_samples_target, poisson_samples.end());
     }
     for (const Vec2f &pt : poisson_samples) {
-        m_output.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
+        group.points.emplace_back(float(pt(0)), float(pt(1)), structure.zlevel, m_config.head_diameter/2.f, flags & icfIsNew);
         structure.supports_force_this_layer += m_config.support_force();
-        grid3d.insert(pt, &structure);
+        group.grid.insert(pt, &structure);
     }
 }
 
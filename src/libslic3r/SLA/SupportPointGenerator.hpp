@@ -151,7 +151,7 @@ public:
         Vec3f   cell_size;
         Grid    grid;
         
-        Vec3i32 cell_id(const Vec3f &pos) {
+        Vec3i32 cell_id(const Vec3f &pos) const {
             return Vec3i32(int(floor(pos.x() / cell_size.x())),
                          int(floor(pos.y() / cell_size.y())),
                          int(floor(pos.z() / cell_size.z())));
@@ -164,7 +164,7 @@ public:
             grid.emplace(cell_id(pt.position), pt);
         }
         
-        bool collides_with(const Vec2f &pos, float print_z, float radius) {
+        bool collides_with(const Vec2f &pos, float print_z, float radius) const {
             Vec3f pos3d(pos.x(), pos.y(), print_z);
             Vec3i32 cell = cell_id(pos3d);
             std::pair<Grid::const_iterator, Grid::const_iterator> it_pair = grid.equal_range(cell);
@@ -183,7 +183,7 @@ public:
         }
         
     private:
-        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) {
+        bool collides_with(const Vec3f &pos, float radius, Grid::const_iterator it_begin, Grid::const_iterator it_end) const {
             for (Grid::const_iterator it = it_begin; it != it_end; ++ it) {
                 float dist2 = (it->second.position - pos).squaredNorm();
                 if (dist2 < radius * radius)
@@ -193,6 +193,35 @@ public:
         }
     };
     
+    // Islands connected through the layers or lying closer to each other
+    // than the minimal spacing of the support points. Each chain is covered
+    // with support points independently of the others.
+    struct IslandChain {
+        // Sorted by layer and by the index of the island in the layer.
+        std::vector<Structure*>   islands;
+        // Parallel to islands: Islands of a layer with the same group are closer
+        // to each other than the minimal spacing of the support points.
+        std::vector<size_t>       layer_groups;
+        // Parallel to islands: Seeds of the random generator, drawn from
+        // the generator of SupportPointGenerator.
+        std::vector<std::mt19937::result_type> seeds;
+        PointGrid3D               grid;
+        std::vector<SupportPoint> points;
+    };
+
+    // Islands of a single layer of a chain with the same layer group. The groups
+    // of a layer are covered with support points in parallel.
+    struct IslandGroup {
+        // Indices of the islands in IslandChain::islands.
+        std::vector<size_t>       islands;
+        std::mt19937              rng;
+        // Support points of the layers below, read only.
+        const PointGrid3D        *grid_below;
+        // Support points added to the islands of this group.
+        PointGrid3D               grid;
+        std::vector<SupportPoint> points;
+    };
+
     void execute(const std::vector<ExPolygons> &slices,
                  const std::vector<float> &     heights);
     
@@ -209,9 +238,11 @@ public:
 
 private:
 
-    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, PointGrid3D &grid3d, IslandCoverageFlags flags = icfNone);
+    void process_chain(IslandChain &chain, const std::function<void(size_t)> &islands_done);
+
+    void uniformly_cover(const ExPolygons& islands, Structure& structure, float deficit, IslandGroup &group, IslandCoverageFlags flags = icfNone);
 
-    void add_support_points(Structure& structure, PointGrid3D &grid3d);
+    void add_support_points(Structure& structure, IslandGroup &group);
 
     void project_onto_mesh(std::vector<SupportPoint>& points) const;
 
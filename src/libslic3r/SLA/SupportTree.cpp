@@ -12,6 +12,7 @@
 #include <libslic3r/SLA/SupportTree.hpp>
 #include <libslic3r/SLA/SpatIndex.hpp>
 #include <libslic3r/SLA/SupportTreeBuilder.hpp>
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
 #include <libslic3r/SLA/DefaultSupportTree.hpp>
 #include <libslic3r/SLA/BranchingTreeSLA.hpp>
 
@@ -28,7 +29,8 @@
 namespace Slic3r { namespace sla {
 
 indexed_triangle_set create_support_tree(const SupportableMesh &sm,
-                                         const JobController   &ctl)
+                                         const JobController   &ctl,
+                                         SupportTreeParts      *parts)
 {
     auto builder = make_unique<SupportTreeBuilder>(ctl);
 
@@ -57,6 +59,9 @@ indexed_triangle_set create_support_tree(const SupportableMesh &sm,
                                 << bench.getElapsedSec()
                                 << " seconds";
 
+        if (parts)
+            *parts = builder->parts();
+
         builder->merge_and_cleanup();   // clean metadata, leave only the meshes.
     }
 
@@ -101,21 +106,15 @@ indexed_triangle_set create_pad(const SupportableMesh      &sm,
     return out;
 }
 
-std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
-                              const indexed_triangle_set &pad_mesh,
-                              const std::vector<float>   &grid,
-                              float                       cr,
-                              const JobController        &ctl)
+// Slices the pad and merges all the slices into the first one.
+static std::vector<ExPolygons> merge_with_pad(std::vector<std::vector<ExPolygons>> &&slices,
+                                              const indexed_triangle_set &pad_mesh,
+                                              const std::vector<float>   &grid,
+                                              float                       cr,
+                                              const JobController        &ctl)
 {
     using Slices = std::vector<ExPolygons>;
 
-    auto slices = reserve_vector<Slices>(2);
-
-    if (!sup_mesh.empty()) {
-        slices.emplace_back();
-        slices.back() = slice_mesh_ex(sup_mesh, grid, cr, ctl.cancelfn);
-    }
-
     if (!pad_mesh.empty()) {
         slices.emplace_back();
 
@@ -136,7 +135,7 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
     // Either the support or the pad or both has to be non empty
     if (slices.empty()) return {};
 
-    Slices &mrg = slices.front();
+    Slices mrg = std::move(slices.front());
 
     for (auto it = std::next(slices.begin()); it != slices.end(); ++it) {
         for (size_t i = 0; i < len; ++i) {
@@ -149,4 +148,32 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
     return mrg;
 }
 
+std::vector<ExPolygons> slice(const indexed_triangle_set &sup_mesh,
+                              const indexed_triangle_set &pad_mesh,
+                              const std::vector<float>   &grid,
+                              float                       cr,
+                              const JobController        &ctl)
+{
+    auto slices = reserve_vector<std::vector<ExPolygons>>(2);
+
+    if (!sup_mesh.empty())
+        slices.emplace_back(slice_mesh_ex(sup_mesh, grid, cr, ctl.cancelfn));
+
+    return merge_with_pad(std::move(slices), pad_mesh, grid, cr, ctl);
+}
+
+std::vector<ExPolygons> slice(const SupportTreeParts     &sup_parts,
+                              const indexed_triangle_set &pad_mesh,
+                              const std::vector<float>   &grid,
+                              float                       cr,
+                              const JobController        &ctl)
+{
+    auto slices = reserve_vector<std::vector<ExPolygons>>(2);
+
+    if (!sup_parts.empty())
+        slices.emplace_back(slice_support_tree(sup_parts, grid, cr, ctl));
+
+    return merge_with_pad(std::move(slices), pad_mesh, grid, cr, ctl);
+}
+
 }} // namespace Slic3r::sla
@@ -144,8 +144,13 @@ inline double ground_level(const SupportableMesh &sm)
     return lvl;
 }
 
+struct SupportTreeParts;
+
+// If parts is not null, the parts of the tree are copied into it, so that the
+// tree can be sliced without its mesh.
 indexed_triangle_set create_support_tree(const SupportableMesh &mesh,
-                                         const JobController   &ctl);
+                                         const JobController   &ctl,
+                                         SupportTreeParts      *parts = nullptr);
 
 indexed_triangle_set create_pad(const SupportableMesh      &model_mesh,
                                 const indexed_triangle_set &support_mesh,
@@ -157,6 +162,13 @@ std::vector<ExPolygons> slice(const indexed_triangle_set &support_mesh,
                               float                       closing_radius,
                               const JobController        &ctl);
 
+// Same as above, the support tree is sliced from its parts.
+std::vector<ExPolygons> slice(const SupportTreeParts     &support_parts,
+                              const indexed_triangle_set &pad_mesh,
+                              const std::vector<float>   &grid,
+                              float                       closing_radius,
+                              const JobController        &ctl);
+
 } // namespace sla
 } // namespace Slic3r
 
@@ -28,8 +28,12 @@ SupportTreeBuilder::SupportTreeBuilder(SupportTreeBuilder &&o)
     : m_heads(std::move(o.m_heads))
     , m_head_indices{std::move(o.m_head_indices)}
     , m_pillars{std::move(o.m_pillars)}
+    , m_junctions{std::move(o.m_junctions)}
     , m_bridges{std::move(o.m_bridges)}
     , m_crossbridges{std::move(o.m_crossbridges)}
+    , m_diffbridges{std::move(o.m_diffbridges)}
+    , m_pedestals{std::move(o.m_pedestals)}
+    , m_anchors{std::move(o.m_anchors)}
     , m_meshcache{std::move(o.m_meshcache)}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -39,8 +43,12 @@ SupportTreeBuilder::SupportTreeBuilder(const SupportTreeBuilder &o)
     : m_heads(o.m_heads)
     , m_head_indices{o.m_head_indices}
     , m_pillars{o.m_pillars}
+    , m_junctions{o.m_junctions}
     , m_bridges{o.m_bridges}
     , m_crossbridges{o.m_crossbridges}
+    , m_diffbridges{o.m_diffbridges}
+    , m_pedestals{o.m_pedestals}
+    , m_anchors{o.m_anchors}
     , m_meshcache{o.m_meshcache}
     , m_meshcache_valid{o.m_meshcache_valid}
     , m_model_height{o.m_model_height}
@@ -51,8 +59,12 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(SupportTreeBuilder &&o)
     m_heads = std::move(o.m_heads);
     m_head_indices = std::move(o.m_head_indices);
     m_pillars = std::move(o.m_pillars);
+    m_junctions = std::move(o.m_junctions);
     m_bridges = std::move(o.m_bridges);
     m_crossbridges = std::move(o.m_crossbridges);
+    m_diffbridges = std::move(o.m_diffbridges);
+    m_pedestals = std::move(o.m_pedestals);
+    m_anchors = std::move(o.m_anchors);
     m_meshcache = std::move(o.m_meshcache);
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -64,8 +76,12 @@ SupportTreeBuilder &SupportTreeBuilder::operator=(const SupportTreeBuilder &o)
     m_heads = o.m_heads;
     m_head_indices = o.m_head_indices;
     m_pillars = o.m_pillars;
+    m_junctions = o.m_junctions;
     m_bridges = o.m_bridges;
     m_crossbridges = o.m_crossbridges;
+    m_diffbridges = o.m_diffbridges;
+    m_pedestals = o.m_pedestals;
+    m_anchors = o.m_anchors;
     m_meshcache = o.m_meshcache;
     m_meshcache_valid = o.m_meshcache_valid;
     m_model_height = o.m_model_height;
@@ -88,47 +104,7 @@ const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
 {
     if (m_meshcache_valid) return m_meshcache;
     
-    indexed_triangle_set merged;
-    
-    for (auto &head : m_heads) {
-        if (ctl().stopcondition()) break;
-        if (head.is_valid()) its_merge(merged, get_mesh(head, steps));
-    }
-    
-    for (auto &pill : m_pillars) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pill, steps));
-    }
-
-    for (auto &pedest : m_pedestals) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(pedest, steps));
-    }
-    
-    for (auto &j : m_junctions) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(j, steps));
-    }
-
-    for (auto &bs : m_bridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-    
-    for (auto &bs : m_crossbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-
-    for (auto &bs : m_diffbridges) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(bs, steps));
-    }
-
-    for (auto &anch : m_anchors) {
-        if (ctl().stopcondition()) break;
-        its_merge(merged, get_mesh(anch, steps));
-    }
+    indexed_triangle_set merged = get_mesh(parts(), steps, ctl());
 
     if (ctl().stopcondition()) {
         // In case of failure we have to return an empty mesh
@@ -149,6 +125,26 @@ const indexed_triangle_set &SupportTreeBuilder::merged_mesh(size_t steps) const
     return m_meshcache;
 }
 
+SupportTreeParts SupportTreeBuilder::parts() const
+{
+    std::lock_guard<Mutex> lk(m_mutex);
+
+    SupportTreeParts ret;
+
+    std::copy_if(m_heads.begin(), m_heads.end(), std::back_inserter(ret.heads),
+                 [](const Head &h) { return h.is_valid(); });
+    ret.heads.insert(ret.heads.end(), m_anchors.begin(), m_anchors.end());
+    std::copy_if(m_pillars.begin(), m_pillars.end(), std::back_inserter(ret.pillars),
+                 [](const Pillar &p) { return p.height > EPSILON; });
+    ret.pedestals   = m_pedestals;
+    ret.junctions   = m_junctions;
+    ret.bridges     = m_bridges;
+    ret.bridges.insert(ret.bridges.end(), m_crossbridges.begin(), m_crossbridges.end());
+    ret.diffbridges = m_diffbridges;
+
+    return ret;
+}
+
 const indexed_triangle_set &SupportTreeBuilder::merge_and_cleanup()
 {
     // in case the mesh is not generated, it should be...
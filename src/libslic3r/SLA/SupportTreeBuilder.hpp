@@ -206,6 +206,25 @@ struct DiffBridge: public Bridge {
     {}
 };
 
+// The geometry of a finished support tree without the bookkeeping of the
+// builder. It is kept after the support tree generation to slice the supports
+// without meshing them, see SupportTreeSlicer.hpp.
+struct SupportTreeParts
+{
+    std::vector<Head>       heads; // valid heads and the anchors
+    std::vector<Pillar>     pillars;
+    std::vector<Pedestal>   pedestals;
+    std::vector<Junction>   junctions;
+    std::vector<Bridge>     bridges; // bridges and crossbridges
+    std::vector<DiffBridge> diffbridges;
+
+    bool empty() const
+    {
+        return heads.empty() && pillars.empty() && pedestals.empty() &&
+               junctions.empty() && bridges.empty() && diffbridges.empty();
+    }
+};
+
 // This class will hold the support tree parts (not meshes, but logical parts)
 // with some additional bookkeeping as well. Various parts of the support
 // geometry are stored separately and are merged when the caller queries the
@@ -420,6 +439,10 @@ public:
 
     // WITHOUT THE PAD!!!
     const indexed_triangle_set &merged_mesh(size_t steps = 45) const;
+
+    // The parts which make up the merged mesh. To be called before
+    // merge_and_cleanup().
+    SupportTreeParts parts() const;
     
     // Intended to be called after the generation is fully complete
     const indexed_triangle_set & merge_and_cleanup();
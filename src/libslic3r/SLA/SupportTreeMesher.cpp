@@ -4,6 +4,11 @@
 ///|/
 #include "SupportTreeMesher.hpp"
 
+#include <libslic3r/Execution/ExecutionTBB.hpp>
+
+#include <atomic>
+#include <map>
+
 namespace Slic3r { namespace sla {
 
 indexed_triangle_set sphere(double rho, Portion portion, double fa) {
@@ -272,4 +277,139 @@ indexed_triangle_set get_mesh(const DiffBridge &br, size_t steps)
     return mesh;
 }
 
+namespace {
+
+// A part of the support tree as a transformed primitive. The template
+// vertices are scaled by a radius linearly interpolated between r_bottom
+// and r_top along their z coordinate, which ranges from 0 to 1 for the
+// cylinder and the cone, z is scaled by height. Then they are rotated and
+// moved to the position of the part.
+struct Instance
+{
+    const indexed_triangle_set *tmpl;
+    float                       r_bottom, r_top, height;
+    Matrix3f                    rotation;
+    Vec3f                       pos;
+};
+
+Instance make_instance(const indexed_triangle_set &tmpl,
+                       double                      r_bottom,
+                       double                      r_top,
+                       double                      height,
+                       const Vec3d                &pos,
+                       const Matrix3f             &rotation = Matrix3f::Identity())
+{
+    return {&tmpl, float(r_bottom), float(r_top), float(height), rotation, pos.cast<float>()};
+}
+
+void transform(const Instance &inst, Vec3f *out)
+{
+    const std::vector<Vec3f> &vertices = inst.tmpl->vertices;
+
+    auto src = Eigen::Map<const Eigen::Matrix3Xf>(vertices.front().data(), 3, Eigen::Index(vertices.size()));
+    auto dst = Eigen::Map<Eigen::Matrix3Xf>(out->data(), 3, Eigen::Index(vertices.size()));
+
+    auto x = src.row(0).array(), y = src.row(1).array(), z = src.row(2).array();
+    auto r = inst.r_bottom + (inst.r_top - inst.r_bottom) * z;
+    const Matrix3f &m = inst.rotation;
+    for (int row = 0; row < 3; ++row)
+        dst.row(row).array() = m(row, 0) * (x * r) + m(row, 1) * (y * r) +
+                               (m(row, 2) * inst.height) * z + inst.pos(row);
+}
+
+} // namespace
+
+indexed_triangle_set get_mesh(const SupportTreeParts &parts,
+                              size_t                  steps,
+                              const JobController    &ctl)
+{
+    using Quaternion = Eigen::Quaternion<float>;
+
+    const indexed_triangle_set unit_sphere   = sphere(1., make_portion(0, PI), 2 * PI / steps);
+    const indexed_triangle_set unit_cylinder = cylinder(1., 1., steps);
+    const indexed_triangle_set unit_cone     = halfcone(1., 1., 1., Vec3d::Zero(), steps);
+
+    // The heads mostly share the same dimensions.
+    std::map<std::tuple<double, double, double>, indexed_triangle_set> pinheads;
+    for (const Head &h : parts.heads)
+        pinheads.emplace(std::make_tuple(h.r_pin_mm, h.r_back_mm, h.width_mm), indexed_triangle_set{});
+    for (auto &[dims, mesh] : pinheads)
+        mesh = pinhead(std::get<0>(dims), std::get<1>(dims), std::get<2>(dims), steps);
+
+    std::vector<Instance> instances;
+    instances.reserve(parts.heads.size() + parts.pillars.size() +
+                      parts.pedestals.size() + parts.junctions.size() +
+                      parts.bridges.size() + parts.diffbridges.size());
+
+    for (const Head &h : parts.heads) {
+        // The head's pointing side is facing upwards in the pinhead mesh,
+        // see get_mesh(const Head&, size_t).
+        Matrix3f rot = Quaternion::FromTwoVectors(Vec3f{0.f, 0.f, -1.f}, h.dir.cast<float>()).toRotationMatrix();
+        Vec3d    pos = h.pos + rot.cast<double>() * Vec3d{0., 0., -(h.fullwidth() - h.r_back_mm)};
+        instances.emplace_back(make_instance(pinheads[std::make_tuple(h.r_pin_mm, h.r_back_mm, h.width_mm)],
+                                             1., 1., 1., pos, rot));
+    }
+
+    for (const Pillar &p : parts.pillars)
+        if (p.height > EPSILON && (p.r_end > 0. || p.r_start > 0.))
+            instances.emplace_back(make_instance(unit_cone, p.r_end, p.r_start, p.height, p.endpt));
+
+    for (const Pedestal &p : parts.pedestals)
+        if (p.height > 0. && (p.r_bottom > 0. || p.r_top > 0.))
+            instances.emplace_back(make_instance(unit_cone, p.r_bottom, p.r_top, p.height, p.pos));
+
+    for (const Junction &j : parts.junctions)
+        if (std::abs(j.r) > 1e-6)
+            instances.emplace_back(make_instance(unit_sphere, j.r, j.r, j.r, j.pos));
+
+    for (const Bridge &br : parts.bridges) {
+        Matrix3f rot = Quaternion::FromTwoVectors(Vec3f{0.f, 0.f, 1.f}, br.get_dir().cast<float>()).toRotationMatrix();
+        instances.emplace_back(make_instance(unit_cylinder, br.r, br.r, br.get_length(), br.startp, rot));
+    }
+
+    for (const DiffBridge &br : parts.diffbridges) {
+        double h = br.get_length();
+        if (h <= 0. || (br.r <= 0. && br.end_r <= 0.))
+            continue;
+        Matrix3f rot = Quaternion::FromTwoVectors(Vec3f{0.f, 0.f, 1.f}, br.get_dir().cast<float>()).toRotationMatrix();
+        instances.emplace_back(make_instance(unit_cone, br.r, br.end_r, h, br.startp, rot));
+    }
+
+    // Offsets of the instances in the merged vertices and indices.
+    std::vector<size_t> vertex_offsets(instances.size() + 1, 0);
+    std::vector<size_t> index_offsets(instances.size() + 1, 0);
+    for (size_t i = 0; i < instances.size(); ++i) {
+        vertex_offsets[i + 1] = vertex_offsets[i] + instances[i].tmpl->vertices.size();
+        index_offsets[i + 1]  = index_offsets[i] + instances[i].tmpl->indices.size();
+    }
+
+    indexed_triangle_set out;
+    out.vertices.resize(vertex_offsets.back());
+    out.indices.resize(index_offsets.back());
+
+    std::atomic<bool> stopped{false};
+    execution::for_each(ex_tbb, size_t(0), instances.size(), [&](size_t i) {
+        if ((i % 64) == 0 && ctl.stopcondition())
+            stopped = true;
+        if (stopped)
+            return;
+
+        const Instance &inst = instances[i];
+        if (inst.tmpl->vertices.empty())
+            return;
+
+        transform(inst, &out.vertices[vertex_offsets[i]]);
+
+        auto offs = Vec3i32::Constant(int(vertex_offsets[i]));
+        std::transform(inst.tmpl->indices.begin(), inst.tmpl->indices.end(),
+                       out.indices.begin() + index_offsets[i],
+                       [&offs](const Vec3i32 &f) -> Vec3i32 { return f + offs; });
+    }, 64 /*gransize*/);
+
+    if (stopped)
+        return {};
+
+    return out;
+}
+
 }} // namespace Slic3r::sla
@@ -78,6 +78,14 @@ indexed_triangle_set get_mesh(const Bridge &br, size_t steps);
 
 indexed_triangle_set get_mesh(const DiffBridge &br, size_t steps);
 
+// The mesh of all the parts of a support tree. The primitives are only
+// tessellated once for the given steps and their instances are transformed
+// into a pre-allocated mesh in parallel. The vertices are not merged.
+// Returns an empty mesh if stopped by the job controller.
+indexed_triangle_set get_mesh(const SupportTreeParts &parts,
+                              size_t                  steps,
+                              const JobController    &ctl = {});
+
 }} // namespace Slic3r::sla
 
 #endif // SUPPORTTREEMESHER_HPP
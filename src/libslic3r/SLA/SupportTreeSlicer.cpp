@@ -0,0 +1,236 @@
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
+
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/Geometry/ConvexHull.hpp>
+#include <libslic3r/Execution/ExecutionTBB.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Slic3r { namespace sla {
+
+namespace {
+
+// Maximum distance of the polygonal sections from the exact ones in mm.
+// The meshes of the support tree deviate by about the same distance.
+constexpr double SectionTolerance = 0.0025;
+
+size_t circle_steps(double r)
+{
+    if (r <= SectionTolerance)
+        return 8;
+
+    auto steps = size_t(std::ceil(PI / std::acos(1. - SectionTolerance / r)));
+    return std::clamp<size_t>(steps, 8, 360);
+}
+
+// A convex part of the support tree: a sphere, a truncated cone (the convex
+// hull of two discs perpendicular to its axis) or the convex hull of two
+// spheres.
+struct ConvexPart
+{
+    enum Type { Sphere, Cone, SphereHull };
+
+    Type   type;
+    Vec3d  c0, c1;
+    double r0, r1;
+    double zmin, zmax;
+};
+
+ConvexPart make_sphere(const Vec3d &c, double r)
+{
+    return {ConvexPart::Sphere, c, c, r, r, c.z() - r, c.z() + r};
+}
+
+ConvexPart make_cone(const Vec3d &c0, double r0, const Vec3d &c1, double r1)
+{
+    // Vertical extent of a unit disc perpendicular to the axis.
+    Vec3d  axis = (c1 - c0).normalized();
+    double h    = std::sqrt(std::max(0., 1. - axis.z() * axis.z()));
+
+    return {ConvexPart::Cone, c0, c1, r0, r1,
+            std::min(c0.z() - r0 * h, c1.z() - r1 * h),
+            std::max(c0.z() + r0 * h, c1.z() + r1 * h)};
+}
+
+ConvexPart make_sphere_hull(const Vec3d &c0, double r0, const Vec3d &c1, double r1)
+{
+    return {ConvexPart::SphereHull, c0, c1, r0, r1,
+            std::min(c0.z() - r0, c1.z() - r1),
+            std::max(c0.z() + r0, c1.z() + r1)};
+}
+
+// The same geometry as the meshes of SupportTreeMesher.hpp.
+std::vector<ConvexPart> convex_parts(const SupportTreeParts &parts)
+{
+    std::vector<ConvexPart> out;
+    out.reserve(parts.heads.size() + parts.pillars.size() +
+                parts.pedestals.size() + parts.junctions.size() +
+                parts.bridges.size() + parts.diffbridges.size());
+
+    for (const Head &h : parts.heads) {
+        // The pinhead is the convex hull of the back sphere centered in the
+        // junction point and the pin sphere at the support point.
+        Vec3d dir = h.dir.normalized();
+        // Skip the degenerate heads, for which pinhead() returns an empty mesh.
+        if (std::isnan(PI / 2. - std::acos((h.r_back_mm - h.r_pin_mm) / (h.r_back_mm + h.r_pin_mm + h.width_mm))))
+            continue;
+        out.emplace_back(make_sphere_hull(h.pos + (h.fullwidth() - h.r_back_mm) * dir, h.r_back_mm,
+                                          h.pos + (h.r_pin_mm - h.penetration_mm) * dir, h.r_pin_mm));
+    }
+
+    for (const Pillar &p : parts.pillars)
+        if (p.height > EPSILON)
+            out.emplace_back(make_cone(p.endpt, p.r_end, p.startpoint(), p.r_start));
+
+    for (const Pedestal &p : parts.pedestals)
+        if (p.height > 0. && (p.r_bottom > 0. || p.r_top > 0.))
+            out.emplace_back(make_cone(p.pos, p.r_bottom, p.pos + Vec3d{0., 0., p.height}, p.r_top));
+
+    for (const Junction &j : parts.junctions)
+        out.emplace_back(make_sphere(j.pos, j.r));
+
+    for (const Bridge &br : parts.bridges)
+        if (br.get_length() > EPSILON)
+            out.emplace_back(make_cone(br.startp, br.r, br.endp, br.r));
+
+    for (const DiffBridge &br : parts.diffbridges)
+        if (br.get_length() > EPSILON)
+            out.emplace_back(make_cone(br.startp, br.r, br.endp, br.end_r));
+
+    return out;
+}
+
+void append_point(Points &out, const Vec3d &p)
+{
+    out.emplace_back(scaled(p.x()), scaled(p.y()));
+}
+
+void append_sphere_section(Points &out, const Vec3d &c, double r, double z)
+{
+    double dz = z - c.z();
+    if (std::abs(dz) >= r)
+        return;
+
+    double rz    = std::sqrt(r * r - dz * dz);
+    size_t steps = circle_steps(rz);
+    for (size_t i = 0; i < steps; ++i) {
+        double phi = 2. * PI * double(i) / double(steps);
+        append_point(out, c + Vec3d{rz * std::cos(phi), rz * std::sin(phi), 0.});
+    }
+}
+
+// The cut of a truncated cone by a horizontal plane is bounded by the
+// intersections of the generating lines of its mantle with the plane and by
+// the chords cut out of its base discs.
+void append_cone_section(Points &out, const Vec3d &c0, double r0, const Vec3d &c1, double r1, double z)
+{
+    Vec3d axis = c1 - c0;
+    if (axis.squaredNorm() < EPSILON * EPSILON)
+        return;
+    axis.normalize();
+
+    // Orthonormal base of the planes of the discs, u is horizontal.
+    Vec3d u = axis.cross(Vec3d::UnitZ());
+    u = u.squaredNorm() < EPSILON * EPSILON ? Vec3d::UnitX() : u.normalized();
+    Vec3d w = axis.cross(u);
+
+    size_t steps = circle_steps(std::max(r0, r1));
+    for (size_t i = 0; i < steps; ++i) {
+        double phi = 2. * PI * double(i) / double(steps);
+        Vec3d  d   = std::cos(phi) * u + std::sin(phi) * w;
+        Vec3d  p0  = c0 + r0 * d;
+        Vec3d  p1  = c1 + r1 * d;
+        double d0  = p0.z() - z;
+        double d1  = p1.z() - z;
+        if (d0 * d1 > 0.)
+            continue;
+        if (d0 == d1) {
+            // The generating line lies in the plane.
+            append_point(out, p0);
+            append_point(out, p1);
+        } else
+            append_point(out, p0 + (p1 - p0) * (d0 / (d0 - d1)));
+    }
+
+    for (const auto &[c, r] : { std::make_pair(c0, r0), std::make_pair(c1, r1) }) {
+        // Points c + r * (x * u + y * w) of the disc in the plane.
+        double wz = r * w.z();
+        if (std::abs(wz) < EPSILON)
+            // Horizontal disc, its rim is covered by the generating lines.
+            continue;
+        double y = (z - c.z()) / wz;
+        if (std::abs(y) > 1.)
+            continue;
+        double x = std::sqrt(1. - y * y);
+        append_point(out, c + r * (x * u + y * w));
+        append_point(out, c + r * (-x * u + y * w));
+    }
+}
+
+void append_sphere_hull_section(Points &out, const Vec3d &c0, double r0, const Vec3d &c1, double r1, double z)
+{
+    append_sphere_section(out, c0, r0, z);
+    append_sphere_section(out, c1, r1, z);
+
+    Vec3d  axis = c1 - c0;
+    double d    = axis.norm();
+    if (d < EPSILON)
+        return;
+    double sina = (r0 - r1) / d;
+    if (std::abs(sina) >= 1.)
+        // One sphere contains the other one.
+        return;
+    axis /= d;
+    double cosa = std::sqrt(1. - sina * sina);
+
+    // The rest of the hull is a truncated cone touching both spheres.
+    append_cone_section(out, c0 + r0 * sina * axis, r0 * cosa, c1 + r1 * sina * axis, r1 * cosa, z);
+}
+
+Polygon section(const ConvexPart &part, double z)
+{
+    Points pts;
+    switch (part.type) {
+    case ConvexPart::Sphere:     append_sphere_section(pts, part.c0, part.r0, z); break;
+    case ConvexPart::Cone:       append_cone_section(pts, part.c0, part.r0, part.c1, part.r1, z); break;
+    case ConvexPart::SphereHull: append_sphere_hull_section(pts, part.c0, part.r0, part.c1, part.r1, z); break;
+    }
+
+    return pts.size() < 3 ? Polygon{} : Geometry::convex_hull(std::move(pts));
+}
+
+} // namespace
+
+std::vector<ExPolygons> slice_support_tree(const SupportTreeParts   &parts,
+                                           const std::vector<float> &grid,
+                                           float                     closing_radius,
+                                           const JobController      &ctl)
+{
+    std::vector<ConvexPart> cparts = convex_parts(parts);
+    std::sort(cparts.begin(), cparts.end(),
+              [](const ConvexPart &a, const ConvexPart &b) { return a.zmin < b.zmin; });
+
+    std::vector<ExPolygons> out(grid.size());
+    const double            cr = scaled(closing_radius);
+
+    execution::for_each(ex_tbb, size_t(0), grid.size(), [&](size_t layer_id) {
+        ctl.cancelfn();
+
+        double z   = grid[layer_id];
+        auto   end = std::upper_bound(cparts.begin(), cparts.end(), z,
+                                      [](double z, const ConvexPart &p) { return z < p.zmin; });
+
+        Polygons sections;
+        for (auto it = cparts.begin(); it != end; ++it)
+            if (it->zmax > z)
+                if (Polygon poly = section(*it, z); poly.size() >= 3)
+                    sections.emplace_back(std::move(poly));
+
+        out[layer_id] = cr > 0. ? offset2_ex(union_ex(sections), cr, -cr) : union_ex(sections);
+    });
+
+    return out;
+}
+
+}} // namespace Slic3r::sla
@@ -0,0 +1,20 @@
+#ifndef SLA_SUPPORTTREESLICER_HPP
+#define SLA_SUPPORTTREESLICER_HPP
+
+#include <libslic3r/SLA/SupportTreeBuilder.hpp>
+
+namespace Slic3r { namespace sla {
+
+// Slice the support tree at the given heights directly from its parts,
+// without meshing them. Every part is convex: a sphere, a truncated cone or
+// the convex hull of two spheres (the pinheads). Its section with a
+// horizontal plane is calculated from the geometry of the part and the
+// sections are merged for each layer in parallel.
+std::vector<ExPolygons> slice_support_tree(const SupportTreeParts   &parts,
+                                           const std::vector<float> &grid,
+                                           float                     closing_radius,
+                                           const JobController      &ctl = {});
+
+}} // namespace Slic3r::sla
+
+#endif // SLA_SUPPORTTREESLICER_HPP
@@ -14,11 +14,13 @@
 
 #include "Geometry.hpp"
 #include "Thread.hpp"
+#include "Utils.hpp"
 
 #include <unordered_set>
 #include <numeric>
 
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_pipeline.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/log/trivial.hpp>
 
@@ -707,6 +709,25 @@ bool SLAPrint::invalidate_step(SLAPrintStep step)
     return invalidated;
 }
 
+namespace {
+
+// Count of the objects processed at once through their steps. Hollowing keeps a voxel grid of the object until
+// the holes are drilled, which takes gigabytes for large objects, thus the count is limited by the physical memory
+// if any of the objects is hollowed.
+size_t max_objects_in_flight(const PrintObjects &objects)
+{
+    // Empirical memory needed by the hollowing of a large object.
+    static constexpr const size_t HOLLOWING_MEMORY_PER_OBJECT = size_t(2) << 30;
+
+    const size_t num_objects = std::max<size_t>(objects.size(), 1);
+    const bool   hollowing   = std::any_of(objects.begin(), objects.end(), [](const SLAPrintObject *po) {
+        return po->config().hollowing_enable.value && ! po->is_step_done(slaposHollowing);
+    });
+    return hollowing ? std::clamp<size_t>(total_physical_memory() / HOLLOWING_MEMORY_PER_OBJECT, 1, num_objects) : num_objects;
+}
+
+} // namespace
+
 void SLAPrint::process()
 {
     if (m_objects.empty())
@@ -730,8 +751,6 @@ void SLAPrint::process()
     };
 
     SLAPrintStep print_steps[] = { slapsMergeSlicesAndEval, slapsRasterize };
-    
-    double st = Steps::min_objstatus;
 
     BOOST_LOG_TRIVIAL(info) << "Start slicing process.";
 
@@ -744,42 +763,56 @@ void SLAPrint::process()
 #endif
 
     std::array<double, slaposCount + slapsCount> step_times {};
+    std::mutex step_times_mutex;
 
+    // The objects are processed concurrently, each one through its steps. The objects are passed in order to the parallel
+    // stage of a pipeline, whose tokens limit the count of the objects processed at once. Unlike a semaphore, the tokens
+    // never block a worker thread waiting for a free slot.
     auto apply_steps_on_objects =
-        [this, &st, &printsteps, &step_times, &bench]
-        (const std::vector<SLAPrintObjectStep> &steps)
+        [this, &printsteps, &step_times, &step_times_mutex]
+        (const std::vector<SLAPrintObjectStep> &steps, size_t max_objects)
     {
-        double incr = 0;
-        for (SLAPrintObject *po : m_objects) {
-            for (SLAPrintObjectStep step : steps) {
-
-                // Cancellation checking. Each step will check for
-                // cancellation on its own and return earlier gracefully.
-                // Just after it returns execution gets to this point and
-                // throws the canceled signal.
-                throw_if_canceled();
-
-                st += incr;
-
-                if (po->set_started(step)) {
-                    m_report_status(*this, st, printsteps.label(step));
-                    bench.start();
-                    printsteps.execute(step, *po);
-                    bench.stop();
-                    step_times[step] += bench.getElapsedSec();
+        size_t next_object = 0;
+        tbb::parallel_pipeline(max_objects,
+            tbb::make_filter<void, size_t>(tbb::filter_mode::serial_in_order, [this, &next_object](tbb::flow_control &fc) -> size_t {
+                if (next_object == m_objects.size())
+                    fc.stop();
+                return next_object ++;
+            }) &
+            tbb::make_filter<size_t, void>(tbb::filter_mode::parallel, [&](size_t idx) {
+                SLAPrintObject &po = *m_objects[idx];
+                decltype(bench) obj_bench;
+
+                for (SLAPrintObjectStep step : steps) {
+
+                    // Cancellation checking. Each step will check for
+                    // cancellation on its own and return earlier gracefully.
+                    // Just after it returns execution gets to this point and
+                    // throws the canceled signal.
                     throw_if_canceled();
-                    po->set_done(step);
+
+                    if (po.set_started(step)) {
+                        printsteps.report_object_status(po, Steps::object_status(step), printsteps.label(step));
+                        obj_bench.start();
+                        printsteps.execute(step, po);
+                        obj_bench.stop();
+                        {
+                            std::scoped_lock<std::mutex> lock(step_times_mutex);
+                            step_times[step] += obj_bench.getElapsedSec();
+                        }
+                        throw_if_canceled();
+                        po.set_done(step);
+                    }
+
+                    printsteps.set_object_status(po, Steps::object_status(SLAPrintObjectStep(step + 1)));
                 }
-                
-                incr = printsteps.progressrange(step);
-            }
-        }
+            }));
     };
 
-    apply_steps_on_objects(level1_obj_steps);
-    apply_steps_on_objects(level2_obj_steps);
+    apply_steps_on_objects(level1_obj_steps, max_objects_in_flight(m_objects));
+    apply_steps_on_objects(level2_obj_steps, m_objects.size());
 
-    st = Steps::max_objstatus;
+    double st = Steps::max_objstatus;
     for(SLAPrintStep currentstep : print_steps) {
         throw_if_canceled();
 
@@ -1236,6 +1269,7 @@ DynamicConfig SLAPrintStatistics::config() const
     config.set_key_value("support_used_material", new ConfigOptionFloat(this->support_used_material));
     config.set_key_value("total_cost", new ConfigOptionFloat(this->total_cost));
     config.set_key_value("total_weight", new ConfigOptionFloat(this->total_weight));
+    config.set_key_value("duplicate_layers_count", new ConfigOptionInt(int(this->duplicate_layers_count)));
     return config;
 }
 
@@ -1244,7 +1278,7 @@ DynamicConfig SLAPrintStatistics::placeholders()
     DynamicConfig config;
     for (const char *key : {
         "print_time", "total_cost", "total_weight",
-        "objects_used_material", "support_used_material" })
+        "objects_used_material", "support_used_material", "duplicate_layers_count" })
         config.set_key_value(key, new ConfigOptionString(std::string("{") + key + "}"));
 
     return config;
@@ -1273,6 +1307,7 @@ void SLAPrint::StatusReporter::operator()(SLAPrint &         p,
                                           uint16_t           flags,
                                           const std::string &logmsg)
 {
+    std::scoped_lock<std::mutex> lock(m_mutex);
     m_st = st;
     BOOST_LOG_TRIVIAL(info)
         << st << "% " << msg << (logmsg.empty() ? "" : ": ") << logmsg
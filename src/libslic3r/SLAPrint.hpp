@@ -12,6 +12,7 @@
 
 #include "PrintBase.hpp"
 #include "SLA/SupportTree.hpp"
+#include "SLA/SupportTreeBuilder.hpp"
 #include "Point.hpp"
 #include "Format/SLAArchiveWriter.hpp"
 #include "GCode/ThumbnailData.hpp"
@@ -346,6 +347,7 @@ private:
         sla::SupportableMesh    input; // the input
         std::vector<ExPolygons> support_slices;   // sliced supports
         TriangleMesh tree_mesh, pad_mesh, full_mesh; // cached artifacts
+        sla::SupportTreeParts   tree_parts;       // the tree is sliced from these
         
         inline SupportData(const TriangleMesh &t)
             : input{t.its, {}, {}}
@@ -357,7 +359,8 @@ private:
         
         void create_support_tree(const sla::JobController &ctl)
         {
-            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl)};
+            tree_parts = {};
+            tree_mesh = TriangleMesh{sla::create_support_tree(input, ctl, &tree_parts)};
         }
 
         void create_pad(const sla::JobController &ctl)
@@ -410,6 +413,8 @@ struct SLAPrintStatistics
     double                          support_used_material;
     size_t                          slow_layers_count;
     size_t                          fast_layers_count;
+    // Layers rasterized the same as a layer below, their raster is shared.
+    size_t                          duplicate_layers_count;
     double                          total_cost;
     double                          total_weight;
     std::vector<double>             layers_times;
@@ -427,6 +432,7 @@ struct SLAPrintStatistics
         support_used_material = 0.;
         slow_layers_count = 0;
         fast_layers_count = 0;
+        duplicate_layers_count = 0;
         total_cost = 0.;
         total_weight = 0.;
         layers_times.clear();
@@ -578,9 +584,11 @@ private:
     // Estimated print time, material consumed.
     SLAPrintStatistics              m_print_statistics;
     
+    // Called concurrently by the steps of the objects being processed.
     class StatusReporter
     {
-        double m_st = 0;
+        double             m_st = 0;
+        mutable std::mutex m_mutex;
         
     public:
         void operator()(SLAPrint &         p,
@@ -589,7 +597,7 @@ private:
                         uint16_t           flags = SlicingStatus::DEFAULT,
                         const std::string &logmsg = "");
         
-        double status() const { return m_st; }
+        double status() const { std::scoped_lock<std::mutex> lock(m_mutex); return m_st; }
     } m_report_status;
 
 	friend SLAPrintObject;
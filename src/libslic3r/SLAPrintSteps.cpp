@@ -3,6 +3,9 @@
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
 #include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
 
 #include <libslic3r/Exception.hpp>
 #include <libslic3r/SLAPrintSteps.hpp>
@@ -94,8 +97,40 @@ SLAPrint::Steps::Steps(SLAPrint *print)
     , ilh{float(ilhd)}
     , ilhs{scaled(ilhd)}
     , objectstep_scale{(max_objstatus - min_objstatus) / (objcount * 100.0)}
+    , m_objstatus(objcount, 0.)
 {}
 
+double SLAPrint::Steps::update_object_status(const SLAPrintObject &po, double objstatus)
+{
+    auto it = std::find(m_print->m_objects.begin(), m_print->m_objects.end(), &po);
+    assert(it != m_print->m_objects.end());
+    m_objstatus[it - m_print->m_objects.begin()] = objstatus;
+    return min_objstatus + objectstep_scale * std::accumulate(m_objstatus.begin(), m_objstatus.end(), 0.);
+}
+
+void SLAPrint::Steps::set_object_status(const SLAPrintObject &po, double objstatus)
+{
+    std::scoped_lock<std::mutex> lock(m_objstatus_mutex);
+    update_object_status(po, objstatus);
+}
+
+void SLAPrint::Steps::report_object_status(const SLAPrintObject &po, double objstatus, const std::string &msg)
+{
+    std::scoped_lock<std::mutex> lock(m_objstatus_mutex);
+    m_objstatus_reported = update_object_status(po, objstatus);
+    report_status(m_objstatus_reported, msg);
+}
+
+void SLAPrint::Steps::report_object_progress(const SLAPrintObject &po, SLAPrintObjectStep step, unsigned st, const std::string &logmsg)
+{
+    std::scoped_lock<std::mutex> lock(m_objstatus_mutex);
+    double current = update_object_status(po, object_status(step) + st * OBJ_STEP_LEVELS[step] / 100.);
+    if (std::round(m_objstatus_reported) < std::round(current)) {
+        m_objstatus_reported = current;
+        report_status(current, OBJ_STEP_LABELS(step), SlicingStatus::DEFAULT, logmsg);
+    }
+}
+
 void SLAPrint::Steps::apply_printer_corrections(SLAPrintObject &po, SliceOrigin o)
 {
     if (o == soSupport && !po.m_supportdata) return;
@@ -625,15 +660,9 @@ void SLAPrint::Steps::support_points(SLAPrintObject &po)
             break;
         }
 
-        // scaling for the sub operations
-        double d = objectstep_scale * OBJ_STEP_LEVELS[slaposSupportPoints] / 100.0;
-        double init = current_status();
-
-        auto statuscb = [this, d, init](unsigned st)
+        auto statuscb = [this, &po](unsigned st)
         {
-            double current = init + st * d;
-            if(std::round(current_status()) < std::round(current))
-                report_status(current, OBJ_STEP_LABELS(slaposSupportPoints));
+            report_object_progress(po, slaposSupportPoints, st);
         };
 
         // Construction of this object does the calculation.
@@ -698,16 +727,10 @@ void SLAPrint::Steps::support_tree(SLAPrintObject &po)
     po.m_supportdata->input.cfg = make_support_cfg(po.m_config);
     po.m_supportdata->input.pad_cfg = make_pad_cfg(po.m_config);
 
-    // scaling for the sub operations
-    double d = objectstep_scale * OBJ_STEP_LEVELS[slaposSupportTree] / 100.0;
-    double init = current_status();
     sla::JobController ctl;
 
-    ctl.statuscb = [this, d, init](unsigned st, const std::string &logmsg) {
-        double current = init + st * d;
-        if (std::round(current_status()) < std::round(current))
-            report_status(current, OBJ_STEP_LABELS(slaposSupportTree),
-                          SlicingStatus::DEFAULT, logmsg);
+    ctl.statuscb = [this, &po](unsigned st, const std::string &logmsg) {
+        report_object_progress(po, slaposSupportTree, st, logmsg);
     };
     ctl.stopcondition = [this]() { return canceled(); };
     ctl.cancelfn = [this]() { throw_if_canceled(); };
@@ -794,7 +817,7 @@ void SLAPrint::Steps::slice_supports(SLAPrintObject &po) {
         ctl.cancelfn = [this]() { throw_if_canceled(); };
 
         sd->support_slices =
-            sla::slice(sd->tree_mesh.its, sd->pad_mesh.its, heights,
+            sla::slice(sd->tree_parts, sd->pad_mesh.its, heights,
                        float(po.config().slice_closing_radius.value), ctl);
     }
 
@@ -1112,11 +1135,61 @@ void SLAPrint::Steps::merge_slices_and_eval_stats() {
     report_status(-2, "", SlicingStatus::RELOAD_SLA_PREVIEW);
 }
 
+// For each layer the index of the first layer with the same transformed
+// slices, these are rasterized only once.
+static std::vector<size_t> raster_sources(const std::vector<SLAPrint::PrintLayer> &layers)
+{
+    std::vector<size_t> hashes(layers.size());
+    execution::for_each(ex_tbb, size_t(0), layers.size(), [&layers, &hashes](size_t idx) {
+        size_t seed = 0;
+        auto hash_polygon = [&seed](const Polygon &poly) {
+            boost::hash_combine(seed, poly.size());
+            for (const Point &pt : poly.points) {
+                boost::hash_combine(seed, pt.x());
+                boost::hash_combine(seed, pt.y());
+            }
+        };
+        for (const ExPolygon &expoly : layers[idx].transformed_slices()) {
+            hash_polygon(expoly.contour);
+            boost::hash_combine(seed, expoly.holes.size());
+            for (const Polygon &hole : expoly.holes)
+                hash_polygon(hole);
+        }
+        hashes[idx] = seed;
+    }, execution::max_concurrency(ex_tbb));
+
+    // Layers with the same hash, compared in full to tell the collisions.
+    std::unordered_map<size_t, std::vector<size_t>> sources_by_hash;
+    std::vector<size_t> sources(layers.size());
+    for (size_t idx = 0; idx < layers.size(); ++idx) {
+        std::vector<size_t> &candidates = sources_by_hash[hashes[idx]];
+        auto it = std::find_if(candidates.begin(), candidates.end(), [&layers, idx](size_t src) {
+            return layers[src].transformed_slices() == layers[idx].transformed_slices();
+        });
+        if (it == candidates.end()) {
+            candidates.emplace_back(idx);
+            sources[idx] = idx;
+        } else
+            sources[idx] = *it;
+    }
+
+    return sources;
+}
+
 // Rasterizing the model objects, and their supports
 void SLAPrint::Steps::rasterize()
 {
     if(canceled() || !m_print->m_archiver) return;
 
+    std::vector<size_t> sources = raster_sources(m_print->m_printer_input);
+    size_t duplicates = 0;
+    for (size_t idx = 0; idx < sources.size(); ++idx)
+        duplicates += sources[idx] != idx;
+
+    m_print->m_print_statistics.duplicate_layers_count = duplicates;
+    BOOST_LOG_TRIVIAL(info) << "Rasterizing " << sources.size() - duplicates
+                            << " unique layers out of " << sources.size();
+
     // coefficient to map the rasterization state (0-99) to the allocated
     // portion (slot) of the process state
     double sd = (100 - max_objstatus) / 100.0;
@@ -1127,7 +1200,7 @@ void SLAPrint::Steps::rasterize()
     // pst: previous state
     double pst = current_status();
 
-    double increment = (slot * sd) / m_print->m_printer_input.size();
+    double increment = (slot * sd) / (sources.size() - duplicates);
     double dstatus = current_status();
 
     execution::SpinningMutex<ExecutionTBB> slck;
@@ -1159,7 +1232,7 @@ void SLAPrint::Steps::rasterize()
     if(canceled()) return;
 
     // Print all the layers in parallel
-    m_print->m_archiver->draw_layers(m_print->m_printer_input.size(), lvlfn,
+    m_print->m_archiver->draw_layers(std::move(sources), lvlfn,
                                     [this]() { return canceled(); }, ex_tbb);
 }
 
@@ -1183,6 +1256,11 @@ double SLAPrint::Steps::progressrange(SLAPrintStep step) const
     return PRINT_STEP_LEVELS[step] * (100 - max_objstatus) / 100.0;
 }
 
+double SLAPrint::Steps::object_status(SLAPrintObjectStep step)
+{
+    return std::accumulate(OBJ_STEP_LEVELS.begin(), OBJ_STEP_LEVELS.begin() + step, 0.);
+}
+
 void SLAPrint::Steps::execute(SLAPrintObjectStep step, SLAPrintObject &obj)
 {
     switch(step) {
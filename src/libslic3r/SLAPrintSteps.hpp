@@ -5,6 +5,7 @@
 #ifndef SLAPRINTSTEPS_HPP
 #define SLAPRINTSTEPS_HPP
 
+#include <mutex>
 #include <random>
 
 #include <libslic3r/SLAPrint.hpp>
@@ -36,6 +37,15 @@ private:
     // are set up for <0, 100>. They need to be scaled into the whole process
     const double objectstep_scale;
 
+    // The objects are processed concurrently. Progress of each object through
+    // its object steps in <0, 100>, their sum makes the status of the process.
+    std::vector<double> m_objstatus;
+    double              m_objstatus_reported = 0.;
+    std::mutex          m_objstatus_mutex;
+
+    // Sets the progress of the object and returns the status of the process, m_objstatus_mutex has to be locked.
+    double update_object_status(const SLAPrintObject &po, double objstatus);
+
     template<class...Args> void report_status(Args&&...args)
     {
         m_print->m_report_status(*m_print, std::forward<Args>(args)...);
@@ -74,6 +84,15 @@ public:
 
     double progressrange(SLAPrintObjectStep step) const;
     double progressrange(SLAPrintStep step) const;
+
+    // Progress of an object in <0, 100> when the step starts.
+    static double object_status(SLAPrintObjectStep step);
+    // Sets the progress of the object, it will be reported with the next message.
+    void set_object_status(const SLAPrintObject &po, double objstatus);
+    // Sets the progress of the object and reports the status of the process with the message.
+    void report_object_status(const SLAPrintObject &po, double objstatus, const std::string &msg);
+    // Reports the progress of a step of the object in <0, 100>, if it changes the rounded status of the process.
+    void report_object_progress(const SLAPrintObject &po, SLAPrintObjectStep step, unsigned st, const std::string &logmsg = {});
 };
 
 } // namespace Slic3r
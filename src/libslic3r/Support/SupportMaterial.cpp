@@ -657,7 +657,8 @@ public:
                     m_grid.has_intersecting_edges() ? "FAILED" : "SUCCEEDED");
             }
     #endif
-            m_grid.calculate_sdf();
+            // contours_simplified() only queries the field closer than offset_in_grid to the contours.
+            m_grid.calculate_sparse_sdf(grid_resolution);
     #endif // SUPPORT_USE_AGG_RASTERIZER
             break;
         }
@@ -893,7 +894,7 @@ public:
         bbox.align_to_grid(grid_resolution);
         m_grid.set_bbox(bbox);
         m_grid.create(*m_support_polygons, grid_resolution);
-        m_grid.calculate_sdf();
+        m_grid.calculate_sparse_sdf(grid_resolution);
         return true;
     }
 
@@ -36,8 +36,11 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <limits>
+#include <numeric>
 #include <type_traits>
 
+#include <boost/container_hash/hash.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
@@ -210,6 +213,7 @@ void TriangleMesh::from_facets(std::vector<stl_facet> &&facets, bool repair)
 
     stl_generate_shared_vertices(&stl, this->its);
     fill_initial_stats(this->its, this->m_stats);
+    this->invalidate_caches();
 }
 
 bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
@@ -240,6 +244,7 @@ bool TriangleMesh::ReadSTLFile(const char* input_file, bool repair)
     m_stats.number_of_parts         = stl.stats.number_of_parts;
 
     stl_generate_shared_vertices(&stl, this->its);
+    this->invalidate_caches();
     return true;
 }
 
@@ -281,6 +286,7 @@ void TriangleMesh::scale(const Vec3f &versor)
     // Scale volume.
     if (m_stats.volume > 0.0)
         m_stats.volume *= s(0) * s(1) * s(2);
+    this->invalidate_caches();
     if (versor.x() == versor.y() && versor.x() == versor.z()) {
         float s = versor.x();
         for (stl_vertex &v : this->its.vertices)
@@ -301,6 +307,7 @@ void TriangleMesh::translate(const Vec3f &displacement)
             v += displacement;
         m_stats.min += displacement;
         m_stats.max += displacement;
+        this->invalidate_caches();
     }
 }
 
@@ -320,6 +327,7 @@ void TriangleMesh::rotate(float angle, const Axis &axis)
         default: assert(false);                  return;
         }
         update_bounding_box(this->its, m_stats);
+        this->invalidate_caches();
     }
 }
 
@@ -331,6 +339,7 @@ void TriangleMesh::rotate(float angle, const Vec3d& axis)
         m.rotate(Eigen::AngleAxisd(angle, axis_norm));
         its_transform(its, m);
         update_bounding_box(this->its, m_stats);
+        this->invalidate_caches();
     }
 }
 
@@ -358,6 +367,7 @@ void TriangleMesh::mirror(const Axis axis)
     std::swap(m_stats.min[iaxis], m_stats.max[iaxis]);
     m_stats.min[iaxis] *= -1.0;
     m_stats.max[iaxis] *= -1.0;
+    this->invalidate_caches();
 }
 
 void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
@@ -370,6 +380,7 @@ void TriangleMesh::transform(const Transform3d& t, bool fix_left_handed)
     }
     m_stats.volume *= det;
     update_bounding_box(this->its, m_stats);
+    this->invalidate_caches();
 }
 
 void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
@@ -382,6 +393,7 @@ void TriangleMesh::transform(const Matrix3d& m, bool fix_left_handed)
     }
     m_stats.volume *= det;
     update_bounding_box(this->its, m_stats);
+    this->invalidate_caches();
 }
 
 void TriangleMesh::flip_triangles()
@@ -441,6 +453,7 @@ void TriangleMesh::merge(const TriangleMesh &mesh)
 {
     its_merge(this->its, mesh.its);
     m_stats = m_stats.merge(mesh.m_stats);
+    this->invalidate_caches();
 }
 
 // Calculate projection of the mesh into the XY plane, in scaled coordinates.
@@ -549,9 +562,50 @@ std::vector<ExPolygons> TriangleMesh::slice(const std::vector<double> &z) const
 size_t TriangleMesh::memsize() const
 {
     size_t memsize = 8 + this->its.memsize() + sizeof(m_stats);
+    if (auto facet_z_index = std::atomic_load(&m_facet_z_index); facet_z_index)
+        memsize += facet_z_index->memsize();
     return memsize;
 }
 
+size_t TriangleMesh::release_optional()
+{
+    auto   facet_z_index = std::atomic_exchange(&m_facet_z_index, std::shared_ptr<const FacetZIndex>());
+    return facet_z_index ? facet_z_index->memsize() : 0;
+}
+
+std::shared_ptr<const FacetZIndex> TriangleMesh::facet_z_index() const
+{
+    // Two threads may race to create the index, then one of the two equal indices is dropped.
+    auto facet_z_index = std::atomic_load(&m_facet_z_index);
+    if (! facet_z_index) {
+        facet_z_index = std::make_shared<const FacetZIndex>(this->its);
+        std::atomic_store(&m_facet_z_index, facet_z_index);
+    }
+    return facet_z_index;
+}
+
+size_t TriangleMesh::content_hash() const
+{
+    // Two threads may race to calculate the hash, then both store the same value.
+    size_t hash = m_content_hash.load();
+    if (hash == 0) {
+        hash = this->its.indices.size();
+        boost::hash_combine(hash, this->its.vertices.size());
+        for (const stl_vertex &v : this->its.vertices)
+            for (int i = 0; i < 3; ++ i)
+                // Adding zero turns -0.f to 0.f, which compare equal.
+                boost::hash_combine(hash, v[i] + 0.f);
+        for (const stl_triangle_vertex_indices &face : this->its.indices)
+            for (int i = 0; i < 3; ++ i)
+                boost::hash_combine(hash, face[i]);
+        // Zero is reserved for a hash not calculated yet.
+        if (hash == 0)
+            hash = 1;
+        m_content_hash.store(hash);
+    }
+    return hash;
+}
+
 // Create a mapping from triangle edge into face.
 struct EdgeToFace {
     // Index of the 1st vertex of the triangle edge. vertex_low <= vertex_high.
@@ -1684,6 +1738,49 @@ void VertexFaceIndex::create(const indexed_triangle_set &its)
     m_vertex_to_face_start.front() = 0;
 }
 
+void FacetZIndex::create(const std::vector<stl_vertex> &vertices, const std::vector<stl_triangle_vertex_indices> &indices)
+{
+    std::vector<std::pair<float, float>> face_z_ranges(indices.size());
+    for (size_t face_idx = 0; face_idx < indices.size(); ++ face_idx) {
+        const stl_triangle_vertex_indices &face = indices[face_idx];
+        const float z0 = vertices[face(0)].z(), z1 = vertices[face(1)].z(), z2 = vertices[face(2)].z();
+        face_z_ranges[face_idx] = { std::min(z0, std::min(z1, z2)), std::max(z0, std::max(z1, z2)) };
+    }
+
+    m_face_ids.resize(indices.size());
+    std::iota(m_face_ids.begin(), m_face_ids.end(), 0);
+    std::sort(m_face_ids.begin(), m_face_ids.end(),
+        [&face_z_ranges](int f1, int f2) { return face_z_ranges[f1].first < face_z_ranges[f2].first; });
+
+    m_min_z.resize(m_face_ids.size());
+    m_max_z.resize(m_face_ids.size());
+    for (size_t i = 0; i < m_face_ids.size(); ++ i) {
+        m_min_z[i] = face_z_ranges[m_face_ids[i]].first;
+        m_max_z[i] = face_z_ranges[m_face_ids[i]].second;
+    }
+
+    const size_t num_buckets = (m_face_ids.size() + BucketSize - 1) / BucketSize;
+    m_bucket_max_z.assign(num_buckets, -std::numeric_limits<float>::max());
+    for (size_t i = 0; i < m_max_z.size(); ++ i)
+        m_bucket_max_z[i / BucketSize] = std::max(m_bucket_max_z[i / BucketSize], m_max_z[i]);
+    m_bucket_max_z_below.resize(num_buckets);
+    for (size_t i = 0; i < num_buckets; ++ i)
+        m_bucket_max_z_below[i] = i == 0 ? m_bucket_max_z[i] : std::max(m_bucket_max_z_below[i - 1], m_bucket_max_z[i]);
+}
+
+std::vector<int> FacetZIndex::faces(float zmin, float zmax) const
+{
+    std::vector<int> out;
+    this->for_each_face(zmin, zmax, [&out](int face_idx) { out.emplace_back(face_idx); });
+    return out;
+}
+
+size_t FacetZIndex::memsize() const
+{
+    return sizeof(*this) + m_face_ids.capacity() * sizeof(int) + (m_min_z.capacity() + m_max_z.capacity()) * sizeof(float) +
+           (m_bucket_max_z.capacity() + m_bucket_max_z_below.capacity()) * sizeof(float);
+}
+
 std::vector<Vec3i32> its_face_neighbors(const indexed_triangle_set &its)
 {
     return create_face_neighbors_index(ex_seq, its);
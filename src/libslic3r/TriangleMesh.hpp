@@ -14,7 +14,10 @@
 
 #include "libslic3r.h"
 #include <admesh/stl.h>
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <vector>
 #include "BoundingBox.hpp"
 #include "Line.hpp"
@@ -26,6 +29,7 @@ namespace Slic3r {
 
 class TriangleMesh;
 class TriangleMeshSlicer;
+class FacetZIndex;
 
 struct RepairedMeshErrors {
     // How many edges were united by merging their end points with some other end points in epsilon neighborhood?
@@ -103,7 +107,17 @@ public:
     TriangleMesh(std::vector<Vec3f> &&vertices, const std::vector<Vec3i32> &&faces);
     explicit TriangleMesh(const indexed_triangle_set &M);
     explicit TriangleMesh(indexed_triangle_set &&M, const RepairedMeshErrors& repaired_errors = RepairedMeshErrors());
-    void clear() { this->its.clear(); m_stats.clear(); }
+    // The facet z index may be created by facet_z_index() of another thread while copying, thus it is read atomically.
+    // The index is immutable, therefore it is shared by the copies.
+    TriangleMesh(const TriangleMesh &rhs) : its(rhs.its), m_stats(rhs.m_stats), m_facet_z_index(std::atomic_load(&rhs.m_facet_z_index)),
+        m_content_hash(rhs.m_content_hash.load()), m_init_shift(rhs.m_init_shift) {}
+    TriangleMesh(TriangleMesh &&rhs) : its(std::move(rhs.its)), m_stats(rhs.m_stats), m_facet_z_index(std::move(rhs.m_facet_z_index)),
+        m_content_hash(rhs.m_content_hash.load()), m_init_shift(rhs.m_init_shift) {}
+    TriangleMesh& operator=(const TriangleMesh &rhs)
+        { this->its = rhs.its; m_stats = rhs.m_stats; m_facet_z_index = std::atomic_load(&rhs.m_facet_z_index); m_content_hash = rhs.m_content_hash.load(); m_init_shift = rhs.m_init_shift; return *this; }
+    TriangleMesh& operator=(TriangleMesh &&rhs)
+        { this->its = std::move(rhs.its); m_stats = rhs.m_stats; m_facet_z_index = std::move(rhs.m_facet_z_index); m_content_hash = rhs.m_content_hash.load(); m_init_shift = rhs.m_init_shift; return *this; }
+    void clear() { this->its.clear(); m_stats.clear(); this->invalidate_caches(); }
     void from_facets(std::vector<stl_facet> &&facets, bool repair = true);
     bool ReadSTLFile(const char* input_file, bool repair = true);
     bool write_ascii(const char* output_file);
@@ -155,22 +169,37 @@ public:
     // Estimate of the memory occupied by this structure, important for keeping an eye on the Undo / Redo stack allocation.
     size_t memsize() const;
 
-    // Used by the Undo / Redo stack, legacy interface. As of now there is nothing cached at TriangleMesh,
-    // but we may decide to cache some data in the future (for example normals), thus we keep the interface in place.
+    // Used by the Undo / Redo stack. The facet z index is the only data cached at TriangleMesh.
     // Release optional data from the mesh if the object is on the Undo / Redo stack only. Returns the amount of memory released.
-    size_t release_optional() { return 0; }
-    // Restore optional data possibly released by release_optional().
+    size_t release_optional();
+    // Restore optional data possibly released by release_optional(). The facet z index is recreated on demand.
     void   restore_optional() {}
 
     const TriangleMeshStats& stats() const { return m_stats; }
 
+    // Index of the faces sorted by z for slicing just a z range of the mesh, see FacetZIndex.
+    // Created on demand and kept until the mesh is modified through the methods of TriangleMesh.
+    // Same as m_stats, the index is not updated if this->its is modified directly.
+    std::shared_ptr<const FacetZIndex> facet_z_index() const;
+
+    // Hash of the vertices and indices, equal for meshes with equal vertices and indices. Used to compare meshes quickly.
+    // Computed on demand and cached the same way as the facet z index.
+    size_t content_hash() const;
+
     void set_init_shift(const Vec3d &offset) { m_init_shift = offset; }
     Vec3d get_init_shift() const { return m_init_shift; }
     
     indexed_triangle_set its;
     
 private:
+    // To be called by the methods modifying the mesh.
+    void invalidate_caches() { m_facet_z_index.reset(); m_content_hash = 0; }
+
     TriangleMeshStats m_stats;
+    // Cached by facet_z_index().
+    mutable std::shared_ptr<const FacetZIndex> m_facet_z_index;
+    // Cached by content_hash(), zero if not calculated yet.
+    mutable std::atomic<size_t> m_content_hash { 0 };
     Vec3d m_init_shift {0.0, 0.0, 0.0}; // BBS, for import bbs 3mf...
 };
 
@@ -199,6 +228,51 @@ private:
     std::vector<size_t>     m_vertex_faces_all;
 };
 
+// Index of faces sorted by their minimum z, for finding the faces spanning a z range without visiting all faces.
+// The maximum z is kept for buckets of successive faces of the sorted sequence, thus the buckets of faces ending
+// below the z range are skipped. The index does not depend on the orientation of the faces.
+class FacetZIndex
+{
+public:
+    explicit FacetZIndex(const indexed_triangle_set &its) { this->create(its.vertices, its.indices); }
+    FacetZIndex(const std::vector<stl_vertex> &vertices, const std::vector<stl_triangle_vertex_indices> &indices) { this->create(vertices, indices); }
+    FacetZIndex() {}
+
+    void create(const std::vector<stl_vertex> &vertices, const std::vector<stl_triangle_vertex_indices> &indices);
+    void clear() { m_face_ids.clear(); m_min_z.clear(); m_max_z.clear(); m_bucket_max_z.clear(); m_bucket_max_z_below.clear(); }
+
+    bool   empty() const { return m_face_ids.empty(); }
+    // Number of the indexed faces.
+    size_t size() const { return m_face_ids.size(); }
+    size_t memsize() const;
+
+    // Call fn(face_idx) for all faces with min_z <= zmax and max_z >= zmin, in the order of their minimum z.
+    template<typename Fn> void for_each_face(float zmin, float zmax, Fn &&fn) const {
+        auto   end    = size_t(std::upper_bound(m_min_z.begin(), m_min_z.end(), zmax) - m_min_z.begin());
+        // The buckets below do not contain any face reaching zmin.
+        auto   bucket = size_t(std::lower_bound(m_bucket_max_z_below.begin(), m_bucket_max_z_below.end(), zmin) - m_bucket_max_z_below.begin());
+        for (size_t begin = bucket * BucketSize; begin < end; begin += BucketSize, ++ bucket)
+            if (m_bucket_max_z[bucket] >= zmin)
+                for (size_t i = begin; i < std::min(begin + BucketSize, end); ++ i)
+                    if (m_max_z[i] >= zmin)
+                        fn(m_face_ids[i]);
+    }
+    // Indices of faces with min_z <= zmax and max_z >= zmin, in the order of their minimum z.
+    std::vector<int> faces(float zmin, float zmax) const;
+
+private:
+    static constexpr size_t BucketSize = 64;
+
+    // Face indices sorted by their minimum z.
+    std::vector<int>        m_face_ids;
+    std::vector<float>      m_min_z;
+    std::vector<float>      m_max_z;
+    // Maximum of m_max_z for each bucket of BucketSize faces.
+    std::vector<float>      m_bucket_max_z;
+    // Maximum of m_max_z of a bucket and all the buckets before it, non-decreasing.
+    std::vector<float>      m_bucket_max_z_below;
+};
+
 // Map from a face edge to a unique edge identifier or -1 if no neighbor exists.
 // Two neighbor faces share a unique edge identifier even if they are flipped.
 // Used for chaining slice lines into polygons.
@@ -395,6 +469,7 @@ namespace cereal {
     template<class Archive> void load(Archive &archive, Slic3r::TriangleMesh &mesh) {
         archive.loadBinary(reinterpret_cast<char*>(const_cast<Slic3r::TriangleMeshStats*>(&mesh.stats())), sizeof(Slic3r::TriangleMeshStats));
         archive(mesh.its.indices, mesh.its.vertices);
+        mesh.release_optional();
     }
     template<class Archive> void save(Archive &archive, const Slic3r::TriangleMesh &mesh) {
         archive.saveBinary(reinterpret_cast<const char*>(&mesh.stats()), sizeof(Slic3r::TriangleMeshStats));
@@ -440,6 +440,33 @@ static inline std::vector<IntersectionLines> slice_make_lines(
     return lines;
 }
 
+// Slice just the faces of face_ids.
+template<typename TransformVertex, typename ThrowOnCancel>
+static inline std::vector<IntersectionLines> slice_make_lines(
+    const std::vector<stl_vertex>                   &vertices,
+    const TransformVertex                           &transform_vertex_fn,
+    const std::vector<stl_triangle_vertex_indices>  &indices,
+    const std::vector<Vec3i32>                      &face_edge_ids,
+    const std::vector<int>                          &face_ids,
+    const std::vector<float>                        &zs,
+    const ThrowOnCancel                              throw_on_cancel_fn)
+{
+    std::vector<IntersectionLines>  lines(zs.size(), IntersectionLines{});
+    LinesMutexes                    lines_mutex;
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, face_ids.size()),
+        [&vertices, &transform_vertex_fn, &indices, &face_edge_ids, &face_ids, &zs, &lines, &lines_mutex, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i) {
+                if ((i & 0x0ffff) == 0)
+                    throw_on_cancel_fn();
+                int face_idx = face_ids[i];
+                slice_facet_at_zs(vertices, transform_vertex_fn, indices[face_idx], face_edge_ids[face_idx], zs, lines, lines_mutex);
+            }
+        }
+    );
+    return lines;
+}
+
 template<typename TransformVertex, typename FaceFilter>
 static inline IntersectionLines slice_make_lines(
     const std::vector<stl_vertex>                   &mesh_vertices,
@@ -1937,80 +1964,157 @@ Polygons slice_mesh(
     return layers.front();
 }
 
-std::vector<ExPolygons> slice_mesh_ex(
+// Range of z of the mesh, which the trafo maps onto [zmin, zmax], enlarged to cover the rounding of the transformed z.
+// Returns false if the transformed z depends on x or y, then a FacetZIndex of the untransformed mesh is of no use.
+static bool trafo_z_range_to_mesh(const Transform3d &trafo, float zmin, float zmax, std::pair<float, float> &out)
+{
+    const auto &m = trafo.matrix();
+    if (m(2, 0) != 0. || m(2, 1) != 0. || m(2, 2) == 0.)
+        return false;
+    double z1 = (double(zmin) - m(2, 3)) / m(2, 2);
+    double z2 = (double(zmax) - m(2, 3)) / m(2, 2);
+    if (z1 > z2)
+        std::swap(z1, z2);
+    const double eps = 1e-5 * (1. + std::abs(z1) + std::abs(z2));
+    out = { float(z1 - eps), float(z2 + eps) };
+    return true;
+}
+
+// Mask of the faces of face_ids for its_face_edge_ids().
+static std::vector<char> face_mask_from_ids(size_t num_faces, const std::vector<int> &face_ids)
+{
+    std::vector<char> face_mask(num_faces, 0);
+    for (int face_idx : face_ids)
+        face_mask[face_idx] = 1;
+    return face_mask;
+}
+
+std::vector<Polygons> slice_mesh(
     const indexed_triangle_set       &mesh,
+    const FacetZIndex                &facet_z_index,
+    // Unscaled Zs
     const std::vector<float>         &zs,
-    const MeshSlicingParamsEx        &params,
+    const MeshSlicingParams          &params,
     std::function<void()>             throw_on_cancel)
 {
-    std::vector<Polygons> layers_p;
+    assert(facet_z_index.size() == mesh.indices.size());
+    assert(std::is_sorted(zs.begin(), zs.end()));
+
+    std::pair<float, float> z_range;
+    if (zs.empty() || ! trafo_z_range_to_mesh(params.trafo, zs.front(), zs.back(), z_range))
+        // The index could not be used with this transformation.
+        return slice_mesh(mesh, zs, params, throw_on_cancel);
+
+    std::vector<int> face_ids = facet_z_index.faces(z_range.first, z_range.second);
+    if (face_ids.size() == mesh.indices.size())
+        // All faces span the sliced z range.
+        return slice_mesh(mesh, zs, params, throw_on_cancel);
+
+    BOOST_LOG_TRIVIAL(debug) << "slice_mesh to polygons, " << face_ids.size() << " of " << mesh.indices.size() << " faces";
+
+    std::vector<IntersectionLines> lines;
     {
-        MeshSlicingParams slicing_params(params);
-        if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
-        if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
-        layers_p = slice_mesh(mesh, zs, slicing_params, throw_on_cancel);
-        for(Polygons &polys : layers_p) ensure_valid(polys);
+        std::vector<Vec3i32> face_edge_ids = its_face_edge_ids(mesh, face_mask_from_ids(mesh.indices.size(), face_ids));
+        // Just a part of the mesh is sliced, it is not worthwile to copy the vertices. Apply the transformation in place.
+        if (is_identity(params.trafo)) {
+            lines = slice_make_lines(
+                mesh.vertices, [](const Vec3f &p) { return Vec3f(scaled<float>(p.x()), scaled<float>(p.y()), p.z()); },
+                mesh.indices, face_edge_ids, face_ids, zs, throw_on_cancel);
+        } else {
+            // Transform the vertices, scale up in XY, not in Z.
+            Transform3f tf = make_trafo_for_slicing(params.trafo);
+            lines = slice_make_lines(mesh.vertices, [tf](const Vec3f &p) { return tf * p; }, mesh.indices, face_edge_ids, face_ids, zs, throw_on_cancel);
+        }
     }
-    
-//    BOOST_LOG_TRIVIAL(debug) << "slice_mesh make_expolygons in parallel - start";
-    std::vector<ExPolygons> layers(layers_p.size(), ExPolygons{});
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, layers_p.size()),
-        [&layers_p, &params, &layers, throw_on_cancel]
-        (const tbb::blocked_range<size_t>& range) {
-            coord_t resolution = scale_t(params.resolution);
-            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
-                throw_on_cancel();
-                ExPolygons &expolygons = layers[layer_id];
-                const auto this_mode = layer_id < params.slicing_mode_normal_below_layer ? params.mode_below : params.mode;
-                Slic3r::make_expolygons(
-                    layers_p[layer_id], scale_t(params.closing_radius), scale_t(params.model_resolution), scale_t(params.extra_offset),
-                    this_mode == MeshSlicingParams::SlicingMode::EvenOdd ? ClipperLib::pftEvenOdd : 
-                    this_mode == MeshSlicingParams::SlicingMode::PositiveLargestContour ? ClipperLib::pftPositive : ClipperLib::pftNonZero,
-                    &expolygons);
+
+    throw_on_cancel();
+
+    return make_loops(lines, params, throw_on_cancel);
+}
+
+static MeshSlicingParams slicing_params_for_expolygons(const MeshSlicingParamsEx &params)
+{
+    MeshSlicingParams slicing_params(params);
+    if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
+    if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
+    return slicing_params;
+}
+
+// Polygons of a layer sliced by slice_mesh() to expolygons.
+static ExPolygons make_layer_expolygons(Polygons &polygons, const MeshSlicingParamsEx &params, size_t layer_id)
+{
+    ensure_valid(polygons);
+
+    ExPolygons expolygons;
+    coord_t    resolution = scale_t(params.resolution);
+    const auto this_mode  = layer_id < params.slicing_mode_normal_below_layer ? params.mode_below : params.mode;
+    Slic3r::make_expolygons(
+        polygons, scale_t(params.closing_radius), scale_t(params.model_resolution), scale_t(params.extra_offset),
+        this_mode == MeshSlicingParams::SlicingMode::EvenOdd ? ClipperLib::pftEvenOdd : 
+        this_mode == MeshSlicingParams::SlicingMode::PositiveLargestContour ? ClipperLib::pftPositive : ClipperLib::pftNonZero,
+        &expolygons);
 
 #if 0
 //#ifndef NDEBUG
-                // Test whether the expolygons in a single layer overlap.
-                for (size_t i = 0; i < expolygons.size(); ++ i)
-                    for (size_t j = i + 1; j < expolygons.size(); ++ j) {
-                        Polygons overlap = intersection(expolygons[i], expolygons[j]);
-                        assert(overlap.empty());
-                    }
+    // Test whether the expolygons in a single layer overlap.
+    for (size_t i = 0; i < expolygons.size(); ++ i)
+        for (size_t j = i + 1; j < expolygons.size(); ++ j) {
+            Polygons overlap = intersection(expolygons[i], expolygons[j]);
+            assert(overlap.empty());
+        }
 #endif
 #if 0
 //#ifndef NDEBUG
-                for (const ExPolygon &ex : expolygons) {
-                    assert(! has_duplicate_points(ex.contour));
-                    for (const Polygon &hole : ex.holes)
-                        assert(! has_duplicate_points(hole));
-                    assert(! has_duplicate_points(ex));
-                }
-                assert(!has_duplicate_points(expolygons));
+    for (const ExPolygon &ex : expolygons) {
+        assert(! has_duplicate_points(ex.contour));
+        for (const Polygon &hole : ex.holes)
+            assert(! has_duplicate_points(hole));
+        assert(! has_duplicate_points(ex));
+    }
+    assert(!has_duplicate_points(expolygons));
 #endif // NDEBUG
-                // simplify
-                if (this_mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-                    keep_largest_contour_only(expolygons);
-                if (resolution != 0.) {
-                    expolygons = union_safety_offset_ex(expolygons);
-                    //for (expolygons) ex.simplify(resolution));
-                    ensure_valid(expolygons, resolution);
-                } else {
-                    ensure_valid(expolygons);
-                }
-                assert_valid(expolygons);
+    // simplify
+    if (this_mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        keep_largest_contour_only(expolygons);
+    if (resolution != 0.) {
+        expolygons = union_safety_offset_ex(expolygons);
+        //for (expolygons) ex.simplify(resolution));
+        ensure_valid(expolygons, resolution);
+    } else {
+        ensure_valid(expolygons);
+    }
+    assert_valid(expolygons);
 #if 0
 //#ifndef NDEBUG
-                for (const ExPolygon &ex : expolygons) {
-                    assert(! has_duplicate_points(ex.contour));
-                    for (const Polygon &hole : ex.holes)
-                        assert(! has_duplicate_points(hole));
-                    assert(! has_duplicate_points(ex));
-            }
-                assert(! has_duplicate_points(expolygons));
+    for (const ExPolygon &ex : expolygons) {
+        assert(! has_duplicate_points(ex.contour));
+        for (const Polygon &hole : ex.holes)
+            assert(! has_duplicate_points(hole));
+        assert(! has_duplicate_points(ex));
+    }
+    assert(! has_duplicate_points(expolygons));
 #endif // NDEBUG
+
+    return expolygons;
+}
+
+// Layers sliced by slice_mesh() to expolygons, in parallel.
+static std::vector<ExPolygons> make_layers_expolygons(
+    std::vector<Polygons>            &layers_p,
+    const MeshSlicingParamsEx        &params,
+    const std::function<void()>      &throw_on_cancel)
+{
+//    BOOST_LOG_TRIVIAL(debug) << "slice_mesh make_expolygons in parallel - start";
+    std::vector<ExPolygons> layers(layers_p.size(), ExPolygons{});
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, layers_p.size()),
+        [&layers_p, &params, &layers, throw_on_cancel]
+        (const tbb::blocked_range<size_t>& range) {
+            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+                throw_on_cancel();
+                layers[layer_id] = make_layer_expolygons(layers_p[layer_id], params, layer_id);
             }
         });
 //    BOOST_LOG_TRIVIAL(debug) << "slice_mesh make_expolygons in parallel - end";
@@ -2018,6 +2122,116 @@ std::vector<ExPolygons> slice_mesh_ex(
     return layers;
 }
 
+std::vector<ExPolygons> slice_mesh_ex(
+    const indexed_triangle_set       &mesh,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    std::vector<Polygons> layers_p = slice_mesh(mesh, zs, slicing_params_for_expolygons(params), throw_on_cancel);
+    return make_layers_expolygons(layers_p, params, throw_on_cancel);
+}
+
+std::vector<ExPolygons> slice_mesh_ex(
+    const indexed_triangle_set       &mesh,
+    const FacetZIndex                &facet_z_index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    std::vector<Polygons> layers_p = slice_mesh(mesh, facet_z_index, zs, slicing_params_for_expolygons(params), throw_on_cancel);
+    return make_layers_expolygons(layers_p, params, throw_on_cancel);
+}
+
+// Slices the mesh by batches of successive layers, passes the loops of each batch to batch_fn(first_layer_id, loops).
+// The faces of the transformed mesh are indexed by FacetZIndex once, then each batch only slices the faces spanning
+// its z range and only the intersection lines of a single batch are kept in memory.
+template<typename BatchFn, typename ThrowOnCancel>
+static void slice_mesh_by_batches(
+    const indexed_triangle_set       &mesh,
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    size_t                            batch_size,
+    BatchFn                           batch_fn,
+    ThrowOnCancel                     throw_on_cancel)
+{
+    assert(std::is_sorted(zs.begin(), zs.end()));
+    if (zs.empty())
+        return;
+    batch_size = std::max<size_t>(batch_size, 1);
+
+    // Copy and scale vertices in XY, don't scale in Z. Possibly apply the transformation.
+    std::vector<stl_vertex> vertices = transform_mesh_vertices_for_slicing(mesh, params.trafo);
+    FacetZIndex             facet_z_index(vertices, mesh.indices);
+    // Edge IDs of just the faces spanning the sliced z range.
+    std::vector<int>        face_ids = facet_z_index.faces(zs.front(), zs.back());
+    std::vector<Vec3i32>    face_edge_ids = face_ids.size() == mesh.indices.size() ?
+        its_face_edge_ids(mesh) : its_face_edge_ids(mesh, face_mask_from_ids(mesh.indices.size(), face_ids));
+    face_ids.clear();
+    face_ids.shrink_to_fit();
+
+    throw_on_cancel();
+
+    for (size_t first_layer = 0; first_layer < zs.size(); first_layer += batch_size) {
+        const size_t       last_layer = std::min(first_layer + batch_size, zs.size());
+        std::vector<float> batch_zs(zs.begin() + first_layer, zs.begin() + last_layer);
+
+        std::vector<IntersectionLines> lines = slice_make_lines(
+            vertices, [](const Vec3f &p) { return p; }, mesh.indices, face_edge_ids,
+            facet_z_index.faces(batch_zs.front(), batch_zs.back()), batch_zs, throw_on_cancel);
+
+        throw_on_cancel();
+
+        // Layer indices of the batch start from zero.
+        MeshSlicingParams batch_params(params);
+        batch_params.slicing_mode_normal_below_layer = params.slicing_mode_normal_below_layer > first_layer ?
+            params.slicing_mode_normal_below_layer - first_layer : 0;
+        std::vector<Polygons> loops = make_loops(lines, batch_params, throw_on_cancel);
+        lines.clear();
+        lines.shrink_to_fit();
+
+        batch_fn(first_layer, loops);
+    }
+}
+
+void slice_mesh_streamed(
+    const indexed_triangle_set                          &mesh,
+    const std::vector<float>                            &zs,
+    const MeshSlicingParams                             &params,
+    const std::function<void(size_t, Polygons&&)>       &layer_fn,
+    std::function<void()>                                throw_on_cancel,
+    size_t                                               batch_size)
+{
+    slice_mesh_by_batches(mesh, zs, params, batch_size,
+        [&layer_fn](size_t first_layer, std::vector<Polygons> &loops) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, loops.size()),
+                [&layer_fn, &loops, first_layer](const tbb::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i)
+                        layer_fn(first_layer + i, std::move(loops[i]));
+                });
+        }, throw_on_cancel);
+}
+
+void slice_mesh_ex_streamed(
+    const indexed_triangle_set                          &mesh,
+    const std::vector<float>                            &zs,
+    const MeshSlicingParamsEx                           &params,
+    const std::function<void(size_t, ExPolygons&&)>     &layer_fn,
+    std::function<void()>                                throw_on_cancel,
+    size_t                                               batch_size)
+{
+    slice_mesh_by_batches(mesh, zs, slicing_params_for_expolygons(params), batch_size,
+        [&layer_fn, &params, &throw_on_cancel](size_t first_layer, std::vector<Polygons> &loops) {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, loops.size()),
+                [&layer_fn, &params, &throw_on_cancel, &loops, first_layer](const tbb::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i) {
+                        throw_on_cancel();
+                        layer_fn(first_layer + i, make_layer_expolygons(loops[i], params, first_layer + i));
+                    }
+                });
+        }, throw_on_cancel);
+}
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
@@ -12,6 +12,8 @@
 
 namespace Slic3r {
 
+class FacetZIndex;
+
 struct MeshSlicingParams
 {
     enum class SlicingMode : uint32_t {
@@ -81,6 +83,24 @@ std::vector<ExPolygons>         slice_mesh_ex(
     const MeshSlicingParamsEx        &params,
     std::function<void()>             throw_on_cancel = []{});
 
+// Variants of slice_mesh() and slice_mesh_ex() slicing just the faces spanning the range of zs, found by facet_z_index
+// of the mesh (see TriangleMesh::facet_z_index()). Used for slicing a part of a mesh, for example a layer range.
+// The index does not depend on the orientation of the faces, thus it may have been created before flipping them.
+// If params.trafo makes z of the transformed mesh depend on x or y, all the faces are sliced.
+std::vector<Polygons>           slice_mesh(
+    const indexed_triangle_set       &mesh,
+    const FacetZIndex                &facet_z_index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    std::function<void()>             throw_on_cancel = []{});
+
+std::vector<ExPolygons>         slice_mesh_ex(
+    const indexed_triangle_set       &mesh,
+    const FacetZIndex                &facet_z_index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel = []{});
+
 inline std::vector<ExPolygons>  slice_mesh_ex(
     const indexed_triangle_set       &mesh,
     const std::vector<float>         &zs,
@@ -100,6 +120,28 @@ inline std::vector<ExPolygons>  slice_mesh_ex(
     return slice_mesh_ex(mesh, zs, params, throw_on_cancel);
 }
 
+// Streaming variants of slice_mesh() and slice_mesh_ex(), producing the same layers.
+// The mesh is sliced by batches of at most batch_size successive layers, bottom up, and only the triangles
+// spanning the z range of a batch are intersected, thus the intersection lines are held for a single batch only.
+// Each layer is passed to layer_fn with its index into zs as soon as its batch is sliced, including the empty layers.
+// layer_fn is called concurrently for the layers of a batch, all the layers of a batch are passed
+// before the next batch is sliced.
+void                            slice_mesh_streamed(
+    const indexed_triangle_set                      &mesh,
+    const std::vector<float>                        &zs,
+    const MeshSlicingParams                         &params,
+    const std::function<void(size_t, Polygons&&)>   &layer_fn,
+    std::function<void()>                            throw_on_cancel = []{},
+    size_t                                           batch_size = 64);
+
+void                            slice_mesh_ex_streamed(
+    const indexed_triangle_set                      &mesh,
+    const std::vector<float>                        &zs,
+    const MeshSlicingParamsEx                       &params,
+    const std::function<void(size_t, ExPolygons&&)> &layer_fn,
+    std::function<void()>                            throw_on_cancel = []{},
+    size_t                                           batch_size = 64);
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
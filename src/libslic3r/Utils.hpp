@@ -32,6 +32,8 @@ extern std::string format_memsize_MB(size_t n);
 // The string is non-empty if the loglevel >= info (3) or ignore_loglevel==true.
 // Latter is used to get the memory info from SysInfoDialog.
 extern std::string log_memory_info(bool ignore_loglevel = false);
+// Returns the current resident memory (working set on Windows) of this process in bytes, 0 if not available.
+extern size_t resident_memory();
 extern void enforce_thread_count(std::size_t count);
 // Returns the size of physical memory (RAM) in bytes.
 extern size_t total_physical_memory();
@@ -134,10 +136,13 @@ enum CopyFileResult {
 CopyFileResult copy_file_inner(const std::string& from, const std::string& to, std::string& error_message);
 CopyFileResult copy_file_inner(const boost::filesystem::path& from, const boost::filesystem::path& to, std::string& error_message);
 // Copy file to a temp file first, then rename it to the final file name.
-// If with_check is true, then the content of the copied file is compared to the content
-// of the source file before renaming.
+// If with_check is true, then a checksum of the source file is calculated while copying and the copied file
+// is read back and compared against it before renaming.
 // Additional error info is passed in error message.
 extern CopyFileResult copy_file(const std::string &from, const std::string &to, std::string& error_message, const bool with_check = false);
+// Move a file to its final destination. The file is just renamed if the destination is on the same filesystem,
+// otherwise it is copied with copy_file() (verified if with_check is true) and the source file is removed.
+extern CopyFileResult move_file(const std::string &from, const std::string &to, std::string& error_message, const bool with_check = false);
 
 // Compares two files if identical.
 extern CopyFileResult check_copy(const std::string& origin, const std::string& copy);
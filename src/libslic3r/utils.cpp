@@ -48,6 +48,7 @@
 #include <boost/locale.hpp>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/crc.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/nowide/fstream.hpp>
@@ -755,8 +756,11 @@ std::error_code rename_file(const std::string &from, const std::string &to)
 #ifdef _WIN32
 	return WindowsSupport::rename(from, to);
 #else
-	boost::nowide::remove(to.c_str());
-	return std::make_error_code(static_cast<std::errc>(boost::nowide::rename(from.c_str(), to.c_str())));
+	// rename() replaces the target atomically. The target must not be removed beforehand, it would be lost
+	// if the rename fails, for example if both files are not on the same filesystem.
+	if (boost::nowide::rename(from.c_str(), to.c_str()) != 0)
+		return std::error_code(errno, std::system_category());
+	return std::error_code();
 #endif
 }
 
@@ -994,17 +998,103 @@ CopyFileResult copy_file_inner(const boost::filesystem::path& source, const boos
 	return SUCCESS;
 }
 
+// Buffer size of the streaming copy and of the checksum calculation.
+static constexpr const size_t copy_file_buffer_size = 8 * 1024 * 1024;
+
+// Copy a file with a read / write loop, calculating the CRC32 of the data while streaming,
+// so that the source file does not need to be read again to verify the copy.
+static CopyFileResult copy_file_with_checksum(const std::string &from, const std::string &to, uint32_t &checksum, std::string &error_message)
+{
+	static const auto perms = boost::filesystem::owner_read | boost::filesystem::owner_write | boost::filesystem::group_read | boost::filesystem::others_read;   // aka 644
+
+	boost::nowide::ifstream in(from, std::ifstream::in | std::ifstream::binary);
+	if (in.fail())
+		return FAIL_CHECK_ORIGIN_NOT_OPENED;
+	// Error code of permission() calls is ignored on purpose, see copy_file_inner().
+	boost::system::error_code ec;
+	boost::filesystem::permissions(to, perms, ec);
+	boost::nowide::ofstream out(to, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (out.fail()) {
+		error_message = "Failed to open " + to + " for writing";
+		return FAIL_COPY_FILE;
+	}
+
+	boost::crc_32_type crc;
+	std::vector<char>  buffer(copy_file_buffer_size, 0);
+	do {
+		in.read(buffer.data(), buffer.size());
+		std::streamsize cnt = in.gcount();
+		if (cnt > 0) {
+			crc.process_bytes(buffer.data(), size_t(cnt));
+			out.write(buffer.data(), cnt);
+		}
+	} while (in.good() && out.good());
+	bool read_failed = ! in.eof();
+	out.close();
+	if (read_failed || out.fail()) {
+		error_message = read_failed ? "Failed to read " + from : "Failed to write " + to;
+		return FAIL_COPY_FILE;
+	}
+	ec.clear();
+	boost::filesystem::permissions(to, perms, ec);
+	checksum = crc.checksum();
+	return SUCCESS;
+}
+
+// CRC32 of the file content. Returns false if the file could not be read.
+static bool file_checksum(const std::string &path, uint32_t &checksum)
+{
+	boost::nowide::ifstream in(path, std::ifstream::in | std::ifstream::binary);
+	if (in.fail())
+		return false;
+	boost::crc_32_type crc;
+	std::vector<char>  buffer(copy_file_buffer_size, 0);
+	do {
+		in.read(buffer.data(), buffer.size());
+		crc.process_bytes(buffer.data(), size_t(in.gcount()));
+	} while (in.good());
+	if (! in.eof())
+		return false;
+	checksum = crc.checksum();
+	return true;
+}
+
 CopyFileResult copy_file(const std::string &from, const std::string &to, std::string& error_message, const bool with_check)
 {
 	std::string to_temp = to + ".tmp";
-	CopyFileResult ret_val = copy_file_inner(from, to_temp, error_message);
-    if(ret_val == SUCCESS)
-	{
-        if (with_check)
-            ret_val = check_copy(from, to_temp);
+	CopyFileResult ret_val;
+	if (with_check) {
+		// Only the copy is read back, the checksum of the source is calculated while copying.
+		uint32_t checksum_origin = 0;
+		uint32_t checksum_copy   = 0;
+		ret_val = copy_file_with_checksum(from, to_temp, checksum_origin, error_message);
+		if (ret_val == SUCCESS)
+			ret_val = ! file_checksum(to_temp, checksum_copy) ? FAIL_CHECK_TARGET_NOT_OPENED :
+				checksum_copy != checksum_origin ? FAIL_FILES_DIFFERENT : SUCCESS;
+	} else
+		ret_val = copy_file_inner(from, to_temp, error_message);
+	if (ret_val == FAIL_CHECK_ORIGIN_NOT_OPENED || ret_val == FAIL_COPY_FILE) {
+		// Nothing usable was written, don't leave a partial copy behind. The target was not touched.
+		boost::system::error_code ec;
+		boost::filesystem::remove(to_temp, ec);
+	} else if (ret_val == SUCCESS && rename_file(to_temp, to))
+		ret_val = FAIL_RENAMING;
+	return ret_val;
+}
 
-        if (ret_val == 0 && rename_file(to_temp, to))
-        	ret_val = FAIL_RENAMING;
+CopyFileResult move_file(const std::string &from, const std::string &to, std::string& error_message, const bool with_check)
+{
+	// Rename is atomic and it does not touch the data if both files are on the same filesystem.
+	if (! rename_file(from, to))
+		return SUCCESS;
+	// Different filesystems, or the file is locked: Copy the file and remove the source.
+	BOOST_LOG_TRIVIAL(debug) << "move_file(): Failed to rename " << from << " to " << to << ", copying.";
+	CopyFileResult ret_val = copy_file(from, to, error_message, with_check);
+	if (ret_val == SUCCESS) {
+		boost::system::error_code ec;
+		boost::filesystem::remove(from, ec);
+		if (ec)
+			BOOST_LOG_TRIVIAL(error) << "move_file(): Failed to remove " << from << ": " << ec.message();
 	}
 	return ret_val;
 }
@@ -1486,6 +1576,26 @@ std::string log_memory_info(bool ignore_loglevel)
     return out;
 }
 
+size_t resident_memory()
+{
+#ifdef WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return size_t(pmc.WorkingSetSize);
+#elif defined(__APPLE__)
+    struct mach_task_basic_info info;
+    mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &infoCount) == KERN_SUCCESS)
+        return size_t(info.resident_size);
+#elif defined(__linux__)
+    size_t tSize = 0, resident = 0;
+    std::ifstream buffer("/proc/self/statm");
+    if (buffer && (buffer >> tSize >> resident))
+        return resident * (size_t)sysconf(_SC_PAGE_SIZE);
+#endif
+    return 0;
+}
+
 // Returns the size of physical memory (RAM) in bytes.
 // http://nadeausoftware.com/articles/2012/09/c_c_tip_how_get_physical_memory_size_system
 size_t total_physical_memory()
@@ -29,6 +29,7 @@
 #include "libslic3r/GCode/PostProcessor.hpp"
 #include "libslic3r/Format/SL1.hpp"
 #include "libslic3r/Thread.hpp"
+#include "slic3r/Utils/UploadStream.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include <cassert>
@@ -39,6 +40,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
 #include "I18N.hpp"
 #include "RemovableDriveManager.hpp"
 
@@ -170,7 +172,26 @@ void BackgroundSlicingProcess::process_fff()
 	// Passing the timestamp 
 	evt.SetInt((int)(m_fff_print->step_state_with_timestamp(PrintStep::psSlicingFinished).timestamp));
 	wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, evt.Clone());
-	m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); });
+	// If possible, the upload job is started right away and the G-code is uploaded while it is being written.
+	std::string streamed_upload_host;
+	std::shared_ptr<UploadStream> upload_stream = this->start_streaming_upload(streamed_upload_host);
+	std::function<bool(const char*, size_t)> output_sink;
+	if (upload_stream)
+		output_sink = [upload_stream](const char *data, size_t size) { return upload_stream->write(data, size); };
+	try {
+		m_fff_print->export_gcode(m_temp_output_path, m_gcode_result, [this](const ThumbnailsParams& params) { return this->render_thumbnails(params); },
+			std::move(output_sink));
+	} catch (...) {
+		if (upload_stream)
+			upload_stream->abort();
+		throw;
+	}
+	if (upload_stream) {
+		if (upload_stream->bytes_written() == 0 && ! upload_stream->aborted())
+			// The G-code export was skipped, because the G-code is still valid. Upload the existing file.
+			stream_file_to_upload(m_temp_output_path, *upload_stream);
+		upload_stream->close();
+	}
 	if (this->set_step_started(bspsGCodeFinalize)) {
 	    if (! m_export_path.empty()) {
 			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new wxCommandEvent(m_event_export_began_id));
@@ -178,6 +199,8 @@ void BackgroundSlicingProcess::process_fff()
 	    } else if (! m_upload_job.empty()) {
 			wxQueueEvent(GUI::wxGetApp().mainframe->m_plater, new wxCommandEvent(m_event_export_began_id));
 			prepare_upload();
+	    } else if (upload_stream) {
+			m_print->set_status(100, GUI::format(_L("G-code streamed to `%1%`. See Window -> Print Host Upload Queue"), streamed_upload_host));
 	    } else {
 			//m_print->set_status(100, _u8L("Slicing complete"));
 	    }
@@ -726,7 +749,9 @@ void BackgroundSlicingProcess::finalize_gcode()
 	// export_path may be changed by the post-processing script as well if the post processing script decides so, see GH #6042.
 	DynamicPrintConfig conf_for_script = m_fff_print->full_print_config();
 	conf_for_script.apply(m_fff_print->physical_printer_config()); // add physical printer options for use in the script.
-	bool post_processed = run_post_process_scripts(output_path, true, "File", export_path, conf_for_script);
+	// The post-processed copy is created next to the target to be renamed into place, unless the target is on a removable media,
+	// where the copy is verified. Then the copy stays in the temp directory.
+	bool post_processed = run_post_process_scripts(output_path, true, "File", export_path, conf_for_script, ! m_export_path_on_removable_media);
 	auto remove_post_processed_temp_file = [post_processed, &output_path]() {
 		if (post_processed)
 			try {
@@ -741,7 +766,12 @@ void BackgroundSlicingProcess::finalize_gcode()
 	int copy_ret_val = CopyFileResult::SUCCESS;
 	try
 	{
-		copy_ret_val = copy_file(output_path, export_path, error_message, m_export_path_on_removable_media);
+		// The post-processed G-code is a private copy created next to its destination, it is just renamed over it.
+		// The unprocessed G-code at m_temp_output_path is memory mapped by the G-code viewer, it has to be copied.
+		// Copies to a removable media are verified.
+		copy_ret_val = post_processed && ! m_export_path_on_removable_media ?
+			move_file(output_path, export_path, error_message) :
+			copy_file(output_path, export_path, error_message, m_export_path_on_removable_media);
 		remove_post_processed_temp_file();
 	}
 	catch (...)
@@ -761,7 +791,7 @@ void BackgroundSlicingProcess::finalize_gcode()
 		throw Slic3r::ExportError(GUI::format(_L("Renaming of the G-code after copying to the selected destination folder has failed. Current path is %1%.tmp. Please try exporting again."), export_path));
 		break;
 	case CopyFileResult::FAIL_CHECK_ORIGIN_NOT_OPENED:
-		throw Slic3r::ExportError(GUI::format(_L("Copying of the temporary G-code has finished but the original code at %1% couldn't be opened during copy check. The output G-code is at %2%.tmp."), output_path, export_path));
+		throw Slic3r::ExportError(GUI::format(_L("The temporary G-code at %1% couldn't be opened for copying. Nothing was written to %2%."), output_path, export_path));
 		break;
 	case CopyFileResult::FAIL_CHECK_TARGET_NOT_OPENED:
 		throw Slic3r::ExportError(GUI::format(_L("Copying of the temporary G-code has finished but the exported code couldn't be opened during copy check. The output G-code is at %1%.tmp."), export_path));
@@ -775,6 +805,48 @@ void BackgroundSlicingProcess::finalize_gcode()
 	m_print->set_status(100, GUI::format(_L("G-code file exported to %1%"), export_path));
 }
 
+// Start the scheduled upload job before the G-code is exported and return the stream feeding it, if the print host
+// accepts chunked uploads and the uploaded G-code is the exported one: No post-processing scripts, ASCII G-code
+// and an upload file name independent of the print statistics, which are only known after the export.
+// Returns nullptr if the G-code will be uploaded by prepare_upload() after the export.
+std::shared_ptr<UploadStream> BackgroundSlicingProcess::start_streaming_upload(std::string &host)
+{
+	if (m_print != m_fff_print || m_upload_job.empty() || ! m_upload_job.printhost->can_stream_upload())
+		return nullptr;
+	if (! m_fff_print->config().post_process.values.empty() || m_fff_print->full_print_config().option("binary_gcode")->get_bool())
+		return nullptr;
+	if (m_upload_job.upload_data.upload_path.stem().string().find_first_of("[{") != std::string::npos)
+		return nullptr;
+
+	// The G-code is spooled into a temp file, which is uploaded while it is being written.
+	auto stream = std::make_shared<UploadStream>(boost::filesystem::temp_directory_path()
+		/ boost::filesystem::unique_path("." SLIC3R_APP_KEY ".upload.%%%%-%%%%-%%%%-%%%%"));
+	if (stream->aborted())
+		// Failed to create the spool file, upload the G-code after the export.
+		return nullptr;
+	m_upload_job.upload_data.source_stream = stream;
+	host = m_upload_job.printhost->get_host();
+	BOOST_LOG_TRIVIAL(info) << "Streaming the G-code upload of " << m_upload_job.upload_data.upload_path << " to " << host;
+	GUI::wxGetApp().printhost_job_queue().enqueue(std::move(m_upload_job));
+	return stream;
+}
+
+void BackgroundSlicingProcess::stream_file_to_upload(const std::string &path, UploadStream &stream)
+{
+	boost::nowide::ifstream file(path, std::ios::in | std::ios::binary);
+	if (file.fail()) {
+		stream.abort();
+		throw Slic3r::RuntimeError("Cannot open the G-code for upload: " + path);
+	}
+	std::vector<char> buffer(1024 * 1024);
+	do {
+		file.read(buffer.data(), buffer.size());
+		if (file.gcount() > 0 && ! stream.write(buffer.data(), size_t(file.gcount())))
+			// The upload was aborted.
+			break;
+	} while (file.good());
+}
+
 // A print host upload job has been scheduled, enqueue it to the printhost job queue
 void BackgroundSlicingProcess::prepare_upload()
 {
@@ -268,6 +268,8 @@ private:
     void                throw_if_canceled() const { if (m_print->canceled()) throw CanceledException(); }
 	void				finalize_gcode();
     void                prepare_upload();
+	std::shared_ptr<UploadStream> start_streaming_upload(std::string &host);
+	void				stream_file_to_upload(const std::string &path, UploadStream &stream);
     // To be executed at the background thread.
 	ThumbnailsList		render_thumbnails(const ThumbnailsParams &params);
 	// Execute task from background thread on the UI thread synchronously. Returns true if processed, false if cancelled before executing the task.
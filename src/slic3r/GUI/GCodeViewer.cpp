@@ -42,7 +42,10 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
 #include <wx/progdlg.h>
-#include <wx/numformatter.h>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
 
 #include <array>
 #include <algorithm>
@@ -191,7 +194,7 @@ void GCodeViewer::TBuffer::reset()
     model.reset();
 }
 
-void GCodeViewer::TBuffer::add_path(const GCodeProcessorResult::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id)
+void GCodeViewer::ToolpathsGeometry::Buffer::add_path(const GCodeProcessorResult::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id)
 {
     Path::Endpoint endpoint = { b_id, i_id, s_id, move.position };
     // use rounding to reduce the number of generated paths
@@ -201,6 +204,42 @@ void GCodeViewer::TBuffer::add_path(const GCodeProcessorResult::MoveVertex& move
         move.volumetric_rate(), move.mm3_per_mm, move.extruder_id, move.cp_color_id, move.object_id, { { endpoint, endpoint } }, move.move_time });
 }
 
+size_t GCodeViewer::ToolpathsGeometry::vertices_count_floats() const
+{
+    size_t count = 0;
+    for (const Buffer& buffer : buffers) {
+        for (const VertexBuffer& v_buffer : buffer.vertices) {
+            count += v_buffer.size();
+        }
+    }
+    return count;
+}
+
+size_t GCodeViewer::ToolpathsGeometry::indices_count() const
+{
+    size_t count = 0;
+    for (const Buffer& buffer : buffers) {
+        for (const IndexBuffer& i_buffer : buffer.indices) {
+            count += i_buffer.size();
+        }
+    }
+    return count;
+}
+
+void GCodeViewer::ToolpathsLOD::reset()
+{
+    for (TBuffer& buffer : buffers) {
+        buffer.reset();
+    }
+    buffers.clear();
+    moves_ids.clear();
+}
+
+bool GCodeViewer::ToolpathsLOD::has_data() const
+{
+    return std::any_of(buffers.begin(), buffers.end(), [](const TBuffer& buffer) { return buffer.has_data(); });
+}
+
 void GCodeViewer::COG::render()
 {
     if (!m_visible)
@@ -1334,56 +1373,78 @@ GCodeViewer::GCodeViewer()
 //    m_sequential_view.skip_invisible_moves = true;
 }
 
+void GCodeViewer::init_buffer_layout(TBuffer& buffer, EMoveType type, bool instanced_models)
+{
+    switch (type)
+    {
+    default: { break; }
+    case EMoveType::Tool_change:
+    case EMoveType::Color_change:
+    case EMoveType::Pause_Print:
+    case EMoveType::Custom_GCode:
+    case EMoveType::Retract:
+    case EMoveType::Unretract:
+    case EMoveType::Seam: {
+        if (instanced_models) {
+            buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::InstancedModel;
+            buffer.model.instances.format = InstanceVBuffer::EFormat::InstancedModel;
+        }
+        else {
+            buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::BatchedModel;
+            buffer.vertices.format = VBuffer::EFormat::PositionNormal3;
+            buffer.model.data = diamond(16);
+            buffer.model.instances.format = InstanceVBuffer::EFormat::BatchedModel;
+        }
+        break;
+    }
+    case EMoveType::Wipe:
+    case EMoveType::Extrude: {
+        buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::Triangle;
+        buffer.vertices.format = VBuffer::EFormat::PositionNormal3;
+        break;
+    }
+    case EMoveType::Travel: {
+        buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::Line;
+        buffer.vertices.format = VBuffer::EFormat::Position;
+        break;
+    }
+    }
+}
+
 void GCodeViewer::init()
 {
     if (m_gl_data_initialized)
         return;
 
+#if DISABLE_GCODEVIEWER_INSTANCED_MODELS
+    const bool instanced_models = false;
+#else
+    const bool instanced_models = wxGetApp().is_gl_version_greater_or_equal_to(3, 3);
+#endif // DISABLE_GCODEVIEWER_INSTANCED_MODELS
+
     // initializes opengl data of TBuffers
     for (size_t i = 0; i < m_buffers.size(); ++i) {
         TBuffer& buffer = m_buffers[i];
         EMoveType type = buffer_type(i);
-        switch (type)
+        init_buffer_layout(buffer, type, instanced_models);
+        switch (buffer.render_primitive_type)
         {
-        default: { break; }
-        case EMoveType::Tool_change:
-        case EMoveType::Color_change:
-        case EMoveType::Pause_Print:
-        case EMoveType::Custom_GCode:
-        case EMoveType::Retract:
-        case EMoveType::Unretract:
-        case EMoveType::Seam: {
-#if !DISABLE_GCODEVIEWER_INSTANCED_MODELS
-            if (wxGetApp().is_gl_version_greater_or_equal_to(3, 3)) {
-                buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::InstancedModel;
-                buffer.shader = "gouraud_light_instanced";
-                buffer.model.model.init_from(diamond(16));
-                buffer.model.color = option_color(type);
-                buffer.model.instances.format = InstanceVBuffer::EFormat::InstancedModel;
-            }
-            else {
-#endif // !DISABLE_GCODEVIEWER_INSTANCED_MODELS
-                buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::BatchedModel;
-                buffer.vertices.format = VBuffer::EFormat::PositionNormal3;
-                buffer.shader = "gouraud_light";
-                buffer.model.data = diamond(16);
-                buffer.model.color = option_color(type);
-                buffer.model.instances.format = InstanceVBuffer::EFormat::BatchedModel;
-#if !DISABLE_GCODEVIEWER_INSTANCED_MODELS
-            }
-#endif // !DISABLE_GCODEVIEWER_INSTANCED_MODELS
-                break;
+        case TBuffer::ERenderPrimitiveType::InstancedModel: {
+            buffer.shader = "gouraud_light_instanced";
+            buffer.model.model.init_from(diamond(16));
+            buffer.model.color = option_color(type);
+            break;
         }
-        case EMoveType::Wipe:
-        case EMoveType::Extrude: {
-            buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::Triangle;
-            buffer.vertices.format = VBuffer::EFormat::PositionNormal3;
+        case TBuffer::ERenderPrimitiveType::BatchedModel: {
             buffer.shader = "gouraud_light";
+            buffer.model.color = option_color(type);
             break;
         }
-        case EMoveType::Travel: {
-            buffer.render_primitive_type = TBuffer::ERenderPrimitiveType::Line;
-            buffer.vertices.format = VBuffer::EFormat::Position;
+        case TBuffer::ERenderPrimitiveType::Triangle: {
+            buffer.shader = "gouraud_light";
+            break;
+        }
+        case TBuffer::ERenderPrimitiveType::Line: {
 #if ENABLE_GL_CORE_PROFILE
             // on MAC using the geometry shader of dashed_thick_lines is too slow
             buffer.shader = "flat";
@@ -1617,6 +1678,11 @@ void GCodeViewer::refresh(const GCodeProcessorResult& gcode_result, const std::v
     m_statistics.refresh_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
+    // the levels of detail are simplified with the path merging mode active when they were loaded,
+    // the view type or the ranges may have changed the mode since then
+    if (m_lods_mode != m_current_mode)
+        load_toolpaths_lods(gcode_result);
+
     // update buffers' render paths
     refresh_render_paths();
     log_memory_used("Refreshed G-code extrusion paths, ");
@@ -1634,6 +1700,10 @@ void GCodeViewer::reset()
     for (TBuffer& buffer : m_buffers) {
         buffer.reset();
     }
+    for (ToolpathsLOD& lod : m_lods) {
+        lod.reset();
+    }
+    m_lods.clear();
 
     m_paths_bounding_box.reset();
     m_max_bounding_box.reset();
@@ -1971,26 +2041,30 @@ void GCodeViewer::export_toolpaths_to_obj(const char* filename) const
     fclose(fp);
 }
 
-void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
+GCodeViewer::ToolpathsGeometry GCodeViewer::generate_toolpaths_geometry(const GCodeProcessorResult& gcode_result, bool parallel)
+{
+#if DISABLE_GCODEVIEWER_INSTANCED_MODELS
+    const bool instanced_models = false;
+#else
+    const bool instanced_models = true;
+#endif // DISABLE_GCODEVIEWER_INSTANCED_MODELS
+    std::vector<TBuffer> buffers(static_cast<size_t>(EMoveType::Count) - 1);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        init_buffer_layout(buffers[i], buffer_type(i), instanced_models);
+    }
+    const Extrusions::Ranges extrusion_ranges(2);
+    return generate_toolpaths_geometry(gcode_result.moves, buffers, extrusion_ranges, Path::MatchMode::mmDefault, parallel);
+}
+
+GCodeViewer::ToolpathsGeometry GCodeViewer::generate_toolpaths_geometry(const std::vector<GCodeProcessorResult::MoveVertex>& moves, const std::vector<TBuffer>& buffers,
+    const Extrusions::Ranges& extrusion_ranges, Path::MatchMode match_mode, bool parallel)
 {
     // max index buffer size, in bytes
     static const size_t IBUFFER_THRESHOLD_BYTES = 64 * 1024 * 1024;
+    // min count of moves processed by a single task
+    static const size_t MIN_MOVES_PER_RANGE = 100000;
 
-    auto log_memory_usage = [this](const std::string& label, const std::vector<MultiVertexBuffer>& vertices, const std::vector<MultiIndexBuffer>& indices) {
-        int64_t vertices_size = 0;
-        for (const MultiVertexBuffer& buffers : vertices) {
-            for (const VertexBuffer& buffer : buffers) {
-                vertices_size += SLIC3R_STDVEC_MEMSIZE(buffer, float);
-            }
-        }
-        int64_t indices_size = 0;
-        for (const MultiIndexBuffer& buffers : indices) {
-            for (const IndexBuffer& buffer : buffers) {
-                indices_size += SLIC3R_STDVEC_MEMSIZE(buffer, IBufferType);
-            }
-        }
-        log_memory_used(label, vertices_size + indices_size);
-    };
+    using Buffer = ToolpathsGeometry::Buffer;
 
     // format data into the buffers to be rendered as lines
     auto add_vertices_as_line = [](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, VertexBuffer& vertices) {
@@ -2006,9 +2080,9 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         // add current vertex
         add_vertex(curr);
     };
-    auto add_indices_as_line = [this](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, TBuffer& buffer,
+    auto add_indices_as_line = [&extrusion_ranges, match_mode](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, Buffer& buffer,
         unsigned int ibuffer_id, IndexBuffer& indices, size_t move_id) {
-            if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, m_extrusions.ranges, m_current_mode)) {
+            if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, extrusion_ranges, match_mode)) {
                 // add starting index
                 indices.push_back(static_cast<IBufferType>(indices.size()));
                 buffer.add_path(curr, ibuffer_id, indices.size() - 1, move_id - 1);
@@ -2027,9 +2101,9 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
     };
 
     // format data into the buffers to be rendered as solid
-    auto add_vertices_as_solid = [this](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, TBuffer& buffer,
+    auto add_vertices_as_solid = [&extrusion_ranges, match_mode](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr, Buffer& buffer,
         unsigned int vbuffer_id, VertexBuffer& vertices, size_t move_id) {
-        auto store_vertex = [this](VertexBuffer& vertices, const Vec3f& position, const Vec3f& normal) {
+        auto store_vertex = [](VertexBuffer& vertices, const Vec3f& position, const Vec3f& normal) {
             // append position
             vertices.push_back(position.x());
             vertices.push_back(position.y());
@@ -2040,7 +2114,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             vertices.push_back(normal.z());
         };
 
-        if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, m_extrusions.ranges, m_current_mode)) {
+        if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, extrusion_ranges, match_mode)) {
             buffer.add_path(curr, vbuffer_id, vertices.size(), move_id - 1);
             buffer.paths.back().sub_paths.back().first.position = prev.position;
         }
@@ -2085,12 +2159,19 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
 
         last_path.sub_paths.back().last = { vbuffer_id, vertices.size(), move_id, curr.position };
     };
+    // previous segment of the path being rendered as solid
+    struct PrevSegment
+    {
+        Vec3f dir{ Vec3f::Zero() };
+        Vec3f up{ Vec3f::Zero() };
+        float sq_length{ 0.0f };
+    };
     auto add_indices_as_solid = [&](const GCodeProcessorResult::MoveVertex& prev, const GCodeProcessorResult::MoveVertex& curr,
-        const GCodeProcessorResult::MoveVertex* next, TBuffer& buffer, size_t& vbuffer_size, unsigned int ibuffer_id,
-        IndexBuffer& indices, size_t move_id) {
-            static Vec3f prev_dir;
-            static Vec3f prev_up;
-            static float sq_prev_length;
+        const GCodeProcessorResult::MoveVertex* next, Buffer& buffer, size_t& vbuffer_size, unsigned int ibuffer_id,
+        IndexBuffer& indices, size_t move_id, PrevSegment& prev_segment) {
+            Vec3f& prev_dir = prev_segment.dir;
+            Vec3f& prev_up = prev_segment.up;
+            float& sq_prev_length = prev_segment.sq_length;
             auto store_triangle = [](IndexBuffer& indices, IBufferType i1, IBufferType i2, IBufferType i3) {
                 indices.push_back(i1);
                 indices.push_back(i2);
@@ -2132,7 +2213,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
                 store_triangle(indices, v_offsets[4], v_offsets[5], v_offsets[6]);
             };
 
-            if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, m_extrusions.ranges, m_current_mode)) {
+            if (buffer.paths.empty() || prev.type != curr.type || !buffer.paths.back().matches(curr, extrusion_ranges, match_mode)) {
                 buffer.add_path(curr, ibuffer_id, indices.size(), move_id - 1);
                 buffer.paths.back().sub_paths.back().first.position = prev.position;
             }
@@ -2216,7 +2297,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
                 vbuffer_size += 6;
             }
 
-            if (next != nullptr && (curr.type != next->type || !last_path.matches(*next, m_extrusions.ranges, m_current_mode)))
+            if (next != nullptr && (curr.type != next->type || !last_path.matches(*next, extrusion_ranges, match_mode)))
                 // ending cap triangles
                 append_ending_cap_triangles(indices, is_first_segment ? first_seg_v_offsets : non_first_seg_v_offsets);
 
@@ -2281,158 +2362,47 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         }
     };
 
-#if ENABLE_GCODE_VIEWER_STATISTICS
-    auto start_time = std::chrono::high_resolution_clock::now();
-    m_statistics.results_size = SLIC3R_STDVEC_MEMSIZE(gcode_result.moves, GCodeProcessorResult::MoveVertex);
-    m_statistics.results_time = gcode_result.time;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-
-    m_max_bounding_box.reset();
-
-    m_moves_count = gcode_result.moves.size();
-    if (m_moves_count == 0)
-        return;
-
-    m_extruders_count = gcode_result.extruders_count;
-    m_objects_count = gcode_result.object_names.size();
-    m_objects_ids = gcode_result.object_names;
-
-    unsigned int progress_count = 0;
-    static const unsigned int progress_threshold = 1000;
-    wxProgressDialog* progress_dialog = wxGetApp().is_gcode_viewer() ?
-        new wxProgressDialog(_L("Generating toolpaths"), "...",
-            100, wxGetApp().mainframe, wxPD_AUTO_HIDE | wxPD_APP_MODAL) : nullptr;
-
-    wxBusyCursor busy;
-
-    // extract approximate paths bounding box from result
-    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
-        if (wxGetApp().is_gcode_viewer())
-            // for the gcode viewer we need to take in account all moves to correctly size the printbed
-            m_paths_bounding_box.merge(move.position.cast<double>());
-        else {
-            if (move.type == EMoveType::Extrude && move.extrusion_role != GCodeExtrusionRole::Custom && move.width != 0.0f && move.height != 0.0f)
-                m_paths_bounding_box.merge(move.position.cast<double>());
-        }
-    }
-
-    if (wxGetApp().is_editor())
-        m_contained_in_bed = wxGetApp().plater()->build_volume().all_paths_inside(gcode_result, m_paths_bounding_box);
+    const size_t moves_count = moves.size();
 
-    m_cog.reset();
-
-    m_sequential_view.gcode_ids.clear();
-    for (size_t i = 0; i < gcode_result.moves.size(); ++i) {
-        const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-        if (move.type != EMoveType::Seam)
-            m_sequential_view.gcode_ids.push_back(move.gcode_id);
-    }
+    ToolpathsGeometry geometry;
+    geometry.buffers.resize(buffers.size());
+    if (moves_count == 0)
+        return geometry;
 
-    std::vector<MultiVertexBuffer> vertices(m_buffers.size());
-    std::vector<MultiIndexBuffer> indices(m_buffers.size());
-    std::vector<InstanceBuffer> instances(m_buffers.size());
-    std::vector<InstanceIdBuffer> instances_ids(m_buffers.size());
-    std::vector<InstancesOffsets> instances_offsets(m_buffers.size());
-    std::vector<float> options_zs;
+    // range of moves whose data are generated by a single task
+    struct MovesRange
+    {
+        size_t first{ 0 };
+        size_t last{ 0 };
+        // count of seams preceding the first move
+        size_t seams_count{ 0 };
+    };
 
+    // split the moves into ranges of whole layers
+    // a range starts with a change of the move type, thus a new path is started in all the buffers
+    // and no path crosses the boundaries of the ranges
+    const size_t ranges_count = parallel ? std::clamp<size_t>(moves_count / MIN_MOVES_PER_RANGE, 1, 4 * size_t(tbb::this_task_arena::max_concurrency())) : 1;
+    const size_t range_size = moves_count / ranges_count;
+    std::vector<MovesRange> moves_ranges(1);
     std::vector<size_t> biased_seams_ids;
-
-    // toolpaths data -> extract vertices from result
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
-        if (curr.type == EMoveType::Noop)
-            continue;
-        if (curr.type == EMoveType::Seam)
-            biased_seams_ids.push_back(i - biased_seams_ids.size() - 1);
-
-        const size_t move_id = i - biased_seams_ids.size();
-
-        // skip first vertex
-        if (i == 0)
-            continue;
-
-        const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
-
-        if (curr.type == EMoveType::Extrude &&
-            curr.extrusion_role != GCodeExtrusionRole::Skirt &&
-            curr.extrusion_role != GCodeExtrusionRole::SupportMaterial &&
-            curr.extrusion_role != GCodeExtrusionRole::SupportMaterialInterface &&
-            curr.extrusion_role != GCodeExtrusionRole::WipeTower &&
-            curr.extrusion_role != GCodeExtrusionRole::Custom) {
-            const Vec3d curr_pos = curr.position.cast<double>();
-            const Vec3d prev_pos = prev.position.cast<double>();
-            m_cog.add_segment(curr_pos, prev_pos, curr.mm3_per_mm * (curr_pos - prev_pos).norm());
-        }
-
-        // update progress dialog
-        ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(i) / (2.0f * float(m_moves_count))),
-                _L("Generating vertex buffer") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
-            progress_count = 0;
-        }
-        
-        assert(curr.type > EMoveType::Noop);
-        const unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
-        MultiVertexBuffer& v_multibuffer = vertices[id];
-        InstanceBuffer& inst_buffer = instances[id];
-        InstanceIdBuffer& inst_id_buffer = instances_ids[id];
-        InstancesOffsets& inst_offsets = instances_offsets[id];
-
-        // ensure there is at least one vertex buffer
-        if (v_multibuffer.empty())
-            v_multibuffer.push_back(VertexBuffer());
-
-        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
-        // add another vertex buffer
-        size_t vertices_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.vertices_size_bytes() : t_buffer.max_vertices_per_segment_size_bytes();
-        if (v_multibuffer.back().size() * sizeof(float) > t_buffer.vertices.max_size_bytes() - vertices_size_to_add) {
-            v_multibuffer.push_back(VertexBuffer());
-            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
-                Path& last_path = t_buffer.paths.back();
-                if (prev.type == curr.type && last_path.matches(curr, m_extrusions.ranges, m_current_mode))
-                    last_path.add_sub_path(prev, static_cast<unsigned int>(v_multibuffer.size()) - 1, 0, move_id - 1);
+    bool layer_changed = false;
+    for (size_t i = 0; i < moves_count; ++i) {
+        const GCodeProcessorResult::MoveVertex& move = moves[i];
+        if (i - moves_ranges.back().first > range_size) {
+            layer_changed |= move.layer_id != moves[i - 1].layer_id;
+            if (layer_changed && move.type != moves[i - 1].type) {
+                moves_ranges.back().last = i;
+                moves_ranges.push_back({ i, 0, biased_seams_ids.size() });
+                layer_changed = false;
             }
         }
-
-        VertexBuffer& v_buffer = v_multibuffer.back();
-
-        switch (t_buffer.render_primitive_type)
-        {
-        case TBuffer::ERenderPrimitiveType::Line:     { add_vertices_as_line(prev, curr, v_buffer); break; }
-        case TBuffer::ERenderPrimitiveType::Triangle: { add_vertices_as_solid(prev, curr, t_buffer, static_cast<unsigned int>(v_multibuffer.size()) - 1, v_buffer, move_id); break; }
-        case TBuffer::ERenderPrimitiveType::InstancedModel:
-        {
-            add_model_instance(curr, inst_buffer, inst_id_buffer, move_id);
-            inst_offsets.push_back(prev.position - curr.position);
-#if ENABLE_GCODE_VIEWER_STATISTICS
-            ++m_statistics.instances_count;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-            break;
-        }
-        case TBuffer::ERenderPrimitiveType::BatchedModel:
-        {
-            add_vertices_as_model_batch(curr, t_buffer.model.data, v_buffer, inst_buffer, inst_id_buffer, move_id);
-            inst_offsets.push_back(prev.position - curr.position);
-#if ENABLE_GCODE_VIEWER_STATISTICS
-            ++m_statistics.batched_count;
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-            break;
-        }
-        }
-
-        // collect options zs for later use
-        if (curr.type == EMoveType::Pause_Print || curr.type == EMoveType::Custom_GCode) {
-            const float* const last_z = options_zs.empty() ? nullptr : &options_zs.back();
-            if (last_z == nullptr || curr.position[2] < *last_z - EPSILON || *last_z + EPSILON < curr.position[2])
-                options_zs.emplace_back(curr.position[2]);
-        }
+        if (move.type == EMoveType::Seam)
+            biased_seams_ids.push_back(i - biased_seams_ids.size() - 1);
     }
+    moves_ranges.back().last = moves_count;
 
     // smooth toolpaths corners for the given TBuffer using triangles
-    auto smooth_triangle_toolpaths_corners = [&gcode_result, &biased_seams_ids](const TBuffer& t_buffer, MultiVertexBuffer& v_multibuffer) {
+    auto smooth_triangle_toolpaths_corners = [&moves, &biased_seams_ids](const TBuffer& t_buffer, const std::vector<Path>& paths, MultiVertexBuffer& v_multibuffer) {
         auto extract_position_at = [](const VertexBuffer& vertices, size_t offset) {
             return Vec3f(vertices[offset + 0], vertices[offset + 1], vertices[offset + 2]);
         };
@@ -2521,7 +2491,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         };
 
         const size_t vertex_size_floats = t_buffer.vertices.vertex_size_floats();
-        for (const Path& path : t_buffer.paths) {
+        for (const Path& path : paths) {
             // the two segments of the path sharing the current vertex may belong
             // to two different vertex buffers
             size_t prev_sub_path_id = 0;
@@ -2531,9 +2501,9 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
             for (size_t j = 1; j < path_vertices_count - 1; ++j) {
                 const size_t curr_s_id = path.sub_paths.front().first.s_id + j;
                 const size_t move_id = extract_move_id(curr_s_id);
-                const Vec3f& prev = gcode_result.moves[move_id - 1].position;
-                const Vec3f& curr = gcode_result.moves[move_id].position;
-                const Vec3f& next = gcode_result.moves[move_id + 1].position;
+                const Vec3f& prev = moves[move_id - 1].position;
+                const Vec3f& curr = moves[move_id].position;
+                const Vec3f& next = moves[move_id + 1].position;
 
                 // select the subpaths which contains the previous/next segments
                 if (!path.sub_paths[prev_sub_path_id].contains(curr_s_id))
@@ -2587,57 +2557,389 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         }
     };
 
-#if ENABLE_GCODE_VIEWER_STATISTICS
-    auto load_vertices_time = std::chrono::high_resolution_clock::now();
-    m_statistics.load_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
+    // generates the data of the moves of the given range into the given geometry
+    auto process_range = [&](const MovesRange& range, ToolpathsGeometry& range_geometry) {
+        range_geometry.buffers.resize(buffers.size());
 
-    // smooth toolpaths corners for TBuffers using triangles
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        const TBuffer& t_buffer = m_buffers[i];
-        if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle)
-            smooth_triangle_toolpaths_corners(t_buffer, vertices[i]);
+        // toolpaths data -> extract vertices from result
+        size_t seams_count = range.seams_count;
+        for (size_t i = range.first; i < range.last; ++i) {
+            const GCodeProcessorResult::MoveVertex& curr = moves[i];
+            if (curr.type == EMoveType::Noop)
+                continue;
+            if (curr.type == EMoveType::Seam)
+                ++seams_count;
+
+            const size_t move_id = i - seams_count;
+
+            // skip first vertex
+            if (i == 0)
+                continue;
+
+            const GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
+
+            assert(curr.type > EMoveType::Noop);
+            const unsigned char id = buffer_id(curr.type);
+            const TBuffer& t_buffer = buffers[id];
+            Buffer& buffer = range_geometry.buffers[id];
+            MultiVertexBuffer& v_multibuffer = buffer.vertices;
+
+            // ensure there is at least one vertex buffer
+            if (v_multibuffer.empty())
+                v_multibuffer.push_back(VertexBuffer());
+
+            // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
+            // add another vertex buffer
+            size_t vertices_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.vertices_size_bytes() : t_buffer.max_vertices_per_segment_size_bytes();
+            if (v_multibuffer.back().size() * sizeof(float) > t_buffer.vertices.max_size_bytes() - vertices_size_to_add) {
+                v_multibuffer.push_back(VertexBuffer());
+                if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
+                    Path& last_path = buffer.paths.back();
+                    if (prev.type == curr.type && last_path.matches(curr, extrusion_ranges, match_mode))
+                        last_path.add_sub_path(prev, static_cast<unsigned int>(v_multibuffer.size()) - 1, 0, move_id - 1);
+                }
+            }
+
+            VertexBuffer& v_buffer = v_multibuffer.back();
+
+            switch (t_buffer.render_primitive_type)
+            {
+            case TBuffer::ERenderPrimitiveType::Line:     { add_vertices_as_line(prev, curr, v_buffer); break; }
+            case TBuffer::ERenderPrimitiveType::Triangle: { add_vertices_as_solid(prev, curr, buffer, static_cast<unsigned int>(v_multibuffer.size()) - 1, v_buffer, move_id); break; }
+            case TBuffer::ERenderPrimitiveType::InstancedModel:
+            {
+                add_model_instance(curr, buffer.instances, buffer.instances_ids, move_id);
+                buffer.instances_offsets.push_back(prev.position - curr.position);
+                break;
+            }
+            case TBuffer::ERenderPrimitiveType::BatchedModel:
+            {
+                add_vertices_as_model_batch(curr, t_buffer.model.data, v_buffer, buffer.instances, buffer.instances_ids, move_id);
+                buffer.instances_offsets.push_back(prev.position - curr.position);
+                break;
+            }
+            }
+        }
+
+        // smooth toolpaths corners for TBuffers using triangles
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            const TBuffer& t_buffer = buffers[i];
+            if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle)
+                smooth_triangle_toolpaths_corners(t_buffer, range_geometry.buffers[i].paths, range_geometry.buffers[i].vertices);
+        }
+
+        // paths have been filled while extracting vertices,
+        // so reset them, they will be filled again while extracting indices
+        for (Buffer& buffer : range_geometry.buffers) {
+            for (VertexBuffer& v_buffer : buffer.vertices) {
+                v_buffer.shrink_to_fit();
+            }
+            buffer.paths.clear();
+        }
+
+        // variable used to keep track of the current vertex buffers index and size
+        using CurrVertexBuffer = std::pair<unsigned int, size_t>;
+        std::vector<CurrVertexBuffer> curr_vertex_buffers(buffers.size(), { 0, 0 });
+        PrevSegment prev_segment;
+
+        // toolpaths data -> extract indices from result
+        seams_count = range.seams_count;
+        for (size_t i = range.first; i < range.last; ++i) {
+            const GCodeProcessorResult::MoveVertex& curr = moves[i];
+            if (curr.type == EMoveType::Noop)
+                continue;
+            if (curr.type == EMoveType::Seam)
+                ++seams_count;
+
+            const size_t move_id = i - seams_count;
+
+            // skip first vertex
+            if (i == 0)
+                continue;
+
+            const GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
+            const GCodeProcessorResult::MoveVertex* next = nullptr;
+            if (i < moves_count - 1)
+                next = &moves[i + 1];
+
+            assert(curr.type > EMoveType::Noop);
+            const unsigned char id = buffer_id(curr.type);
+            const TBuffer& t_buffer = buffers[id];
+            Buffer& buffer = range_geometry.buffers[id];
+            MultiIndexBuffer& i_multibuffer = buffer.indices;
+            CurrVertexBuffer& curr_vertex_buffer = curr_vertex_buffers[id];
+
+            // ensure there is at least one index buffer
+            if (i_multibuffer.empty()) {
+                i_multibuffer.push_back(IndexBuffer());
+                buffer.vbuffer_ids.push_back(curr_vertex_buffer.first);
+            }
+
+            // if adding the indices for the current segment exceeds the threshold size of the current index buffer
+            // create another index buffer
+            size_t indiced_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.indices_size_bytes() : t_buffer.max_indices_per_segment_size_bytes();
+            if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - indiced_size_to_add) {
+                i_multibuffer.push_back(IndexBuffer());
+                buffer.vbuffer_ids.push_back(curr_vertex_buffer.first);
+                if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
+                    Path& last_path = buffer.paths.back();
+                    last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, move_id - 1);
+                }
+            }
+
+            // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
+            // create another index buffer
+            size_t vertices_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.vertices_size_bytes() : t_buffer.max_vertices_per_segment_size_bytes();
+            if (curr_vertex_buffer.second * t_buffer.vertices.vertex_size_bytes() > t_buffer.vertices.max_size_bytes() - vertices_size_to_add) {
+                i_multibuffer.push_back(IndexBuffer());
+
+                ++curr_vertex_buffer.first;
+                curr_vertex_buffer.second = 0;
+                buffer.vbuffer_ids.push_back(curr_vertex_buffer.first);
+
+                if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
+                    Path& last_path = buffer.paths.back();
+                    last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, move_id - 1);
+                }
+            }
+
+            IndexBuffer& i_buffer = i_multibuffer.back();
+
+            switch (t_buffer.render_primitive_type)
+            {
+            case TBuffer::ERenderPrimitiveType::Line: {
+                add_indices_as_line(prev, curr, buffer, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id);
+                curr_vertex_buffer.second += t_buffer.max_vertices_per_segment();
+                break;
+            }
+            case TBuffer::ERenderPrimitiveType::Triangle: {
+                add_indices_as_solid(prev, curr, next, buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id, prev_segment);
+                break;
+            }
+            case TBuffer::ERenderPrimitiveType::BatchedModel: {
+                add_indices_as_model_batch(t_buffer.model.data, i_buffer, curr_vertex_buffer.second);
+                curr_vertex_buffer.second += t_buffer.model.data.vertices_count();
+                break;
+            }
+            default: { break; }
+            }
+        }
+
+        for (Buffer& buffer : range_geometry.buffers) {
+            for (IndexBuffer& i_buffer : buffer.indices) {
+                i_buffer.shrink_to_fit();
+            }
+        }
+    };
+
+    std::vector<ToolpathsGeometry> ranges_geometry(moves_ranges.size());
+    if (moves_ranges.size() > 1) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, moves_ranges.size(), 1),
+            [&moves_ranges, &ranges_geometry, &process_range](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    process_range(moves_ranges[i], ranges_geometry[i]);
+                }
+            });
     }
+    else
+        process_range(moves_ranges.front(), ranges_geometry.front());
 
     // dismiss, no more needed
     std::vector<size_t>().swap(biased_seams_ids);
 
-    for (MultiVertexBuffer& v_multibuffer : vertices) {
-        for (VertexBuffer& v_buffer : v_multibuffer) {
-            v_buffer.shrink_to_fit();
+    // merge the data of the ranges, the buffers of each range are appended to the buffers of the previous ranges
+    geometry = std::move(ranges_geometry.front());
+    for (size_t r = 1; r < ranges_geometry.size(); ++r) {
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            Buffer& dst = geometry.buffers[i];
+            Buffer& src = ranges_geometry[r].buffers[i];
+            const unsigned int vbuffers_offset = static_cast<unsigned int>(dst.vertices.size());
+            const unsigned int ibuffers_offset = static_cast<unsigned int>(dst.indices.size());
+            for (unsigned int vbuffer_id : src.vbuffer_ids) {
+                dst.vbuffer_ids.push_back(vbuffers_offset + vbuffer_id);
+            }
+            for (Path& path : src.paths) {
+                for (Path::Sub_Path& sub_path : path.sub_paths) {
+                    sub_path.first.b_id += ibuffers_offset;
+                    sub_path.last.b_id += ibuffers_offset;
+                }
+            }
+            append(dst.vertices, std::move(src.vertices));
+            append(dst.indices, std::move(src.indices));
+            append(dst.instances, std::move(src.instances));
+            append(dst.instances_ids, std::move(src.instances_ids));
+            append(dst.instances_offsets, std::move(src.instances_offsets));
+            append(dst.paths, std::move(src.paths));
+        }
+        // release the memory of the range as soon as possible
+        ranges_geometry[r] = ToolpathsGeometry();
+    }
+
+    // move the wipe toolpaths half height up to render them on proper position
+    MultiVertexBuffer& wipe_vertices = geometry.buffers[buffer_id(EMoveType::Wipe)].vertices;
+    for (VertexBuffer& v_buffer : wipe_vertices) {
+        for (size_t i = 2; i < v_buffer.size(); i += 3) {
+            v_buffer[i] += 0.5f * GCodeProcessor::Wipe_Height;
+        }
+    }
+
+    return geometry;
+}
+
+std::vector<GCodeProcessorResult::MoveVertex> GCodeViewer::simplify_toolpaths_moves(const GCodeProcessorResult& gcode_result, float tolerance,
+    std::vector<size_t>& moves_ids)
+{
+    const Extrusions::Ranges extrusion_ranges(2);
+    return simplify_toolpaths_moves(gcode_result.moves, tolerance, extrusion_ranges, Path::MatchMode::mmDefault, moves_ids);
+}
+
+std::vector<GCodeProcessorResult::MoveVertex> GCodeViewer::simplify_toolpaths_moves(const std::vector<GCodeProcessorResult::MoveVertex>& moves, float tolerance,
+    const Extrusions::Ranges& extrusion_ranges, Path::MatchMode match_mode, std::vector<size_t>& moves_ids)
+{
+    // max count of consecutive moves merged into a single one
+    static const size_t MAX_MERGED_MOVES = 64;
+    // min count of moves processed by a single task
+    static const size_t MIN_MOVES_PER_RANGE = 100000;
+
+    std::vector<GCodeProcessorResult::MoveVertex> ret;
+    moves_ids.clear();
+    if (moves.empty())
+        return ret;
+
+    auto has_segment = [](EMoveType type) {
+        return type == EMoveType::Extrude || type == EMoveType::Travel || type == EMoveType::Wipe;
+    };
+    auto sqr_distance_to_segment = [](const Vec3f& p, const Vec3f& a, const Vec3f& b) {
+        const Vec3f ab = b - a;
+        const float sq_length = ab.squaredNorm();
+        const float t = (sq_length > 0.0f) ? std::clamp((p - a).dot(ab) / sq_length, 0.0f, 1.0f) : 0.0f;
+        return (a + t * ab - p).squaredNorm();
+    };
+
+    // range of moves simplified by a single task
+    struct MovesRange
+    {
+        size_t first{ 0 };
+        size_t last{ 0 };
+        // count of seams preceding the first move
+        size_t seams_count{ 0 };
+    };
+
+    // split the moves into ranges of whole layers, moves are never merged across a layer change
+    std::vector<MovesRange> moves_ranges(1);
+    size_t seams_count = 0;
+    for (size_t i = 1; i < moves.size(); ++i) {
+        if (i - moves_ranges.back().first >= MIN_MOVES_PER_RANGE && moves[i].layer_id != moves[i - 1].layer_id) {
+            moves_ranges.back().last = i;
+            moves_ranges.push_back({ i, 0, seams_count });
+        }
+        if (moves[i].type == EMoveType::Seam)
+            ++seams_count;
+    }
+    moves_ranges.back().last = moves.size();
+
+    struct SimplifiedRange
+    {
+        std::vector<GCodeProcessorResult::MoveVertex> moves;
+        std::vector<size_t> moves_ids;
+    };
+    std::vector<SimplifiedRange> simplified_ranges(moves_ranges.size());
+
+    const float sq_tolerance = sqr(tolerance);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, moves_ranges.size(), 1),
+        [&](const tbb::blocked_range<size_t>& range) {
+        // used to compare the properties of consecutive moves as load_toolpaths() does
+        ToolpathsGeometry::Buffer buffer;
+        for (size_t r = range.begin(); r < range.end(); ++r) {
+            const MovesRange& moves_range = moves_ranges[r];
+            SimplifiedRange& simplified = simplified_ranges[r];
+            size_t seams_count = moves_range.seams_count;
+            // index of the first move of the current sequence of dropped moves, if any
+            size_t first_dropped = 0;
+            for (size_t i = moves_range.first; i < moves_range.last; ++i) {
+                const GCodeProcessorResult::MoveVertex& curr = moves[i];
+                if (curr.type == EMoveType::Seam)
+                    ++seams_count;
+                // the moves not generating any segment are dropped, the first move is kept as the starting point of the toolpaths
+                if (i > 0 && !has_segment(curr.type))
+                    continue;
+
+                // curr is dropped if the segment ending at it can be merged with the segment ending at the next move
+                bool drop = false;
+                if (i > 0 && i + 1 < moves_range.last) {
+                    const GCodeProcessorResult::MoveVertex& next = moves[i + 1];
+                    const size_t first = (first_dropped > 0) ? first_dropped : i;
+                    if (next.type == curr.type && next.layer_id == curr.layer_id && i - first < MAX_MERGED_MOVES) {
+                        // the move preceding a sequence of dropped moves is the last kept move,
+                        // the moves not generating any segment keep the position of the previous move
+                        const Vec3f& start = moves[first - 1].position;
+                        drop = true;
+                        for (size_t j = first; j <= i && drop; ++j) {
+                            drop = sqr_distance_to_segment(moves[j].position, start, next.position) <= sq_tolerance;
+                        }
+                        if (drop) {
+                            buffer.paths.clear();
+                            buffer.add_path(curr, 0, 0, 0);
+                            drop = buffer.paths.back().matches(next, extrusion_ranges, match_mode);
+                        }
+                    }
+                }
+
+                if (drop) {
+                    if (first_dropped == 0)
+                        first_dropped = i;
+                }
+                else {
+                    simplified.moves.push_back(curr);
+                    simplified.moves_ids.push_back(i - seams_count);
+                    first_dropped = 0;
+                }
+            }
         }
-    }
+    });
 
-    // move the wipe toolpaths half height up to render them on proper position
-    MultiVertexBuffer& wipe_vertices = vertices[buffer_id(EMoveType::Wipe)];
-    for (VertexBuffer& v_buffer : wipe_vertices) {
-        for (size_t i = 2; i < v_buffer.size(); i += 3) {
-            v_buffer[i] += 0.5f * GCodeProcessor::Wipe_Height;
-        }
+    size_t count = 0;
+    for (const SimplifiedRange& simplified : simplified_ranges) {
+        count += simplified.moves.size();
     }
+    ret.reserve(count);
+    moves_ids.reserve(count);
+    for (SimplifiedRange& simplified : simplified_ranges) {
+        append(ret, std::move(simplified.moves));
+        append(moves_ids, std::move(simplified.moves_ids));
+    }
+
+    return ret;
+}
 
+void GCodeViewer::upload_toolpaths_geometry(std::vector<TBuffer>& t_buffers, ToolpathsGeometry& geometry)
+{
     // send vertices data to gpu, where needed
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        TBuffer& t_buffer = m_buffers[i];
+    for (size_t i = 0; i < t_buffers.size(); ++i) {
+        TBuffer& t_buffer = t_buffers[i];
+        ToolpathsGeometry::Buffer& buffer = geometry.buffers[i];
         if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::InstancedModel) {
-            const InstanceBuffer& inst_buffer = instances[i];
-            if (!inst_buffer.empty()) {
-                t_buffer.model.instances.buffer = inst_buffer;
-                t_buffer.model.instances.s_ids = instances_ids[i];
-                t_buffer.model.instances.offsets = instances_offsets[i];
+            if (!buffer.instances.empty()) {
+                t_buffer.model.instances.buffer = std::move(buffer.instances);
+                t_buffer.model.instances.s_ids = std::move(buffer.instances_ids);
+                t_buffer.model.instances.offsets = std::move(buffer.instances_offsets);
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                m_statistics.instances_count += static_cast<int64_t>(t_buffer.model.instances.s_ids.size());
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
             }
         }
         else {
             if (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) {
-                const InstanceBuffer& inst_buffer = instances[i];
-                if (!inst_buffer.empty()) {
-                    t_buffer.model.instances.buffer = inst_buffer;
-                    t_buffer.model.instances.s_ids = instances_ids[i];
-                    t_buffer.model.instances.offsets = instances_offsets[i];
+                if (!buffer.instances.empty()) {
+                    t_buffer.model.instances.buffer = std::move(buffer.instances);
+                    t_buffer.model.instances.s_ids = std::move(buffer.instances_ids);
+                    t_buffer.model.instances.offsets = std::move(buffer.instances_offsets);
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                    m_statistics.batched_count += static_cast<int64_t>(t_buffer.model.instances.s_ids.size());
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
                 }
             }
-            const MultiVertexBuffer& v_multibuffer = vertices[i];
-            for (const VertexBuffer& v_buffer : v_multibuffer) {
+            for (const VertexBuffer& v_buffer : buffer.vertices) {
                 const size_t size_elements = v_buffer.size();
                 const size_t size_bytes = size_elements * sizeof(float);
                 const size_t vertices_count = size_elements / t_buffer.vertices.vertex_size_floats();
@@ -2673,198 +2975,150 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
                 t_buffer.vertices.sizes.push_back(size_bytes);
             }
         }
+        // dismiss vertices data, no more needed
+        MultiVertexBuffer().swap(buffer.vertices);
     }
 
-#if ENABLE_GCODE_VIEWER_STATISTICS
-    auto smooth_vertices_time = std::chrono::high_resolution_clock::now();
-    m_statistics.smooth_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - load_vertices_time).count();
-#endif // ENABLE_GCODE_VIEWER_STATISTICS
-    log_memory_usage("Loaded G-code generated vertex buffers ", vertices, indices);
-
-    // dismiss vertices data, no more needed
-    std::vector<MultiVertexBuffer>().swap(vertices);
-    std::vector<InstanceBuffer>().swap(instances);
-    std::vector<InstanceIdBuffer>().swap(instances_ids);
-
-    // toolpaths data -> extract indices from result
-    // paths may have been filled while extracting vertices,
-    // so reset them, they will be filled again while extracting indices
-    for (TBuffer& buffer : m_buffers) {
-        buffer.paths.clear();
-    }
-
-    // variable used to keep track of the current vertex buffers index and size
-    using CurrVertexBuffer = std::pair<unsigned int, size_t>;
-    std::vector<CurrVertexBuffer> curr_vertex_buffers(m_buffers.size(), { 0, 0 });
+    // toolpaths data -> send indices data to gpu
+    for (size_t i = 0; i < t_buffers.size(); ++i) {
+        TBuffer& t_buffer = t_buffers[i];
+        ToolpathsGeometry::Buffer& buffer = geometry.buffers[i];
+        t_buffer.paths = std::move(buffer.paths);
+        if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::InstancedModel) {
+            for (size_t j = 0; j < buffer.indices.size(); ++j) {
+                const IndexBuffer& i_buffer = buffer.indices[j];
+                const size_t size_elements = i_buffer.size();
+                const size_t size_bytes = size_elements * sizeof(IBufferType);
 
+                // stores index buffer informations into TBuffer
+                t_buffer.indices.push_back(IBuffer());
+                IBuffer& ibuf = t_buffer.indices.back();
+                ibuf.count = size_elements;
 #if ENABLE_GL_CORE_PROFILE
-    // variable used to keep track of the vertex buffers ids
-    using VIndexList = std::vector<unsigned int>;
-    std::vector<VIndexList> vao_indices(m_buffers.size());
-    std::vector<VIndexList> vbo_indices(m_buffers.size());
-#else
-    // variable used to keep track of the vertex buffers ids
-    using VboIndexList = std::vector<unsigned int>;
-    std::vector<VboIndexList> vbo_indices(m_buffers.size());
+                if (OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 0))
+                    ibuf.vao = t_buffer.vertices.vaos[buffer.vbuffer_ids[j]];
 #endif // ENABLE_GL_CORE_PROFILE
+                ibuf.vbo = t_buffer.vertices.vbos[buffer.vbuffer_ids[j]];
 
-    size_t seams_count = 0;
+#if ENABLE_GCODE_VIEWER_STATISTICS
+                m_statistics.total_indices_gpu_size += static_cast<int64_t>(size_bytes);
+                m_statistics.max_ibuffer_gpu_size = std::max(m_statistics.max_ibuffer_gpu_size, static_cast<int64_t>(size_bytes));
+                ++m_statistics.ibuffers_count;
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-    for (size_t i = 0; i < m_moves_count; ++i) {
-        const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
-        if (curr.type == EMoveType::Noop)
-            continue;
-        if (curr.type == EMoveType::Seam)
-            ++seams_count;
+                glsafe(::glGenBuffers(1, &ibuf.ibo));
+                glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibuf.ibo));
+                glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_bytes, i_buffer.data(), GL_STATIC_DRAW));
+                glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            }
+        }
+    }
+}
 
-        const size_t move_id = i - seams_count;
+void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
+{
+    auto log_memory_usage = [this](const std::string& label, const ToolpathsGeometry& geometry) {
+        int64_t vertices_size = 0;
+        int64_t indices_size = 0;
+        for (const ToolpathsGeometry::Buffer& buffer : geometry.buffers) {
+            for (const VertexBuffer& v_buffer : buffer.vertices) {
+                vertices_size += SLIC3R_STDVEC_MEMSIZE(v_buffer, float);
+            }
+            for (const IndexBuffer& i_buffer : buffer.indices) {
+                indices_size += SLIC3R_STDVEC_MEMSIZE(i_buffer, IBufferType);
+            }
+        }
+        log_memory_used(label, vertices_size + indices_size);
+    };
 
-        // skip first vertex
-        if (i == 0)
-            continue;
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    auto start_time = std::chrono::high_resolution_clock::now();
+    m_statistics.results_size = SLIC3R_STDVEC_MEMSIZE(gcode_result.moves, GCodeProcessorResult::MoveVertex);
+    m_statistics.results_time = gcode_result.time;
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-        const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
-        const GCodeProcessorResult::MoveVertex* next = nullptr;
-        if (i < m_moves_count - 1)
-            next = &gcode_result.moves[i + 1];
+    m_max_bounding_box.reset();
 
-        ++progress_count;
-        if (progress_dialog != nullptr && progress_count % progress_threshold == 0) {
-            progress_dialog->Update(int(100.0f * float(m_moves_count + i) / (2.0f * float(m_moves_count))),
-                _L("Generating index buffers") + ": " + wxNumberFormatter::ToString(100.0 * double(i) / double(m_moves_count), 0, wxNumberFormatter::Style_None) + "%");
-            progress_dialog->Fit();
-            progress_count = 0;
-        }
+    m_moves_count = gcode_result.moves.size();
+    if (m_moves_count == 0)
+        return;
 
-        assert(curr.type > EMoveType::Noop);
-        const unsigned char id = buffer_id(curr.type);
-        TBuffer& t_buffer = m_buffers[id];
-        MultiIndexBuffer& i_multibuffer = indices[id];
-        CurrVertexBuffer& curr_vertex_buffer = curr_vertex_buffers[id];
-#if ENABLE_GL_CORE_PROFILE
-        VIndexList& vao_index_list = vao_indices[id];
-        VIndexList& vbo_index_list = vbo_indices[id];
-#else
-        VboIndexList& vbo_index_list = vbo_indices[id];
-#endif // ENABLE_GL_CORE_PROFILE
+    m_extruders_count = gcode_result.extruders_count;
+    m_objects_count = gcode_result.object_names.size();
+    m_objects_ids = gcode_result.object_names;
 
-        // ensure there is at least one index buffer
-        if (i_multibuffer.empty()) {
-            i_multibuffer.push_back(IndexBuffer());
-#if ENABLE_GL_CORE_PROFILE
-            if (!t_buffer.vertices.vaos.empty() && OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 0))
-                vao_index_list.push_back(t_buffer.vertices.vaos[curr_vertex_buffer.first]);
+    wxProgressDialog* progress_dialog = wxGetApp().is_gcode_viewer() ?
+        new wxProgressDialog(_L("Generating toolpaths"), "...",
+            100, wxGetApp().mainframe, wxPD_AUTO_HIDE | wxPD_APP_MODAL) : nullptr;
 
-            if (!t_buffer.vertices.vbos.empty())
-                vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-#else
-            if (!t_buffer.vertices.vbos.empty())
-                vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-#endif // ENABLE_GL_CORE_PROFILE
-        }
+    wxBusyCursor busy;
 
-        // if adding the indices for the current segment exceeds the threshold size of the current index buffer
-        // create another index buffer
-        size_t indiced_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.indices_size_bytes() : t_buffer.max_indices_per_segment_size_bytes();
-        if (i_multibuffer.back().size() * sizeof(IBufferType) >= IBUFFER_THRESHOLD_BYTES - indiced_size_to_add) {
-            i_multibuffer.push_back(IndexBuffer());
-#if ENABLE_GL_CORE_PROFILE
-            if (OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 0))
-                vao_index_list.push_back(t_buffer.vertices.vaos[curr_vertex_buffer.first]);
-#endif // ENABLE_GL_CORE_PROFILE
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
-            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
-                Path& last_path = t_buffer.paths.back();
-                last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, move_id - 1);
-            }
+    // extract approximate paths bounding box from result
+    for (const GCodeProcessorResult::MoveVertex& move : gcode_result.moves) {
+        if (wxGetApp().is_gcode_viewer())
+            // for the gcode viewer we need to take in account all moves to correctly size the printbed
+            m_paths_bounding_box.merge(move.position.cast<double>());
+        else {
+            if (move.type == EMoveType::Extrude && move.extrusion_role != GCodeExtrusionRole::Custom && move.width != 0.0f && move.height != 0.0f)
+                m_paths_bounding_box.merge(move.position.cast<double>());
         }
+    }
 
-        // if adding the vertices for the current segment exceeds the threshold size of the current vertex buffer
-        // create another index buffer
-        size_t vertices_size_to_add = (t_buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::BatchedModel) ? t_buffer.model.data.vertices_size_bytes() : t_buffer.max_vertices_per_segment_size_bytes();
-        if (curr_vertex_buffer.second * t_buffer.vertices.vertex_size_bytes() > t_buffer.vertices.max_size_bytes() - vertices_size_to_add) {
-            i_multibuffer.push_back(IndexBuffer());
+    if (wxGetApp().is_editor())
+        m_contained_in_bed = wxGetApp().plater()->build_volume().all_paths_inside(gcode_result, m_paths_bounding_box);
 
-            ++curr_vertex_buffer.first;
-            curr_vertex_buffer.second = 0;
-#if ENABLE_GL_CORE_PROFILE
-            if (OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 0))
-                vao_index_list.push_back(t_buffer.vertices.vaos[curr_vertex_buffer.first]);
-#endif // ENABLE_GL_CORE_PROFILE
-            vbo_index_list.push_back(t_buffer.vertices.vbos[curr_vertex_buffer.first]);
+    m_cog.reset();
 
-            if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::BatchedModel) {
-                Path& last_path = t_buffer.paths.back();
-                last_path.add_sub_path(prev, static_cast<unsigned int>(i_multibuffer.size()) - 1, 0, move_id - 1);
-            }
-        }
+    m_sequential_view.gcode_ids.clear();
+    for (size_t i = 0; i < gcode_result.moves.size(); ++i) {
+        const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
+        if (curr.type != EMoveType::Seam)
+            m_sequential_view.gcode_ids.push_back(curr.gcode_id);
 
-        IndexBuffer& i_buffer = i_multibuffer.back();
+        // skip first vertex
+        if (i == 0)
+            continue;
 
-        switch (t_buffer.render_primitive_type)
-        {
-        case TBuffer::ERenderPrimitiveType::Line: {
-            add_indices_as_line(prev, curr, t_buffer, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id);
-            curr_vertex_buffer.second += t_buffer.max_vertices_per_segment();
-            break;
-        }
-        case TBuffer::ERenderPrimitiveType::Triangle: {
-            add_indices_as_solid(prev, curr, next, t_buffer, curr_vertex_buffer.second, static_cast<unsigned int>(i_multibuffer.size()) - 1, i_buffer, move_id);
-            break;
-        }
-        case TBuffer::ERenderPrimitiveType::BatchedModel: {
-            add_indices_as_model_batch(t_buffer.model.data, i_buffer, curr_vertex_buffer.second);
-            curr_vertex_buffer.second += t_buffer.model.data.vertices_count();
-            break;
-        }
-        default: { break; }
+        if (curr.type == EMoveType::Extrude &&
+            curr.extrusion_role != GCodeExtrusionRole::Skirt &&
+            curr.extrusion_role != GCodeExtrusionRole::SupportMaterial &&
+            curr.extrusion_role != GCodeExtrusionRole::SupportMaterialInterface &&
+            curr.extrusion_role != GCodeExtrusionRole::WipeTower &&
+            curr.extrusion_role != GCodeExtrusionRole::Custom) {
+            const GCodeProcessorResult::MoveVertex& prev = gcode_result.moves[i - 1];
+            const Vec3d curr_pos = curr.position.cast<double>();
+            const Vec3d prev_pos = prev.position.cast<double>();
+            m_cog.add_segment(curr_pos, prev_pos, curr.mm3_per_mm * (curr_pos - prev_pos).norm());
         }
     }
 
-    for (MultiIndexBuffer& i_multibuffer : indices) {
-        for (IndexBuffer& i_buffer : i_multibuffer) {
-            i_buffer.shrink_to_fit();
-        }
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(0, _L("Generating vertex buffer") + "...");
+        progress_dialog->Fit();
     }
 
-    // toolpaths data -> send indices data to gpu
-    for (size_t i = 0; i < m_buffers.size(); ++i) {
-        TBuffer& t_buffer = m_buffers[i];
-        if (t_buffer.render_primitive_type != TBuffer::ERenderPrimitiveType::InstancedModel) {
-            const MultiIndexBuffer& i_multibuffer = indices[i];
-            for (const IndexBuffer& i_buffer : i_multibuffer) {
-                const size_t size_elements = i_buffer.size();
-                const size_t size_bytes = size_elements * sizeof(IBufferType);
-
-                // stores index buffer informations into TBuffer
-                t_buffer.indices.push_back(IBuffer());
-                IBuffer& ibuf = t_buffer.indices.back();
-                ibuf.count = size_elements;
-#if ENABLE_GL_CORE_PROFILE
-                if (OpenGLManager::get_gl_info().is_version_greater_or_equal_to(3, 0))
-                    ibuf.vao = vao_indices[i][t_buffer.indices.size() - 1];
-#endif // ENABLE_GL_CORE_PROFILE
-                ibuf.vbo = vbo_indices[i][t_buffer.indices.size() - 1];
+    // toolpaths data -> extract vertices and indices from result, without any OpenGL call
+    ToolpathsGeometry geometry = generate_toolpaths_geometry(gcode_result.moves, m_buffers, m_extrusions.ranges, m_current_mode, true);
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
-                m_statistics.total_indices_gpu_size += static_cast<int64_t>(size_bytes);
-                m_statistics.max_ibuffer_gpu_size = std::max(m_statistics.max_ibuffer_gpu_size, static_cast<int64_t>(size_bytes));
-                ++m_statistics.ibuffers_count;
+    auto load_vertices_time = std::chrono::high_resolution_clock::now();
+    m_statistics.load_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(load_vertices_time - start_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
-
-                glsafe(::glGenBuffers(1, &ibuf.ibo));
-                glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibuf.ibo));
-                glsafe(::glBufferData(GL_ELEMENT_ARRAY_BUFFER, size_bytes, i_buffer.data(), GL_STATIC_DRAW));
-                glsafe(::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-            }
-        }
-    }
+    log_memory_usage("Loaded G-code generated toolpaths buffers ", geometry);
 
     if (progress_dialog != nullptr) {
-        progress_dialog->Update(100, "");
+        progress_dialog->Update(50, _L("Generating index buffers") + "...");
         progress_dialog->Fit();
     }
 
+    // send vertices and indices data to gpu
+    upload_toolpaths_geometry(m_buffers, geometry);
+
+#if ENABLE_GCODE_VIEWER_STATISTICS
+    auto smooth_vertices_time = std::chrono::high_resolution_clock::now();
+    m_statistics.smooth_vertices = std::chrono::duration_cast<std::chrono::milliseconds>(smooth_vertices_time - load_vertices_time).count();
+#endif // ENABLE_GCODE_VIEWER_STATISTICS
+
 #if ENABLE_GCODE_VIEWER_STATISTICS
     for (const TBuffer& buffer : m_buffers) {
         m_statistics.paths_size += SLIC3R_STDVEC_MEMSIZE(buffer.paths, Path);
@@ -2872,7 +3126,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
 
     auto update_segments_count = [&](EMoveType type, int64_t& count) {
         unsigned int id = buffer_id(type);
-        const MultiIndexBuffer& buffers = indices[id];
+        const MultiIndexBuffer& buffers = geometry.buffers[id].indices;
         int64_t indices_count = 0;
         for (const IndexBuffer& buffer : buffers) {
             indices_count += buffer.size();
@@ -2891,15 +3145,26 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
     m_statistics.load_indices = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - smooth_vertices_time).count();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-    log_memory_usage("Loaded G-code generated indices buffers ", vertices, indices);
-
     // dismiss indices data, no more needed
-    std::vector<MultiIndexBuffer>().swap(indices);
+    geometry = ToolpathsGeometry();
+
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(75, _L("Generating levels of detail") + "...");
+        progress_dialog->Fit();
+    }
+
+    // levels of detail -> simplified toolpaths rendered in place of the full resolution ones when the camera is far enough
+    load_toolpaths_lods(gcode_result);
+
+    if (progress_dialog != nullptr) {
+        progress_dialog->Update(100, "");
+        progress_dialog->Fit();
+    }
 
     // layers zs / roles / extruder ids -> extract from result
     size_t last_travel_s_id = 0;
     size_t first_travel_s_id = 0;
-    seams_count = 0;
+    size_t seams_count = 0;
     for (size_t i = 0; i < m_moves_count; ++i) {
         const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
         if (move.type == EMoveType::Seam)
@@ -2952,14 +3217,7 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         m_layers_z_range = { 0, static_cast<unsigned int>(m_layers.size() - 1) };
 
     // change color of paths whose layer contains option points
-    if (!options_zs.empty()) {
-        TBuffer& extrude_buffer = m_buffers[buffer_id(EMoveType::Extrude)];
-        for (Path& path : extrude_buffer.paths) {
-            const float z = path.sub_paths.front().first.position.z();
-            if (std::find_if(options_zs.begin(), options_zs.end(), [z](float f) { return f - EPSILON <= z && z <= f + EPSILON; }) != options_zs.end())
-                path.cp_color_id = 255 - path.cp_color_id;
-        }
-    }
+    update_options_layers_color_ids(m_buffers[buffer_id(EMoveType::Extrude)].paths, collect_options_zs(gcode_result));
 
 #if ENABLE_GCODE_VIEWER_STATISTICS
     m_statistics.load_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time).count();
@@ -2969,6 +3227,71 @@ void GCodeViewer::load_toolpaths(const GCodeProcessorResult& gcode_result)
         progress_dialog->Destroy();
 }
 
+std::vector<float> GCodeViewer::collect_options_zs(const GCodeProcessorResult& gcode_result)
+{
+    std::vector<float> options_zs;
+    for (size_t i = 1; i < gcode_result.moves.size(); ++i) {
+        const GCodeProcessorResult::MoveVertex& curr = gcode_result.moves[i];
+        if (curr.type == EMoveType::Pause_Print || curr.type == EMoveType::Custom_GCode) {
+            const float* const last_z = options_zs.empty() ? nullptr : &options_zs.back();
+            if (last_z == nullptr || curr.position[2] < *last_z - EPSILON || *last_z + EPSILON < curr.position[2])
+                options_zs.emplace_back(curr.position[2]);
+        }
+    }
+    return options_zs;
+}
+
+void GCodeViewer::update_options_layers_color_ids(std::vector<Path>& paths, const std::vector<float>& options_zs)
+{
+    if (options_zs.empty())
+        return;
+    for (Path& path : paths) {
+        const float z = path.sub_paths.front().first.position.z();
+        if (std::find_if(options_zs.begin(), options_zs.end(), [z](float f) { return f - EPSILON <= z && z <= f + EPSILON; }) != options_zs.end())
+            path.cp_color_id = 255 - path.cp_color_id;
+    }
+}
+
+void GCodeViewer::load_toolpaths_lods(const GCodeProcessorResult& gcode_result)
+{
+    // max distance of the dropped vertices from the simplified toolpaths, in mm, one level of detail for each value
+    static const std::array<float, 2> LODS_TOLERANCES = { 0.25f, 1.0f };
+    // a level of detail is generated only if it drops at least this fraction of the moves
+    static const float MIN_DROPPED_MOVES_RATIO = 0.5f;
+
+    // the moves are merged into paths depending on the path merging mode, release the levels of detail of the previous mode
+    for (ToolpathsLOD& lod : m_lods) {
+        lod.reset();
+    }
+    m_lods.clear();
+    m_lods_mode = m_current_mode;
+
+    const std::vector<float> options_zs = collect_options_zs(gcode_result);
+    m_lods.reserve(LODS_TOLERANCES.size());
+    for (float tolerance : LODS_TOLERANCES) {
+        ToolpathsLOD lod;
+        lod.tolerance = tolerance;
+        const std::vector<GCodeProcessorResult::MoveVertex> moves = simplify_toolpaths_moves(gcode_result.moves, tolerance,
+            m_extrusions.ranges, m_current_mode, lod.moves_ids);
+        if (float(moves.size()) > (1.0f - MIN_DROPPED_MOVES_RATIO) * float(gcode_result.moves.size()))
+            continue;
+
+        lod.buffers.resize(m_buffers.size());
+        for (size_t i = 0; i < m_buffers.size(); ++i) {
+            lod.buffers[i].render_primitive_type = m_buffers[i].render_primitive_type;
+            lod.buffers[i].vertices.format = m_buffers[i].vertices.format;
+            lod.buffers[i].shader = m_buffers[i].shader;
+        }
+
+        ToolpathsGeometry geometry = generate_toolpaths_geometry(moves, lod.buffers, m_extrusions.ranges, m_current_mode, true);
+        log_memory_used("Loaded G-code level of detail toolpaths buffers ",
+            static_cast<int64_t>(geometry.vertices_count_floats() * sizeof(float) + geometry.indices_count() * sizeof(IBufferType)));
+        upload_toolpaths_geometry(lod.buffers, geometry);
+        update_options_layers_color_ids(lod.buffers[buffer_id(EMoveType::Extrude)].paths, options_zs);
+        m_lods.emplace_back(std::move(lod));
+    }
+}
+
 void GCodeViewer::load_shells(const Print& print)
 {
     m_shells.volumes.clear();
@@ -2977,35 +3300,45 @@ void GCodeViewer::load_shells(const Print& print)
         // no shells, return
         return;
 
-    // adds objects' volumes 
+    // adds objects' volumes
+    const ModelObjectPtrs model_objects = wxGetApp().plater()->model().objects;
     for (const PrintObject* obj : print.objects()) {
-        const ModelObject* model_obj = obj->model_object();
-        int object_id = -1;
-        const ModelObjectPtrs model_objects = wxGetApp().plater()->model().objects;
-        for (int i = 0; i < static_cast<int>(model_objects.size()); ++i) {
-            if (model_obj->id() == model_objects[i]->id()) {
-                object_id = i;
-                break;
+        // identical ModelObjects may share a single PrintObject, load the shells of the instances of all of them
+        std::vector<std::pair<const ModelObject*, std::vector<int>>> instances_model_objects;
+        for (const PrintInstance& instance : obj->instances()) {
+            const ModelObject* model_obj = instance.model_instance->get_object();
+            auto it = std::find_if(instances_model_objects.begin(), instances_model_objects.end(),
+                [model_obj](const std::pair<const ModelObject*, std::vector<int>>& item) { return item.first == model_obj; });
+            if (it == instances_model_objects.end()) {
+                instances_model_objects.emplace_back(model_obj, std::vector<int>());
+                it = std::prev(instances_model_objects.end());
             }
+            const auto instance_it = std::find(model_obj->instances.begin(), model_obj->instances.end(), instance.model_instance);
+            it->second.emplace_back(int(instance_it - model_obj->instances.begin()));
         }
-        if (object_id == -1)
-            continue;
 
-        std::vector<int> instance_ids(model_obj->instances.size());
-        for (int i = 0; i < (int)model_obj->instances.size(); ++i) {
-            instance_ids[i] = i;
-        }
+        for (const auto& [model_obj, instance_ids] : instances_model_objects) {
+            int object_id = -1;
+            for (int i = 0; i < static_cast<int>(model_objects.size()); ++i) {
+                if (model_obj->id() == model_objects[i]->id()) {
+                    object_id = i;
+                    break;
+                }
+            }
+            if (object_id == -1)
+                continue;
 
-        size_t current_volumes_count = m_shells.volumes.volumes.size();
-        m_shells.volumes.load_object(model_obj, object_id, instance_ids);
+            size_t current_volumes_count = m_shells.volumes.volumes.size();
+            m_shells.volumes.load_object(model_obj, object_id, instance_ids);
 
-        // adjust shells' z if raft is present
-        const SlicingParameters& slicing_parameters = obj->slicing_parameters();
-        if (slicing_parameters.object_print_z_min != 0.0) {
-            const Vec3d z_offset = slicing_parameters.object_print_z_min * Vec3d::UnitZ();
-            for (size_t i = current_volumes_count; i < m_shells.volumes.volumes.size(); ++i) {
-                GLVolume* v = m_shells.volumes.volumes[i].get();
-                v->set_volume_offset(v->get_volume_offset() + z_offset);
+            // adjust shells' z if raft is present
+            const SlicingParameters& slicing_parameters = obj->slicing_parameters();
+            if (slicing_parameters.object_print_z_min != 0.0) {
+                const Vec3d z_offset = slicing_parameters.object_print_z_min * Vec3d::UnitZ();
+                for (size_t i = current_volumes_count; i < m_shells.volumes.volumes.size(); ++i) {
+                    GLVolume* v = m_shells.volumes.volumes[i].get();
+                    v->set_volume_offset(v->get_volume_offset() + z_offset);
+                }
             }
         }
     }
@@ -3097,7 +3430,8 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
     auto start_time = std::chrono::high_resolution_clock::now();
 #endif // ENABLE_GCODE_VIEWER_STATISTICS
 
-    auto extrusion_color = [this](const Path& path) {
+    // moves_ids maps the move ids of the path to the move ids of the full resolution toolpaths, for the levels of detail
+    auto extrusion_color = [this](const Path& path, const std::vector<size_t>* moves_ids = nullptr) {
         ColorRGBA color;
         switch (m_view_type)
         {
@@ -3113,13 +3447,14 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
             {
                 int extra_layer = m_layers.size() == 1 + m_layers_times.front().size() ? 1 : 0; 
                 const Path::Sub_Path& sub_path = path.sub_paths.front();
+                const size_t first_s_id = (moves_ids != nullptr) ? (*moves_ids)[sub_path.first.s_id] : sub_path.first.s_id;
                 double z = static_cast<double>(sub_path.first.position.z());
                 const std::vector<double>& zs = m_layers.get_zs();
                 const std::vector<Layers::Range>& ranges = m_layers.get_ranges();
                 size_t time_mode_id = static_cast<size_t>(m_time_estimate_mode);
                 for (size_t i = 0; i < zs.size(); ++i) {
                     if (std::abs(zs[i] - z) < EPSILON) {
-                        if (ranges[i].contains(sub_path.first.s_id)) {
+                        if (ranges[i].contains(first_s_id)) {
                             color = m_extrusions.ranges.layer_time[time_mode_id].get_color_at(
                                 m_layers_times[time_mode_id][i > 0 ? i - extra_layer : i]);
                             break;
@@ -3549,6 +3884,73 @@ void GCodeViewer::refresh_render_paths(bool keep_sequential_current_first, bool
     sequential_view->current.first = !top_layer_only && keep_sequential_current_first ? std::clamp(sequential_view->current.first, sequential_view->endpoints.first, sequential_view->endpoints.last) : sequential_view->endpoints.first;
     sequential_view->global = global_endpoints;
 
+    // third pass: collect the visible paths of the levels of detail, batched by color,
+    // the levels of detail are used only when the whole sequential range is shown
+    const bool whole_sequential_range = m_sequential_view.current.first == m_sequential_view.global.first &&
+        m_sequential_view.current.last == m_sequential_view.global.last;
+    for (ToolpathsLOD& lod : m_lods) {
+        for (size_t b = 0; b < lod.buffers.size(); ++b) {
+            TBuffer& buffer = lod.buffers[b];
+            buffer.render_paths.clear();
+            if (!whole_sequential_range || !m_buffers[b].visible || buffer.paths.empty())
+                continue;
+
+            // render paths sorted by index buffer, as render_toolpaths() requires
+            std::map<std::pair<unsigned int, ColorRGBA>, RenderPath> batches;
+            for (size_t i = 0; i < buffer.paths.size(); ++i) {
+                const Path& path = buffer.paths[i];
+                const size_t first_s_id = lod.moves_ids[path.sub_paths.front().first.s_id];
+                const size_t last_s_id = lod.moves_ids[path.sub_paths.back().last.s_id];
+                const size_t min_s_id = m_layers.get_range_at(m_layers_z_range[0]).first;
+                const size_t max_s_id = m_layers.get_range_at(m_layers_z_range[1]).last;
+                const bool first_in_range = min_s_id <= first_s_id && first_s_id <= max_s_id;
+                const bool last_in_range = min_s_id <= last_s_id && last_s_id <= max_s_id;
+                if (path.type == EMoveType::Travel ? !first_in_range && !last_in_range : !first_in_range || !last_in_range)
+                    continue;
+                if (path.type == EMoveType::Extrude && !is_visible(path))
+                    continue;
+                if (m_tool_colors.size() <= path.extruder_id)
+                    continue;
+
+                ColorRGBA color;
+                switch (path.type)
+                {
+                case EMoveType::Extrude: { color = extrusion_color(path, &lod.moves_ids); break; }
+                case EMoveType::Travel: {
+                    color = (m_view_type == EViewType::Feedrate || m_view_type == EViewType::Tool || m_view_type == EViewType::ColorPrint) ?
+                        extrusion_color(path, &lod.moves_ids) : travel_color(path);
+                    break;
+                }
+                case EMoveType::Wipe: { color = Wipe_Color; break; }
+                default: { color = { 0.0f, 0.0f, 0.0f, 1.0f }; break; }
+                }
+
+                for (size_t j = 0; j < path.sub_paths.size(); ++j) {
+                    const Path::Sub_Path& sub_path = path.sub_paths[j];
+                    unsigned int size_in_indices = buffer.indices_per_segment() * static_cast<unsigned int>(sub_path.last.s_id - sub_path.first.s_id);
+                    if (size_in_indices == 0)
+                        continue;
+                    if (buffer.render_primitive_type == TBuffer::ERenderPrimitiveType::Triangle) {
+                        if (j == 0)
+                            size_in_indices += 6; // add 2 triangles for starting cap
+                        if (j == path.sub_paths.size() - 1)
+                            size_in_indices += 6; // add 2 triangles for ending cap
+                    }
+
+                    RenderPath& render_path = batches.try_emplace({ sub_path.first.b_id, color },
+                        RenderPath{ static_cast<unsigned char>(b), color, sub_path.first.b_id, static_cast<unsigned int>(i) }).first->second;
+                    render_path.sizes.push_back(size_in_indices);
+                    render_path.offsets.push_back(static_cast<size_t>(sub_path.first.i_id * sizeof(IBufferType)));
+                }
+            }
+
+            buffer.render_paths.reserve(batches.size());
+            for (auto& [key, render_path] : batches) {
+                buffer.render_paths.emplace_back(std::move(render_path));
+            }
+        }
+    }
+
     // updates sequential range caps
     std::array<SequentialRangeCap, 2>* sequential_range_caps = const_cast<std::array<SequentialRangeCap, 2>*>(&m_sequential_range_caps);
     (*sequential_range_caps)[0].reset();
@@ -3871,13 +4273,29 @@ void GCodeViewer::render_toolpaths()
         return (zoom < 5.0) ? 1.0 : (1.0 + 5.0 * (zoom - 5.0) / (100.0 - 5.0));
     };
 
+    // select the coarsest level of detail whose tolerance is smaller than the size of a pixel at the camera target,
+    // the levels of detail contain render paths only when the whole sequential range is shown
+    ToolpathsLOD* lod = nullptr;
+    if (!m_lods.empty() && m_sequential_view.current.first == m_sequential_view.global.first &&
+        m_sequential_view.current.last == m_sequential_view.global.last) {
+        const std::array<int, 4>& viewport = camera.get_viewport();
+        double pixel_size = camera.get_near_height() / double(std::max(1, viewport[3]));
+        if (camera.get_type() == Camera::EType::Perspective)
+            pixel_size *= camera.get_distance() / camera.get_near_z();
+        for (ToolpathsLOD& level : m_lods) {
+            if (double(level.tolerance) <= pixel_size)
+                lod = &level;
+        }
+    }
+
     const unsigned char begin_id = buffer_id(EMoveType::Retract);
     const unsigned char end_id   = buffer_id(EMoveType::Count);
 
     for (unsigned char i = begin_id; i < end_id; ++i) {
-        TBuffer& buffer = m_buffers[i];
-        if (!buffer.visible || !buffer.has_data())
+        if (!m_buffers[i].visible || !m_buffers[i].has_data())
             continue;
+        // travels, extrusions and wipes are rendered from the selected level of detail, if any
+        TBuffer& buffer = (lod != nullptr && lod->buffers[i].has_data()) ? lod->buffers[i] : m_buffers[i];
 
         GLShaderProgram* shader = wxGetApp().get_shader(buffer.shader.c_str());
         if (shader == nullptr)
@@ -5505,18 +5923,28 @@ void GCodeViewer::log_memory_used(const std::string& label, int64_t additional)
     if (Slic3r::get_logging_level() >= 5) {
         int64_t paths_size = 0;
         int64_t render_paths_size = 0;
-        for (const TBuffer& buffer : m_buffers) {
+        auto add_buffer_size = [&paths_size, &render_paths_size](const TBuffer& buffer) {
             paths_size += SLIC3R_STDVEC_MEMSIZE(buffer.paths, Path);
             render_paths_size += SLIC3R_STDUNORDEREDSET_MEMSIZE(buffer.render_paths, RenderPath);
             for (const RenderPath& path : buffer.render_paths) {
                 render_paths_size += SLIC3R_STDVEC_MEMSIZE(path.sizes, unsigned int);
                 render_paths_size += SLIC3R_STDVEC_MEMSIZE(path.offsets, size_t);
             }
+        };
+        for (const TBuffer& buffer : m_buffers) {
+            add_buffer_size(buffer);
+        }
+        int64_t lods_size = 0;
+        for (const ToolpathsLOD& lod : m_lods) {
+            for (const TBuffer& buffer : lod.buffers) {
+                add_buffer_size(buffer);
+            }
+            lods_size += SLIC3R_STDVEC_MEMSIZE(lod.moves_ids, size_t);
         }
         int64_t layers_size = SLIC3R_STDVEC_MEMSIZE(m_layers.get_zs(), double);
         layers_size += SLIC3R_STDVEC_MEMSIZE(m_layers.get_ranges(), Layers::Range);
         BOOST_LOG_TRIVIAL(trace) << label
-            << "(" << format_memsize_MB(additional + paths_size + render_paths_size + layers_size) << ");"
+            << "(" << format_memsize_MB(additional + paths_size + render_paths_size + layers_size + lods_size) << ");"
             << log_memory_info();
     }
 }
@@ -560,11 +560,6 @@ class GCodeViewer
 
         void reset();
 
-        // b_id index of buffer contained in this->indices
-        // i_id index of first index contained in this->indices[b_id]
-        // s_id index of first vertex contained in this->vertices
-        void add_path(const GCodeProcessorResult::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id);
-
         unsigned int max_vertices_per_segment() const {
             switch (render_primitive_type)
             {
@@ -612,6 +607,52 @@ class GCodeViewer
         }
     };
 
+public:
+    // Toolpaths data generated on the cpu side by generate_toolpaths_geometry(), to be sent to the gpu by load_toolpaths()
+    struct ToolpathsGeometry
+    {
+        // Data of a single TBuffer
+        struct Buffer
+        {
+            MultiVertexBuffer vertices;
+            MultiIndexBuffer indices;
+            // index of the vertex buffer into this->vertices referenced by each index buffer into this->indices
+            std::vector<unsigned int> vbuffer_ids;
+            InstanceBuffer instances;
+            InstanceIdBuffer instances_ids;
+            InstancesOffsets instances_offsets;
+            std::vector<Path> paths;
+
+            // b_id index of buffer contained in this->indices
+            // i_id index of first index contained in this->indices[b_id]
+            // s_id index of first vertex contained in this->vertices
+            void add_path(const GCodeProcessorResult::MoveVertex& move, unsigned int b_id, size_t i_id, size_t s_id);
+        };
+
+        // indexed by buffer id, one buffer per toolpath type
+        std::vector<Buffer> buffers;
+
+        size_t vertices_count_floats() const;
+        size_t indices_count() const;
+    };
+
+private:
+    // Simplified toolpaths, rendered in place of the full resolution toolpaths when the whole sequential range is shown
+    // and the camera is far enough for the dropped details to be smaller than a pixel.
+    // Collinear segments and segments shorter than the tolerance are merged, travels, extrusions and wipes only.
+    struct ToolpathsLOD
+    {
+        // max distance of the dropped vertices from the simplified toolpaths, in mm
+        float tolerance{ 0.0f };
+        // move ids of the full resolution toolpaths, indexed by the move ids of the simplified toolpaths
+        std::vector<size_t> moves_ids;
+        // same layout as GCodeViewer::m_buffers, only the buffers of travels, extrusions and wipes contain data
+        std::vector<TBuffer> buffers;
+
+        void reset();
+        bool has_data() const;
+    };
+
     // helper to render shells
     struct Shells
     {
@@ -883,6 +924,11 @@ private:
 
     size_t m_moves_count{ 0 };
     std::vector<TBuffer> m_buffers{ static_cast<size_t>(EMoveType::Count) - 1 };
+    // levels of detail of m_buffers, sorted by increasing tolerance,
+    // mutable as their render paths are a cache updated by refresh_render_paths()
+    mutable std::vector<ToolpathsLOD> m_lods;
+    // path merging mode the levels of detail were simplified with
+    Path::MatchMode m_lods_mode{ Path::MatchMode::mmDefault };
     // bounding box of toolpaths
     BoundingBoxf3 m_paths_bounding_box;
     // bounding box of shells
@@ -1016,8 +1062,34 @@ public:
 
     void load_shells(const Print& print);
 
+    // Generates the toolpaths data on the cpu side, as load_toolpaths() does, without any OpenGL call, thus not requiring a display.
+    // The buffers are laid out as init() does on an OpenGL 3.3 context, paths are merged with the default match mode.
+    // Used to benchmark and to verify the generation of the toolpaths, see sandboxes/gcode_viewer_buffers.
+    static ToolpathsGeometry generate_toolpaths_geometry(const GCodeProcessorResult& gcode_result, bool parallel = true);
+    // Simplifies the moves for a level of detail of the toolpaths, see ToolpathsLOD, with the default match mode.
+    // moves_ids receives the move id of each returned move into gcode_result.moves.
+    static std::vector<GCodeProcessorResult::MoveVertex> simplify_toolpaths_moves(const GCodeProcessorResult& gcode_result, float tolerance,
+        std::vector<size_t>& moves_ids);
+
 private:
+    // Sets the render primitive type and the vertex format of the given TBuffer, without any OpenGL call.
+    static void init_buffer_layout(TBuffer& buffer, EMoveType type, bool instanced_models);
+    // Generates the vertex and index data of all the TBuffers on the cpu side.
+    // The moves are split into ranges of whole layers processed in parallel, the data of the ranges are then merged.
+    static ToolpathsGeometry generate_toolpaths_geometry(const std::vector<GCodeProcessorResult::MoveVertex>& moves, const std::vector<TBuffer>& buffers,
+        const Extrusions::Ranges& extrusion_ranges, Path::MatchMode match_mode, bool parallel);
+    // Drops the moves whose removal does not move the toolpaths by more than tolerance, and which do not change the
+    // properties of the paths. Layers are processed in parallel.
+    static std::vector<GCodeProcessorResult::MoveVertex> simplify_toolpaths_moves(const std::vector<GCodeProcessorResult::MoveVertex>& moves, float tolerance,
+        const Extrusions::Ranges& extrusion_ranges, Path::MatchMode match_mode, std::vector<size_t>& moves_ids);
+    // Sends the given toolpaths data to the gpu, into the given TBuffers.
+    void upload_toolpaths_geometry(std::vector<TBuffer>& t_buffers, ToolpathsGeometry& geometry);
     void load_toolpaths(const GCodeProcessorResult& gcode_result);
+    // (Re)generates the levels of detail with the current path merging mode.
+    void load_toolpaths_lods(const GCodeProcessorResult& gcode_result);
+    // Z of the layers containing pause prints or custom G-codes, the color ids of their extrusion paths are inverted.
+    static std::vector<float> collect_options_zs(const GCodeProcessorResult& gcode_result);
+    static void update_options_layers_color_ids(std::vector<Path>& paths, const std::vector<float>& options_zs);
     void load_wipetower_shell(const Print& print);
     void render_toolpaths();
     void render_shells();
@@ -301,6 +301,7 @@ enum SlicedInfoIdx
     siCost,
     siEstimatedTime,
     siWTNumbetOfToolchanges,
+    siIdenticalLayers,
 
     siCount
 };
@@ -343,6 +344,7 @@ SlicedInfo::SlicedInfo(wxWindow *parent) :
     init_info_label(_L("Cost (money)"));
     init_info_label(_L("Estimated printing time"));
     init_info_label(_L("Number of tool changes"));
+    init_info_label(_L("Identical layers"));
 
     Add(grid_sizer, 0, wxEXPAND);
     this->Show(false);
@@ -1477,6 +1479,9 @@ void Sidebar::update_sliced_info_sizer()
 
             p->plater->get_notification_manager()->set_slicing_complete_print_time(_u8L("Estimated printing time") + ": " + boost::nowide::narrow(t_est), p->plater->is_sidebar_collapsed());
 
+            // Layers sharing the raster of a previous layer, the archive stores their image once.
+            p->sliced_info->SetTextAndShow(siIdenticalLayers, ps.duplicate_layers_count > 0 ? wxString::Format("%d", int(ps.duplicate_layers_count)) : "N/A", _L("Identical layers") + ":");
+
             // Hide non-SLA sliced info parameters
             p->sliced_info->SetTextAndShow(siFilament_m, "N/A");
             p->sliced_info->SetTextAndShow(siFilament_mm3, "N/A");
@@ -1668,6 +1673,7 @@ void Sidebar::update_sliced_info_sizer()
 
             // Hide non-FFF sliced info parameters
             p->sliced_info->SetTextAndShow(siMateril_unit, "N/A");
+            p->sliced_info->SetTextAndShow(siIdenticalLayers, "N/A");
         }
     }
 
@@ -26,6 +26,7 @@
 
 #include <libslic3r/libslic3r.h>
 #include <libslic3r/Utils.hpp>
+#include "UploadStream.hpp"
 #include <slic3r/GUI/I18N.hpp>
 #include <slic3r/GUI/format.hpp>
 
@@ -161,6 +162,9 @@ struct Http::priv
 	size_t limit;
 	bool cancel;
     std::unique_ptr<boost::nowide::ifstream> putFile;
+	// Data produced while the request is being performed, either a multipart form file or a PUT body.
+	std::shared_ptr<UploadStream> upload_stream;
+	std::unique_ptr<std::istream> upload_istream;
 
 	std::thread io_thread;
 	Http::CompleteFn completefn;
@@ -183,6 +187,8 @@ struct Http::priv
 	void set_post_body(const fs::path &path);
 	void set_post_body(const std::string &body);
 	void set_put_body(const fs::path &path);
+	void form_add_stream(const char *name, std::shared_ptr<UploadStream> stream, const char *filename);
+	void set_put_body(std::shared_ptr<UploadStream> stream);
 	void set_range(const std::string& range);
 
 	std::string curl_error(CURLcode curlcode);
@@ -215,6 +221,9 @@ Http::priv::priv(const std::string &url)
 
 Http::priv::~priv()
 {
+	if (upload_stream)
+		// Let the producer know that its data will not be uploaded if the request was never performed.
+		upload_stream->abort();
 	::curl_easy_cleanup(curl);
 	::curl_formfree(form);
 	::curl_slist_free_all(headerlist);
@@ -282,13 +291,17 @@ int Http::priv::xfercb_legacy(void *userp, double dltotal, double dlnow, double
 
 size_t Http::priv::form_file_read_cb(char *buffer, size_t size, size_t nitems, void *userp)
 {
-	auto stream = reinterpret_cast<boost::nowide::ifstream*>(userp);
+	// Either a boost::nowide::ifstream or an std::istream over an UploadStream.
+	auto stream = reinterpret_cast<std::istream*>(userp);
 
 	try {
 		stream->read(buffer, size * nitems);
 	} catch (const std::exception &) {
 		return CURL_READFUNC_ABORT;
 	}
+	if (stream->bad())
+		// Reading the file failed or the UploadStream was aborted.
+		return CURL_READFUNC_ABORT;
 
 	return stream->gcount();
 }
@@ -323,7 +336,7 @@ void Http::priv::form_add_file(const char *name, const fs::path &path, const cha
 			CURLFORM_COPYNAME, name,
 			CURLFORM_FILENAME, filename,
 			CURLFORM_CONTENTTYPE, "application/octet-stream",
-			CURLFORM_STREAM, static_cast<void*>(&stream),
+			CURLFORM_STREAM, static_cast<void*>(static_cast<std::istream*>(&stream)),
 			CURLFORM_CONTENTSLENGTH, static_cast<long>(size),
 			CURLFORM_END
 		);
@@ -349,11 +362,37 @@ void Http::priv::set_put_body(const fs::path &path)
 	boost::uintmax_t filesize = file_size(path, ec);
 	if (!ec) {
         putFile = std::make_unique<boost::nowide::ifstream>(path.string(), std::ios::binary);
-        ::curl_easy_setopt(curl, CURLOPT_READDATA, (void *) (putFile.get()));
+        ::curl_easy_setopt(curl, CURLOPT_READDATA, (void *) static_cast<std::istream*>(putFile.get()));
 		::curl_easy_setopt(curl, CURLOPT_INFILESIZE, filesize);
 	}
 }
 
+void Http::priv::form_add_stream(const char *name, std::shared_ptr<UploadStream> stream, const char *filename)
+{
+	assert(! upload_stream);
+	upload_stream  = std::move(stream);
+	upload_istream = std::make_unique<std::istream>(upload_stream.get());
+	// Without CURLFORM_CONTENTSLENGTH, the size of the part is unknown and curl sends the body chunked.
+	::curl_formadd(&form, &form_end,
+		CURLFORM_COPYNAME, name,
+		CURLFORM_FILENAME, filename,
+		CURLFORM_CONTENTTYPE, "application/octet-stream",
+		CURLFORM_STREAM, static_cast<void*>(upload_istream.get()),
+		CURLFORM_END
+	);
+	headerlist = curl_slist_append(headerlist, "Transfer-Encoding: chunked");
+}
+
+void Http::priv::set_put_body(std::shared_ptr<UploadStream> stream)
+{
+	assert(! upload_stream);
+	upload_stream  = std::move(stream);
+	upload_istream = std::make_unique<std::istream>(upload_stream.get());
+	// CURLOPT_INFILESIZE is not set, curl sends the body chunked.
+	::curl_easy_setopt(curl, CURLOPT_READDATA, static_cast<void*>(upload_istream.get()));
+	headerlist = curl_slist_append(headerlist, "Transfer-Encoding: chunked");
+}
+
 void Http::priv::set_range(const std::string& range)
 {
 	::curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
@@ -411,6 +450,12 @@ void Http::priv::http_perform()
 	CURLcode res = ::curl_easy_perform(curl);
 
     putFile.reset();
+	if (upload_stream) {
+		// Let the producer stop writing if the request ended before consuming all the data (error, cancellation, early response).
+		if (res != CURLE_OK || ! upload_stream->closed() || upload_istream->peek() != std::char_traits<char>::eof())
+			upload_stream->abort();
+		upload_istream.reset();
+	}
 
 	if (res != CURLE_OK) {
 		if (res == CURLE_ABORTED_BY_CALLBACK) {
@@ -599,6 +644,18 @@ Http& Http::set_post_body(const std::string &body)
 	return *this;
 }
 
+Http& Http::form_add_stream(const std::string &name, std::shared_ptr<UploadStream> stream, const std::string &filename)
+{
+	if (p) { p->form_add_stream(name.c_str(), std::move(stream), filename.c_str()); }
+	return *this;
+}
+
+Http& Http::set_put_body(std::shared_ptr<UploadStream> stream)
+{
+	if (p) { p->set_put_body(std::move(stream)); }
+	return *this;
+}
+
 Http& Http::set_put_body(const fs::path &path)
 {
 	if (p) { p->set_put_body(path);}
@@ -15,6 +15,8 @@
 
 namespace Slic3r {
 
+class UploadStream;
+
 	// simple download
 	bool get_file_from_web(const std::string& url, const boost::filesystem::path& target_path);
 
@@ -118,6 +120,13 @@ public:
 	// This can be used for hosts which do not support multipart requests.
 	Http& set_put_body(const boost::filesystem::path &path);
 
+	// Add a HTTP multipart form file field, which contents are read from the stream while the request is being performed.
+	// The size is not known in advance, therefore the request body is sent with chunked transfer encoding.
+	// The stream is aborted if the request fails or it is cancelled, so that its producer does not block.
+	Http& form_add_stream(const std::string &name, std::shared_ptr<UploadStream> stream, const std::string &filename);
+	// Set the data read from the stream as a PUT request body, sent with chunked transfer encoding.
+	Http& set_put_body(std::shared_ptr<UploadStream> stream);
+
 	// Callback called on HTTP request complete
 	Http& on_complete(CompleteFn fn);
 	// Callback called on an error occuring at any stage of the requests: Url parsing, DNS lookup,
@@ -212,8 +212,11 @@ bool Moonraker::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, Erro
     if (upload_data.post_action == PrintHostPostUploadAction::StartPrint)
         http.form_add("print", "true");
    
-    http.form_add_file("file", upload_data.source_path.string(), upload_filename.string())
-        .on_complete([&](std::string body, unsigned status) {
+    if (upload_data.source_stream)
+        http.form_add_stream("file", upload_data.source_stream, upload_filename.string());
+    else
+        http.form_add_file("file", upload_data.source_path.string(), upload_filename.string());
+    http.on_complete([&](std::string body, unsigned status) {
             BOOST_LOG_TRIVIAL(debug) << boost::format("%1%: File uploaded: HTTP %2%: %3%") % name % status % body;
         })
         .on_error([&](std::string body, std::string error, unsigned status) {
@@ -36,6 +36,8 @@ public:
     bool has_auto_discovery() const override { return true; }
     bool can_test() const override { return true; }
     PrintHostPostUploadActions get_post_upload_actions() const override { return PrintHostPostUploadAction::StartPrint; }
+    // Moonraker (Tornado) accepts a multipart upload with chunked transfer encoding.
+    bool can_stream_upload() const override { return true; }
     std::string get_host() const override { return m_host; }
     const std::string& get_apikey() const { return m_apikey; }
     const std::string& get_cafile() const { return m_cafile; }
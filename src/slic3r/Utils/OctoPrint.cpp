@@ -319,6 +319,10 @@ bool OctoPrint::upload(PrintHostUpload upload_data, ProgressFn prorgess_fn, Erro
 #ifndef WIN32
     return upload_inner_with_host(std::move(upload_data), prorgess_fn, error_fn, info_fn);
 #else
+    if (upload_data.source_stream)
+        // The stream can be read just once, it cannot be retried with another resolved address.
+        return upload_inner_with_host(std::move(upload_data), prorgess_fn, error_fn, info_fn);
+
     std::string host = get_host_from_url(m_host);
 
     // decide what to do based on m_host - resolve hostname or upload to ip
@@ -531,8 +535,11 @@ void OctoPrint::set_http_send(Http& http, const PrintHostUpload& upload_data) co
     const auto upload_filename = upload_data.upload_path.filename();
     const auto upload_parent_path = upload_data.upload_path.parent_path();
     http.form_add("print", upload_data.post_action == PrintHostPostUploadAction::StartPrint ? "true" : "false")
-        .form_add("path", upload_parent_path.string())      // XXX: slashes on windows ???
-        .form_add_file("file", upload_data.source_path.string(), upload_filename.string());
+        .form_add("path", upload_parent_path.string());      // XXX: slashes on windows ???
+    if (upload_data.source_stream)
+        http.form_add_stream("file", upload_data.source_stream, upload_filename.string());
+    else
+        http.form_add_file("file", upload_data.source_path.string(), upload_filename.string());
 }
 
 bool OctoPrint::validate_version_text(const std::optional<std::string> &version_text) const
@@ -35,6 +35,8 @@ public:
     bool has_auto_discovery() const override { return true; }
     bool can_test() const override { return true; }
     PrintHostPostUploadActions get_post_upload_actions() const override { return PrintHostPostUploadAction::StartPrint; }
+    // OctoPrint (Tornado) accepts a multipart upload with chunked transfer encoding.
+    bool can_stream_upload() const override { return true; }
     std::string get_host() const override { return m_host; }
     const std::string& get_apikey() const { return m_apikey; }
     const std::string& get_cafile() const { return m_cafile; }
@@ -76,6 +78,7 @@ public:
     wxString get_test_ok_msg() const override;
     wxString get_test_failed_msg(wxString& msg) const override;
     PrintHostPostUploadActions get_post_upload_actions() const override { return {}; }
+    bool can_stream_upload() const override { return false; }
 
 protected:
     bool validate_version_text(const std::optional<std::string>& version_text) const override;
@@ -95,6 +98,7 @@ public:
     wxString get_test_ok_msg() const override;
     wxString get_test_failed_msg(wxString& msg) const override;
     virtual PrintHostPostUploadActions get_post_upload_actions() const override { return PrintHostPostUploadAction::StartPrint; }
+    bool can_stream_upload() const override { return false; }
 
     // gets possible storage to be uploaded to. This allows different printer to have different storage. F.e. local vs sdcard vs usb.
     bool get_storage(wxArrayString& storage_path, wxArrayString& storage_name) const override;
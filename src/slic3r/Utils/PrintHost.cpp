@@ -31,6 +31,7 @@
 #include "MPMDv2.hpp"
 #include "MKS.hpp"
 #include "Moonraker.hpp"
+#include "UploadStream.hpp"
 #include "../GUI/PrintHostDialogs.hpp"
 #include "../GUI/GUI.hpp"
 #include "slic3r/GUI/I18N.hpp"
@@ -212,9 +213,13 @@ void PrintHostJobQueue::priv::bg_thread_main()
                 % job.printhost->get_host()
                 % job.cancelled;
 
+            // Keep the stream alive to stop its producer if the job was cancelled or the upload did not consume it.
+            std::shared_ptr<UploadStream> source_stream = job.upload_data.source_stream;
             if (! job.cancelled) {
                 perform_job(std::move(job));
             }
+            if (source_stream)
+                source_stream->abort();
 
             remove_source();
             job_id++;
@@ -228,6 +233,8 @@ void PrintHostJobQueue::priv::bg_thread_main()
     auto jobs = channel_jobs.lock_rw();
     for (const PrintHostJob &job : *jobs) {
         remove_source(job.upload_data.source_path);
+        if (job.upload_data.source_stream)
+            job.upload_data.source_stream->abort();
     }
 }
 
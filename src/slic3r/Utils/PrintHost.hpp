@@ -38,6 +38,9 @@ struct PrintHostUpload
 {
     boost::filesystem::path source_path;
     boost::filesystem::path upload_path;
+    // If set, the data is uploaded from this stream while it is being produced and source_path is empty.
+    // Only used if PrintHost::can_stream_upload() returns true.
+    std::shared_ptr<UploadStream> source_stream;
     
     std::string group;
     std::string storage;
@@ -73,6 +76,8 @@ public:
     virtual PrintHostPostUploadActions get_post_upload_actions() const = 0;
     // A print host usually does not support multiple printers, with the exception of Repetier server.
     virtual bool supports_multiple_printers() const { return false; }
+    // Whether the host accepts uploads with chunked transfer encoding, see PrintHostUpload::source_stream.
+    virtual bool can_stream_upload() const { return false; }
     virtual std::string get_host() const = 0;
 
     // Support for Repetier server multiple groups & printers. Not supported by other print hosts.
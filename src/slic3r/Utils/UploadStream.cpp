@@ -0,0 +1,124 @@
+#include "UploadStream.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+namespace Slic3r {
+
+// Size of the blocks read by underflow() from the spool file.
+static constexpr const size_t READ_BUFFER_SIZE = 256 * 1024;
+
+UploadStream::UploadStream(const boost::filesystem::path &spool_path) : m_spool_path(spool_path)
+{
+    m_spool_out = boost::nowide::fopen(m_spool_path.string().c_str(), "wb");
+    if (m_spool_out == nullptr) {
+        BOOST_LOG_TRIVIAL(error) << "UploadStream: Failed to create the spool file " << m_spool_path;
+        m_aborted = true;
+    }
+}
+
+UploadStream::~UploadStream()
+{
+    if (m_spool_in)
+        fclose(m_spool_in);
+    if (m_spool_out)
+        fclose(m_spool_out);
+    boost::system::error_code ec;
+    boost::filesystem::remove(m_spool_path, ec);
+    if (ec)
+        BOOST_LOG_TRIVIAL(error) << "UploadStream: Failed to remove the spool file " << m_spool_path << ": " << ec.message();
+}
+
+bool UploadStream::write(const char *data, size_t size)
+{
+    if (this->aborted())
+        return false;
+    if (size > 0) {
+        // The data has to reach the file before the consumer is allowed to read it.
+        if (fwrite(data, 1, size, m_spool_out) != size || fflush(m_spool_out) != 0) {
+            BOOST_LOG_TRIVIAL(error) << "UploadStream: Failed writing the spool file " << m_spool_path;
+            this->abort();
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lck(m_mutex);
+            m_bytes_written += size;
+        }
+        m_cond.notify_all();
+    }
+    return true;
+}
+
+void UploadStream::close()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_closed = true;
+    }
+    m_cond.notify_all();
+}
+
+void UploadStream::abort()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_mutex);
+        m_aborted = true;
+    }
+    m_cond.notify_all();
+}
+
+bool UploadStream::closed() const
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    return m_closed;
+}
+
+bool UploadStream::aborted() const
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    return m_aborted;
+}
+
+size_t UploadStream::bytes_written() const
+{
+    std::lock_guard<std::mutex> lck(m_mutex);
+    return m_bytes_written;
+}
+
+UploadStream::int_type UploadStream::underflow()
+{
+    if (this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+    size_t available = 0;
+    {
+        std::unique_lock<std::mutex> lck(m_mutex);
+        m_cond.wait(lck, [this]() { return m_aborted || m_closed || m_bytes_written > m_bytes_read; });
+        if (m_aborted)
+            throw std::runtime_error("Upload stream aborted");
+        available = m_bytes_written - m_bytes_read;
+    }
+    if (available == 0) {
+        // Closed and fully consumed.
+        this->setg(nullptr, nullptr, nullptr);
+        return traits_type::eof();
+    }
+    if (m_spool_in == nullptr && (m_spool_in = boost::nowide::fopen(m_spool_path.string().c_str(), "rb")) == nullptr)
+        throw std::runtime_error("Upload stream: Failed to open the spool file " + m_spool_path.string());
+    m_buffer.resize(READ_BUFFER_SIZE);
+    // Only the bytes already flushed by the producer are read, thus a short read is an error.
+    // The end of file indicator may have been set by a read-ahead of a previous call, clear it.
+    clearerr(m_spool_in);
+    size_t size = std::min(available, m_buffer.size());
+    if (fread(m_buffer.data(), 1, size, m_spool_in) != size)
+        throw std::runtime_error("Upload stream: Failed reading the spool file " + m_spool_path.string());
+    m_bytes_read += size;
+    char *begin = m_buffer.data();
+    this->setg(begin, begin, begin + size);
+    return traits_type::to_int_type(*begin);
+}
+
+} // namespace Slic3r
@@ -0,0 +1,68 @@
+#ifndef slic3r_UploadStream_hpp_
+#define slic3r_UploadStream_hpp_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <streambuf>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+namespace Slic3r {
+
+// Pipe between a producer (the G-code export) and Http, which uploads the data with chunked transfer encoding
+// while it is still being produced. The data is spooled into a file, which the consumer reads behind the producer.
+// Thus the producer never waits for the consumer: Neither a slow network, nor an upload job waiting in the print host
+// queue for the previous uploads slow down the G-code export, and the export may be canceled at any time.
+// Http reads the data through a std::istream created over this streambuf.
+class UploadStream : public std::streambuf
+{
+public:
+    // The spool file is created at spool_path and it is deleted by the destructor.
+    // If the spool file cannot be created, the stream is aborted right away.
+    explicit UploadStream(const boost::filesystem::path &spool_path);
+    ~UploadStream() override;
+    UploadStream(const UploadStream &) = delete;
+    UploadStream& operator=(const UploadStream &) = delete;
+
+    // Producer: Append data to the spool file, never blocks.
+    // Returns false if the transfer was aborted or if writing the spool file failed, the data is dropped then.
+    bool        write(const char *data, size_t size);
+    // Producer: No more data will be written, the consumer will see the end of the stream.
+    void        close();
+    // Either side: Abort the transfer, wakes up the consumer.
+    // The consumer will see a read error, the producer will see write() failing.
+    void        abort();
+
+    bool        closed() const;
+    bool        aborted() const;
+    // Number of bytes written by the producer so far.
+    size_t      bytes_written() const;
+
+protected:
+    // Consumer: Blocks until some data is available, the stream is closed or aborted.
+    // Throws if aborted, which makes the std::istream reading this streambuf set its badbit.
+    int_type    underflow() override;
+
+private:
+    const boost::filesystem::path m_spool_path;
+    // Written by the producer only.
+    FILE                         *m_spool_out     { nullptr };
+    // Read by the consumer only, opened on the first read.
+    FILE                         *m_spool_in      { nullptr };
+    mutable std::mutex            m_mutex;
+    std::condition_variable       m_cond;
+    // Bytes written and flushed to the spool file, thus readable by the consumer.
+    size_t                        m_bytes_written { 0 };
+    bool                          m_closed        { false };
+    bool                          m_aborted       { false };
+    // Consumer only: Bytes read from the spool file and the get area of the streambuf.
+    size_t                        m_bytes_read    { 0 };
+    std::vector<char>             m_buffer;
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_UploadStream_hpp_ */
@@ -13,6 +13,7 @@
 
 #include <libslic3r/Arrange/Core/NFP/NFPConcave_CGAL.hpp>
 #include <libslic3r/Arrange/Core/NFP/NFPConcave_Tesselate.hpp>
+#include <libslic3r/Arrange/Core/NFP/NFPCache.hpp>
 #include <libslic3r/Arrange/Core/NFP/CircularEdgeIterator.hpp>
 
 #include <libslic3r/Arrange/Items/SimpleArrangeItem.hpp>
@@ -463,6 +464,62 @@ TEST_CASE("NFP should be empty if item cannot fit into bed", "[arrange2]") {
     }
 }
 
+TEST_CASE("Cached NFP of convex polygons equals the computed one", "[arrange2]") {
+    using namespace Slic3r;
+
+    arr2::NFPCache cache;
+
+    auto parts = prusa_parts<arr2::ArrangeItem>();
+    REQUIRE(parts.size() > 10);
+
+    for (size_t i = 0; i + 1 < 10; ++i) {
+        Polygon fixed   = parts[i].envelope().transformed_outline().front();
+        Polygon movable = parts[i + 1].envelope().transformed_outline().front();
+
+        Polygon expected = nfp_convex_convex_legacy(fixed, movable);
+        expected.translate(-reference_vertex(expected));
+
+        // The NFP is only translated when the inputs are translated, so the
+        // second lookup with shifted inputs has to hit the cache.
+        Polygon first = cache.nfp_convex_convex_normalized(fixed, movable);
+        fixed.translate(scaled(12.), scaled(-7.));
+        movable.translate(scaled(-3.), scaled(25.));
+        Polygon second = cache.nfp_convex_convex_normalized(fixed, movable);
+
+        REQUIRE(first.points == expected.points);
+        REQUIRE(second.points == expected.points);
+    }
+
+    auto stats = cache.stats();
+    REQUIRE(stats.misses == 9);
+    REQUIRE(stats.hits == 9);
+
+    SECTION("Different shapes of the same size do not hit") {
+        Polygon fixed   = parts[0].envelope().transformed_outline().front();
+        Polygon movable = parts[1].envelope().transformed_outline().front();
+
+        // Same vertex counts, one vertex moved outwards keeps it convex.
+        Polygon stretched = movable;
+        Vec2crd ref = reference_vertex(stretched);
+        for (Point &p : stretched.points)
+            if (p == ref)
+                p += Point{0, scaled(5.)};
+
+        Polygon expected = nfp_convex_convex_legacy(fixed, stretched);
+        expected.translate(-reference_vertex(expected));
+
+        REQUIRE(cache.nfp_convex_convex_normalized(fixed, stretched).points == expected.points);
+        REQUIRE(cache.stats().misses == 10);
+    }
+
+    SECTION("Entries are evicted when the memory budget is exceeded") {
+        cache.memory_budget(0);
+        REQUIRE(cache.stats().entries == 0);
+        REQUIRE(cache.stats().memory == 0);
+        REQUIRE(cache.stats().evictions == 9);
+    }
+}
+
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 
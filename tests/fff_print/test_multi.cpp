@@ -6,7 +6,9 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Geometry.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
+#include "libslic3r/MultiMaterialSegmentation.hpp"
 #include "libslic3r/Print.hpp"
+#include "libslic3r/TriangleSelector.hpp"
 #include "libslic3r/libslic3r.h"
 
 #include "test_data.hpp"
@@ -269,3 +271,103 @@ SCENARIO("Stacked cubes", "[Multi]")
         }
     }
 }
+
+// Paint the vertical faces of the volume pointing to the given side with the given extruder.
+static void paint_side(ModelVolume &volume, const Vec3f &side, EnforcerBlockerType extruder)
+{
+    TriangleSelector selector(volume.mesh());
+    volume.mm_segmentation_facets.set_facets_selector(selector);
+    const indexed_triangle_set &its = volume.mesh().its;
+    for (int facet_idx = 0; facet_idx < int(its.indices.size()); ++ facet_idx)
+        if (its_face_normal(its, facet_idx).dot(side) > 0.99f)
+            selector.set_facet(facet_idx, extruder);
+    volume.mm_segmentation_facets.set(selector);
+}
+
+// Per layer and extruder areas of the segmentation, insensitive to the order of the polygons.
+static std::vector<std::vector<double>> segmentation_areas(const std::vector<std::vector<ExPolygons>> &segmentation)
+{
+    std::vector<std::vector<double>> out;
+    for (const std::vector<ExPolygons> &layer : segmentation) {
+        std::vector<double> &areas = out.emplace_back();
+        for (const ExPolygons &expolygons : layer)
+            areas.emplace_back(area(expolygons));
+    }
+    return out;
+}
+
+static void require_same_segmentation(const std::vector<std::vector<ExPolygons>> &lhs, const std::vector<std::vector<ExPolygons>> &rhs)
+{
+    std::vector<std::vector<double>> lhs_areas = segmentation_areas(lhs);
+    std::vector<std::vector<double>> rhs_areas = segmentation_areas(rhs);
+    REQUIRE(lhs_areas.size() == rhs_areas.size());
+    for (size_t layer_idx = 0; layer_idx < lhs_areas.size(); ++ layer_idx) {
+        REQUIRE(lhs_areas[layer_idx].size() == rhs_areas[layer_idx].size());
+        for (size_t extruder_idx = 0; extruder_idx < lhs_areas[layer_idx].size(); ++ extruder_idx)
+            REQUIRE(lhs_areas[layer_idx][extruder_idx] == Approx(rhs_areas[layer_idx][extruder_idx]).margin(SCALED_EPSILON * SCALED_EPSILON));
+    }
+}
+
+SCENARIO("MMU segmentation cache", "[Multi]")
+{
+    GIVEN("20mm cube painted on one side with the second extruder") {
+        DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config_with({
+            { "nozzle_diameter",    "0.4, 0.4" },
+            { "layer_height",       0.2 },
+            { "first_layer_height", 0.2 }
+        });
+        Print print;
+        Model model;
+        Test::init_print({ Test::TestMesh::cube_20x20x20 }, print, model, config);
+        ModelVolume &volume = *model.objects.front()->volumes.front();
+        paint_side(volume, Vec3f::UnitX(), EnforcerBlockerType::Extruder2);
+        print.apply(model, config);
+        print.process();
+
+        auto segment = [&print](MMSegmentationCache *cache) {
+            return multi_material_segmentation_by_painting(*print.objects().front(), []() {}, cache);
+        };
+
+        MMSegmentationCache cache;
+        std::vector<std::vector<ExPolygons>> fresh = segment(nullptr);
+        std::vector<std::vector<ExPolygons>> first = segment(&cache);
+        MMSegmentationCache::Data cached = cache.take();
+        REQUIRE(cached.layers.size() == print.objects().front()->layer_count());
+        REQUIRE(! cached.painted_facets.empty());
+        const size_t params_hash = cached.params_hash;
+        cache.store(std::move(cached));
+
+        WHEN("Nothing changes") {
+            std::vector<std::vector<ExPolygons>> second = segment(&cache);
+            THEN("The cached segmentation equals a fresh computation") {
+                require_same_segmentation(first, fresh);
+                require_same_segmentation(second, fresh);
+            }
+        }
+        WHEN("The opposite side is painted as well") {
+            paint_side(volume, - Vec3f::UnitX(), EnforcerBlockerType::Extruder2);
+            print.apply(model, config);
+            print.process();
+            std::vector<std::vector<ExPolygons>> repainted = segment(&cache);
+            THEN("The segmentation of the new painting equals a fresh computation") {
+                require_same_segmentation(repainted, segment(nullptr));
+            }
+            THEN("The stale segmentation is not reused") {
+                REQUIRE(segmentation_areas(repainted) != segmentation_areas(fresh));
+            }
+        }
+        WHEN("The number of extruders changes") {
+            config.set_deserialize_strict({{ "nozzle_diameter", "0.4, 0.4, 0.4" }});
+            print.apply(model, config);
+            print.process();
+            std::vector<std::vector<ExPolygons>> more_extruders = segment(&cache);
+            THEN("The cache is invalidated") {
+                MMSegmentationCache::Data data = cache.take();
+                REQUIRE(data.params_hash != params_hash);
+            }
+            THEN("The segmentation equals a fresh computation") {
+                require_same_segmentation(more_extruders, segment(nullptr));
+            }
+        }
+    }
+}
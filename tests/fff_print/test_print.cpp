@@ -6,6 +6,8 @@
 
 #include "test_data.hpp"
 
+#include <sstream>
+
 using namespace Slic3r;
 using namespace Slic3r::Test;
 
@@ -197,3 +199,97 @@ SCENARIO("Ported from Perl", "[Print]") {
         }
     }
 }
+
+SCENARIO("Print: Identical objects share a PrintObject", "[Print]") {
+    GIVEN("Two separate objects made of the same 20mm cube") {
+        Slic3r::Print print;
+        Slic3r::Model model;
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+        Slic3r::Test::init_print({TestMesh::cube_20x20x20, TestMesh::cube_20x20x20}, print, model, config);
+        REQUIRE(model.objects.size() == 2);
+        THEN("A single PrintObject is sliced for both of them") {
+            REQUIRE(print.objects().size() == 1);
+            REQUIRE(print.objects().front()->instances().size() == 2);
+            REQUIRE(print.num_object_instances() == 2);
+            REQUIRE(print.get_print_object_by_model_object_id(model.objects[1]->id()) == print.objects().front());
+        }
+        THEN("Both objects are printed") {
+            print.process();
+            const std::string gcode = Slic3r::Test::gcode(print);
+            REQUIRE(! gcode.empty());
+            REQUIRE(print.objects().front()->instances()[0].model_instance->get_object()->id() != print.objects().front()->instances()[1].model_instance->get_object()->id());
+        }
+        WHEN("The config of one of the objects is changed") {
+            const PrintObject *shared = print.objects().front();
+            model.objects[1]->config.set("perimeters", 5);
+            print.apply(model, config);
+            THEN("The objects are sliced separately, the first one keeps its PrintObject") {
+                REQUIRE(print.objects().size() == 2);
+                REQUIRE(print.objects().front() == shared);
+                REQUIRE(print.objects().front()->instances().size() == 1);
+                REQUIRE(print.objects().back()->model_object()->id() == model.objects[1]->id());
+            }
+            AND_WHEN("The config is changed back") {
+                model.objects[1]->config.erase("perimeters");
+                print.apply(model, config);
+                THEN("The objects share a PrintObject again") {
+                    REQUIRE(print.objects().size() == 1);
+                    REQUIRE(print.objects().front() == shared);
+                    REQUIRE(print.objects().front()->instances().size() == 2);
+                }
+            }
+        }
+    }
+}
+
+// G-code without the comments, some of them contain the time of the export.
+static std::string strip_gcode_comments(const std::string &gcode)
+{
+    std::string        out;
+    std::istringstream in(gcode);
+    for (std::string line; std::getline(in, line);) {
+        line = line.substr(0, line.find(';'));
+        if (! line.empty())
+            out += line + "\n";
+    }
+    return out;
+}
+
+SCENARIO("Print: Low memory mode releases the layer data", "[Print]") {
+    GIVEN("An overhang printed with support material") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "support_material", true }
+        });
+        const std::string reference = strip_gcode_comments(Slic3r::Test::slice({ TestMesh::overhang }, config));
+
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({ TestMesh::overhang }, print, model, config);
+        print.set_low_memory_mode(true);
+        print.process();
+        const PrintObject &object = *print.objects().front();
+        REQUIRE(! object.support_layers().empty());
+
+        THEN("The data only needed by the infill and the support generation is released at the end of these steps") {
+            for (const Layer *layer : object.layers()) {
+                for (const LayerRegion *layerm : layer->regions()) {
+                    REQUIRE(layerm->fill_no_overlap_expolygons().empty());
+                    REQUIRE(layerm->unsupported_bridge_edges().empty());
+                }
+                for (const LayerSliceIslandPtr &island : layer->islands())
+                    REQUIRE(island->fill_no_overlap_expolygons().empty());
+            }
+            REQUIRE(! print.memory_by_step().empty());
+        }
+        THEN("The G-code equals the one exported in the normal mode, and all the layers are released by the export") {
+            REQUIRE(strip_gcode_comments(Slic3r::Test::gcode(print)) == reference);
+            for (const Layer *layer : object.layers()) {
+                REQUIRE(layer->lslices().empty());
+                REQUIRE(layer->islands().empty());
+            }
+            for (const SupportLayer *layer : object.support_layers())
+                REQUIRE(layer->islands().empty());
+            REQUIRE(! object.is_step_done(posSlice));
+        }
+    }
+}
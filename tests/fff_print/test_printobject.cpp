@@ -1,8 +1,13 @@
 #include <catch2/catch.hpp>
 
+#include <numeric>
+#include <sstream>
+
 #include "libslic3r/libslic3r.h"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleSelector.hpp"
 
 #include "test_data.hpp"
 
@@ -299,3 +304,145 @@ SCENARIO("PrintObject: minimum horizontal shells", "[PrintObject]") {
 
     }
 }
+
+// Polylines of the perimeters and gap fills of a layer, in the order of its islands.
+static Polylines layer_perimeters(const Layer &layer)
+{
+    Polylines out;
+    for (const LayerSliceIslandPtr &island : layer.islands())
+        for (const LayerRegionIslandPtr &region_island : island->regions_islands())
+            for (ExtrusionRole role : { LayerRegionIsland::PERIMETERS, LayerRegionIsland::GAP_FILLS })
+                if (region_island->has_extrusion(role))
+                    append(out, to_polylines(region_island->extrusion(role).as_polylines()));
+    return out;
+}
+
+static std::string strip_gcode_comments(const std::string &gcode)
+{
+    std::string        out;
+    std::istringstream in(gcode);
+    for (std::string line; std::getline(in, line);) {
+        line = line.substr(0, line.find(';'));
+        if (! line.empty())
+            out += line + "\n";
+    }
+    return out;
+}
+
+SCENARIO("PrintObject: perimeters copied from layers with the same slices", "[PrintObject]") {
+    // Hexagonal prism, 10mm high: 50 layers with the same slices.
+    const TriangleMesh prism = make_cylinder(10., 10., 2. * PI / 6.);
+    auto process = [&prism](const DynamicPrintConfig &config, bool reuse, Print &print, Model &model) {
+        Slic3r::Test::init_print({ prism }, print, model, config);
+        print.set_reuse_perimeters(reuse);
+        print.process();
+    };
+
+    GIVEN("A prism with bottom and top solid layers") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "layer_height",           0.2 },
+            { "first_layer_height",     0.2 },
+            { "bottom_solid_layers",    3 },
+            { "top_solid_layers",       3 },
+            { "perimeters",             3 }
+        });
+        Slic3r::Print reused_print, generated_print;
+        Slic3r::Model reused_model, generated_model;
+        process(config, true, reused_print, reused_model);
+        process(config, false, generated_print, generated_model);
+        const PrintObject &reused    = *reused_print.objects().front();
+        const PrintObject &generated = *generated_print.objects().front();
+        REQUIRE(reused.layers().size() == generated.layers().size());
+
+        THEN("The middle layers copy their perimeters, the bottom solid layers and the top layer generate them") {
+            std::vector<size_t> own(reused.layers().size());
+            std::iota(own.begin(), own.end(), 0);
+            REQUIRE(generated.perimeters_source_layers() == own);
+            const std::vector<size_t> source = reused.perimeters_source_layers();
+            // The source of a copy has to be above the first layer and the bottom solid layers.
+            for (size_t layer_idx = 0; layer_idx < 3 + 2; ++ layer_idx)
+                REQUIRE(source[layer_idx] == layer_idx);
+            REQUIRE(source.back() == source.size() - 1);
+            size_t num_copied = 0;
+            for (size_t layer_idx = 0; layer_idx < source.size(); ++ layer_idx)
+                if (source[layer_idx] != layer_idx) {
+                    REQUIRE(source[layer_idx] % 2 == layer_idx % 2);
+                    ++ num_copied;
+                }
+            REQUIRE(num_copied > source.size() / 2);
+        }
+        THEN("The perimeters and the G-code are the same as the generated ones") {
+            for (size_t layer_idx = 0; layer_idx < reused.layers().size(); ++ layer_idx)
+                REQUIRE(layer_perimeters(*reused.layers()[layer_idx]) == layer_perimeters(*generated.layers()[layer_idx]));
+            REQUIRE(strip_gcode_comments(Slic3r::Test::gcode(reused_print)) == strip_gcode_comments(Slic3r::Test::gcode(generated_print)));
+        }
+    }
+
+    GIVEN("A prism with fuzzy skin") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "layer_height",           0.2 },
+            { "first_layer_height",     0.2 },
+            { "fuzzy_skin",             "external" }
+        });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        process(config, true, print, model);
+        const PrintObject &object = *print.objects().front();
+
+        THEN("All the layers generate their own random perimeters") {
+            const std::vector<size_t> source = object.perimeters_source_layers();
+            for (size_t layer_idx = 0; layer_idx < source.size(); ++ layer_idx)
+                REQUIRE(source[layer_idx] == layer_idx);
+            for (size_t layer_idx = 2; layer_idx < object.layers().size(); ++ layer_idx)
+                REQUIRE(layer_perimeters(*object.layers()[layer_idx]) != layer_perimeters(*object.layers()[layer_idx - 2]));
+        }
+    }
+}
+
+SCENARIO("PrintObject: seam data kept between G-code exports", "[PrintObject]") {
+    GIVEN("A 20mm cube exported once") {
+        DynamicPrintConfig config = DynamicPrintConfig::full_print_config_with({
+            { "seam_position", "aligned" }
+        });
+        Slic3r::Print print;
+        Slic3r::Model model;
+        Slic3r::Test::init_print({ TestMesh::cube_20x20x20 }, print, model, config);
+        Slic3r::Test::gcode(print);
+        const PrintObject &object = *print.objects().front();
+        const std::shared_ptr<PrintObjectSeamData> seam_data = object.seam_data();
+        REQUIRE(seam_data);
+
+        WHEN("An option the seams do not depend on is changed") {
+            config.set_deserialize_strict({ { "end_gcode", "M84 ; changed" } });
+            print.apply(model, config);
+            THEN("The seam data is kept and reused by the next export") {
+                REQUIRE(object.seam_data() == seam_data);
+                Slic3r::Test::gcode(print);
+                REQUIRE(object.seam_data() == seam_data);
+            }
+        }
+        WHEN("A seam option is changed") {
+            config.set_deserialize_strict({ { "seam_position", "rear" } });
+            print.apply(model, config);
+            THEN("The seam data is invalidated and computed again by the next export") {
+                REQUIRE(! object.seam_data());
+                Slic3r::Test::gcode(print);
+                REQUIRE(object.seam_data());
+                REQUIRE(object.seam_data() != seam_data);
+            }
+        }
+        WHEN("The seams are painted") {
+            ModelVolume &volume = *model.objects.front()->volumes.front();
+            TriangleSelector selector(volume.mesh());
+            selector.set_facet(0, EnforcerBlockerType::ENFORCER);
+            volume.seam_facets.set(selector);
+            print.apply(model, config);
+            THEN("The seam data is invalidated and computed again by the next export") {
+                REQUIRE(! object.seam_data());
+                Slic3r::Test::gcode(print);
+                REQUIRE(object.seam_data());
+                REQUIRE(object.seam_data() != seam_data);
+            }
+        }
+    }
+}
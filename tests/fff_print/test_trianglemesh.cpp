@@ -227,6 +227,137 @@ SCENARIO( "TriangleMesh: slice behavior.") {
     }
 }
 
+SCENARIO( "TriangleMeshSlicer: streamed slicing matches slicing all layers at once.") {
+    GIVEN( "Two spheres above each other and slicing planes through both of them") {
+        indexed_triangle_set mesh = its_make_sphere(10., PI / 40.);
+        indexed_triangle_set upper = its_make_sphere(5., PI / 40.);
+        its_translate(upper, Vec3f(3.f, 0.f, 18.f));
+        its_merge(mesh, upper);
+
+        std::vector<float> zs;
+        for (float z = -11.f; z < 25.f; z += 0.25f)
+            zs.emplace_back(z);
+
+        MeshSlicingParamsEx params;
+        params.closing_radius = 0.005f;
+        std::vector<ExPolygons> layers = slice_mesh_ex(mesh, zs, params);
+
+        WHEN( "the layers are streamed in small batches") {
+            std::vector<ExPolygons> streamed(zs.size());
+            std::vector<int>        calls(zs.size(), 0);
+            slice_mesh_ex_streamed(mesh, zs, params, [&streamed, &calls](size_t layer_id, ExPolygons &&slice) {
+                streamed[layer_id] = std::move(slice);
+                ++ calls[layer_id];
+            }, []{}, 7);
+
+            THEN( "every layer is passed once") {
+                REQUIRE(std::all_of(calls.begin(), calls.end(), [](int c) { return c == 1; }));
+            }
+            THEN( "the layers are the same") {
+                for (size_t i = 0; i < zs.size(); ++ i) {
+                    INFO("z = " << zs[i]);
+                    REQUIRE(streamed[i].size() == layers[i].size());
+                    REQUIRE(area(streamed[i]) == Approx(area(layers[i])));
+                }
+            }
+        }
+        WHEN( "the polygons are streamed") {
+            std::vector<Polygons> polygons = slice_mesh(mesh, zs, params);
+            std::vector<Polygons> streamed(zs.size());
+            slice_mesh_streamed(mesh, zs, params, [&streamed](size_t layer_id, Polygons &&slice) {
+                streamed[layer_id] = std::move(slice);
+            }, []{}, 16);
+
+            THEN( "the layers are the same") {
+                for (size_t i = 0; i < zs.size(); ++ i) {
+                    INFO("z = " << zs[i]);
+                    REQUIRE(streamed[i].size() == polygons[i].size());
+                    REQUIRE(area(streamed[i]) == Approx(area(polygons[i])));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO( "TriangleMeshSlicer: slicing a z range through the facet z index.") {
+    GIVEN( "Two spheres above each other") {
+        indexed_triangle_set its = its_make_sphere(10., PI / 40.);
+        indexed_triangle_set upper = its_make_sphere(5., PI / 40.);
+        its_translate(upper, Vec3f(3.f, 0.f, 18.f));
+        its_merge(its, upper);
+        TriangleMesh mesh(std::move(its));
+
+        WHEN( "the facet z index is queried") {
+            std::shared_ptr<const FacetZIndex> facet_z_index = mesh.facet_z_index();
+            THEN( "it finds exactly the faces spanning the z range") {
+                for (auto [zmin, zmax] : { std::make_pair(-20.f, 30.f), std::make_pair(9.5f, 9.5f), std::make_pair(12.5f, 14.f), std::make_pair(-10.f, -9.9f) }) {
+                    std::vector<int> faces = facet_z_index->faces(zmin, zmax);
+                    std::sort(faces.begin(), faces.end());
+                    std::vector<int> expected;
+                    for (int face_idx = 0; face_idx < int(mesh.its.indices.size()); ++ face_idx) {
+                        const stl_triangle_vertex_indices &face = mesh.its.indices[face_idx];
+                        const float z0 = mesh.its.vertices[face(0)].z(), z1 = mesh.its.vertices[face(1)].z(), z2 = mesh.its.vertices[face(2)].z();
+                        if (std::min(z0, std::min(z1, z2)) <= zmax && std::max(z0, std::max(z1, z2)) >= zmin)
+                            expected.emplace_back(face_idx);
+                    }
+                    INFO("z range " << zmin << " " << zmax);
+                    REQUIRE(faces == expected);
+                }
+            }
+            THEN( "the index is cached until the mesh is modified") {
+                REQUIRE(mesh.facet_z_index() == facet_z_index);
+                mesh.translate(0.f, 0.f, 1.f);
+                REQUIRE(mesh.facet_z_index() != facet_z_index);
+            }
+        }
+
+        std::vector<float> zs;
+        for (float z = 12.f; z < 21.f; z += 0.25f)
+            zs.emplace_back(z);
+        MeshSlicingParamsEx params;
+        params.closing_radius = 0.005f;
+
+        for (const Transform3d &trafo : { Transform3d::Identity(),
+                                          Geometry::assemble_transform(Vec3d(5., -3., 2.), Vec3d(0., 0., 0.7), Vec3d(1.2, 0.8, 1.1)) }) {
+            params.trafo = trafo;
+            WHEN( "a z range is sliced with the facet z index") {
+                std::vector<ExPolygons> layers = slice_mesh_ex(mesh.its, zs, params);
+                std::vector<ExPolygons> indexed = slice_mesh_ex(mesh.its, *mesh.facet_z_index(), zs, params);
+                THEN( "the layers are the same as if all faces were sliced") {
+                    REQUIRE(indexed.size() == layers.size());
+                    for (size_t i = 0; i < zs.size(); ++ i) {
+                        INFO("z = " << zs[i]);
+                        REQUIRE(indexed[i].size() == layers[i].size());
+                        REQUIRE(area(indexed[i]) == Approx(area(layers[i])));
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO( "TriangleMesh: content hash.") {
+    GIVEN( "Two meshes of a sphere created separately") {
+        TriangleMesh mesh1(its_make_sphere(10., PI / 40.));
+        TriangleMesh mesh2(its_make_sphere(10., PI / 40.));
+        THEN( "their hashes are equal") {
+            REQUIRE(mesh1.content_hash() == mesh2.content_hash());
+        }
+        THEN( "copies keep the hash") {
+            TriangleMesh copy(mesh1);
+            REQUIRE(copy.content_hash() == mesh1.content_hash());
+        }
+        WHEN( "one of them is modified") {
+            size_t hash = mesh1.content_hash();
+            mesh1.translate(0.f, 0.f, 1.f);
+            THEN( "its hash changes") {
+                REQUIRE(mesh1.content_hash() != hash);
+                REQUIRE(mesh1.content_hash() != mesh2.content_hash());
+            }
+        }
+    }
+}
+
 SCENARIO( "make_xxx functions produce meshes.") {
     GIVEN("make_cube() function") {
         WHEN("make_cube() is called with arguments 20,20,20") {
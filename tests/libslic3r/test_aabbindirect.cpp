@@ -5,6 +5,11 @@
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <random>
 
 using namespace Slic3r;
 
@@ -151,6 +156,108 @@ TEST_CASE("Find the closest point from ExPolys", "[ClosestPoint]") {
     //const Linef &line = lines[hit_idx_out];
 }
 
+// Rays from random points around the mesh towards random points inside its bounding box, and bundles of
+// coherent rays from points inside the bounding box.
+static void random_rays(const TriangleMesh &mesh, std::vector<Vec3d> &origins, std::vector<Vec3d> &dirs)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> unit(0., 1.);
+    const BoundingBoxf3 bbox   = mesh.bounding_box();
+    const Vec3d         size   = bbox.size();
+    auto                inside = [&]() { return Vec3d(bbox.min + Vec3d(unit(rng) * size.x(), unit(rng) * size.y(), unit(rng) * size.z())); };
+    for (size_t i = 0; i < 5000; ++ i) {
+        Vec3d dir(unit(rng) - 0.5, unit(rng) - 0.5, unit(rng) - 0.5);
+        Vec3d origin = bbox.center() + dir.normalized() * size.norm();
+        origins.emplace_back(origin);
+        dirs.emplace_back((inside() - origin).normalized());
+    }
+    for (size_t i = 0; i < 200; ++ i) {
+        Vec3d origin = inside();
+        Vec3d axis   = Vec3d(unit(rng) - 0.5, unit(rng) - 0.5, unit(rng) - 0.5).normalized();
+        for (size_t j = 0; j < 32; ++ j) {
+            origins.emplace_back(origin);
+            dirs.emplace_back((axis + 0.2 * Vec3d(unit(rng) - 0.5, unit(rng) - 0.5, unit(rng) - 0.5)).normalized());
+        }
+    }
+}
+
+TEST_CASE("Wide tree finds the same first hits as the binary tree", "[AABBIndirect]")
+{
+    for (const char *fname : { "20mm_cube.obj", "frog_legs.obj", "extruder_idler.obj" }) {
+        TriangleMesh mesh = load_model(fname);
+        auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(mesh.its.vertices, mesh.its.indices);
+        AABBTreeIndirect::WideTree wide_tree(tree);
+        REQUIRE(! wide_tree.empty());
+
+        std::vector<Vec3d> origins, dirs;
+        random_rays(mesh, origins, dirs);
+
+        std::vector<igl::Hit> hits;
+        size_t num_hits = AABBTreeIndirect::intersect_rays_first_hit(mesh.its.vertices, mesh.its.indices, wide_tree, origins, dirs, hits);
+        REQUIRE(hits.size() == origins.size());
+
+        size_t num_hits_expected = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit, wide_hit;
+            bool intersected      = AABBTreeIndirect::intersect_ray_first_hit(mesh.its.vertices, mesh.its.indices, tree, origins[i], dirs[i], hit);
+            bool wide_intersected = AABBTreeIndirect::intersect_ray_first_hit(mesh.its.vertices, mesh.its.indices, wide_tree, origins[i], dirs[i], wide_hit);
+            INFO(fname << " ray " << i);
+            REQUIRE(wide_intersected == intersected);
+            REQUIRE((hits[i].id != -1) == intersected);
+            if (intersected) {
+                ++ num_hits_expected;
+                REQUIRE(wide_hit.t == Approx(hit.t));
+                REQUIRE(hits[i].t == Approx(hit.t));
+            }
+        }
+        REQUIRE(num_hits == num_hits_expected);
+        REQUIRE(num_hits > 0);
+    }
+}
+
+TEST_CASE("Wide tree vs binary tree ray casting time Benchmark", "[AABBIndirect][.]")
+{
+    using namespace std::chrono;
+    for (const char *fname : { "frog_legs.obj", "extruder_idler.obj", "ipadstand.obj" }) {
+        TriangleMesh mesh = load_model(fname);
+        std::vector<Vec3d> origins, dirs;
+        random_rays(mesh, origins, dirs);
+        std::cout << fname << ": " << mesh.its.indices.size() << " triangles, " << origins.size() << " rays" << std::endl;
+
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(mesh.its.vertices, mesh.its.indices);
+        high_resolution_clock::time_point t2 = high_resolution_clock::now();
+        AABBTreeIndirect::WideTree wide_tree(tree);
+        high_resolution_clock::time_point t3 = high_resolution_clock::now();
+        std::cout << "    Building the tree took " << duration<double>(t2 - t1).count() << " seconds, collapsing it "
+                  << duration<double>(t3 - t2).count() << " seconds." << std::endl;
+
+        size_t num_hits = 0;
+        t1 = high_resolution_clock::now();
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit;
+            num_hits += AABBTreeIndirect::intersect_ray_first_hit(mesh.its.vertices, mesh.its.indices, tree, origins[i], dirs[i], hit);
+        }
+        t2 = high_resolution_clock::now();
+        std::cout << "    Binary tree took " << duration<double>(t2 - t1).count() << " seconds, " << num_hits << " hits." << std::endl;
+
+        num_hits = 0;
+        t1 = high_resolution_clock::now();
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit;
+            num_hits += AABBTreeIndirect::intersect_ray_first_hit(mesh.its.vertices, mesh.its.indices, wide_tree, origins[i], dirs[i], hit);
+        }
+        t2 = high_resolution_clock::now();
+        std::cout << "    Wide tree took " << duration<double>(t2 - t1).count() << " seconds, " << num_hits << " hits." << std::endl;
+
+        std::vector<igl::Hit> hits;
+        t1 = high_resolution_clock::now();
+        num_hits = AABBTreeIndirect::intersect_rays_first_hit(mesh.its.vertices, mesh.its.indices, wide_tree, origins, dirs, hits);
+        t2 = high_resolution_clock::now();
+        std::cout << "    Wide tree packets took " << duration<double>(t2 - t1).count() << " seconds, " << num_hits << " hits." << std::endl;
+    }
+}
+
 #if 0
 #include "libslic3r/EdgeGrid.hpp"
 #include <iostream>
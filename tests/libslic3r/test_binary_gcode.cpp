@@ -0,0 +1,136 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCode/ParallelGCodeBinarizer.hpp"
+
+#include <cstdio>
+#include <string>
+
+using namespace Slic3r;
+using namespace bgcode;
+
+namespace {
+
+// Deterministic G-code of roughly the given size, long enough to fill several blocks.
+static std::string make_gcode(size_t size)
+{
+    std::string out;
+    for (size_t i = 0; out.size() < size; ++ i) {
+        if (i % 1000 == 0)
+            out += ";LAYER_CHANGE\n;Z:" + std::to_string(0.2 * double(i / 1000 + 1)) + "\n";
+        out += "G1 X" + std::to_string(i % 250) + "." + std::to_string(i % 7) + " Y" + std::to_string((i * 13) % 210) + " E0.0" + std::to_string(i % 97) + "\n";
+    }
+    return out;
+}
+
+static void set_metadata(binarize::Binarizer &binarizer)
+{
+    binarize::BinaryData &binary_data = binarizer.get_binary_data();
+    binary_data.printer_metadata.raw_data.emplace_back("printer_model", "MK4");
+    binary_data.print_metadata.raw_data.emplace_back("estimated printing time (normal mode)", "1h 2m 3s");
+    binary_data.slicer_metadata.raw_data.emplace_back("layer_height", "0.2");
+}
+
+// Feeds the G-code in pieces of whole lines, as GCodeProcessor::post_process() does.
+template<typename AppendFn>
+static void append_in_pieces(const std::string &gcode, AppendFn append)
+{
+    for (size_t begin = 0; begin < gcode.size();) {
+        size_t end = gcode.find('\n', std::min(gcode.size() - 1, begin + 3000));
+        end = (end == std::string::npos) ? gcode.size() : end + 1;
+        REQUIRE(append(gcode.substr(begin, end - begin)) == core::EResult::Success);
+        begin = end;
+    }
+}
+
+static std::string read_file(FILE &file)
+{
+    std::string out;
+    fseek(&file, 0, SEEK_END);
+    out.resize(size_t(ftell(&file)));
+    rewind(&file);
+    REQUIRE(fread(out.data(), 1, out.size(), &file) == out.size());
+    return out;
+}
+
+static std::string write_serial(const std::string &gcode, const binarize::BinarizerConfig &config)
+{
+    FILE *file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    binarize::Binarizer binarizer;
+    set_metadata(binarizer);
+    REQUIRE(binarizer.initialize(*file, config) == core::EResult::Success);
+    append_in_pieces(gcode, [&binarizer](const std::string &piece) { return binarizer.append_gcode(piece); });
+    REQUIRE(binarizer.finalize() == core::EResult::Success);
+    std::string out = read_file(*file);
+    fclose(file);
+    return out;
+}
+
+static std::string write_parallel(const std::string &gcode, const binarize::BinarizerConfig &config, size_t batch_size, FILE *&file)
+{
+    file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    binarize::Binarizer binarizer;
+    set_metadata(binarizer);
+    REQUIRE(binarizer.initialize(*file, config) == core::EResult::Success);
+    {
+        ParallelGCodeBinarizer gcode_binarizer(*file, config, batch_size);
+        append_in_pieces(gcode, [&gcode_binarizer](const std::string &piece) { return gcode_binarizer.append_gcode(piece); });
+        REQUIRE(gcode_binarizer.finalize() == core::EResult::Success);
+    }
+    REQUIRE(binarizer.finalize() == core::EResult::Success);
+    return read_file(*file);
+}
+
+} // namespace
+
+TEST_CASE("Parallel G-code block compression writes the same file as the Binarizer", "[GCode][BinaryGCode]") {
+    const std::string gcode = make_gcode(1024 * 1024 + 333);
+    binarize::BinarizerConfig config;
+    config.compression.gcode = core::ECompressionType::Heatshrink_12_4;
+    config.checksum          = core::EChecksumType::CRC32;
+    SECTION("MeatPack encoding") { config.gcode_encoding = core::EGCodeEncodingType::MeatPackComments; }
+    SECTION("No encoding") { config.gcode_encoding = core::EGCodeEncodingType::None; }
+
+    const std::string serial = write_serial(gcode, config);
+    for (size_t batch_size : { size_t(0), size_t(1), size_t(3) }) {
+        FILE *file = nullptr;
+        const std::string parallel = write_parallel(gcode, config, batch_size, file);
+        fclose(file);
+        INFO("batch size " << batch_size);
+        REQUIRE(parallel.size() == serial.size());
+        REQUIRE(parallel == serial);
+    }
+}
+
+TEST_CASE("G-code blocks compressed in parallel read back in order", "[GCode][BinaryGCode]") {
+    const std::string gcode = make_gcode(512 * 1024);
+    binarize::BinarizerConfig config;
+    config.compression.gcode = core::ECompressionType::Heatshrink_12_4;
+    config.gcode_encoding    = core::EGCodeEncodingType::None;
+    config.checksum          = core::EChecksumType::CRC32;
+
+    FILE *file = nullptr;
+    write_parallel(gcode, config, 2, file);
+    rewind(file);
+
+    core::FileHeader file_header;
+    REQUIRE(core::read_header(*file, file_header, nullptr) == core::EResult::Success);
+    std::string decoded;
+    size_t      gcode_blocks = 0;
+    core::BlockHeader block_header;
+    while (core::read_next_block_header(*file, file_header, block_header, nullptr, 0) == core::EResult::Success) {
+        if (block_header.type == static_cast<uint16_t>(core::EBlockType::GCode)) {
+            binarize::GCodeBlock block;
+            REQUIRE(block.read_data(*file, file_header, block_header) == core::EResult::Success);
+            REQUIRE(block.raw_data.size() <= ParallelGCodeBinarizer::MAX_BLOCK_SIZE);
+            decoded += block.raw_data;
+            ++ gcode_blocks;
+        } else
+            REQUIRE(core::skip_block(*file, file_header, block_header) == core::EResult::Success);
+    }
+    fclose(file);
+
+    REQUIRE(gcode_blocks > 1);
+    REQUIRE(decoded == gcode);
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+#include <test_utils.hpp>
+
+#include <libslic3r/EdgeGrid.hpp>
+
+#include <random>
+
+using namespace Slic3r;
+
+// Two wavy islands with holes, far from each other, thus most of the grid is empty.
+static ExPolygons wavy_islands()
+{
+    ExPolygons out;
+    for (double x : { 0., 150. }) {
+        ExPolygon expoly;
+        for (size_t i = 0; i < 400; ++ i) {
+            double a = 2. * PI * double(i) / 400.;
+            double r = 40. + 10. * sin(7. * a);
+            expoly.contour.points.emplace_back(scaled<coord_t>(x + r * cos(a)), scaled<coord_t>(r * sin(a)));
+        }
+        Polygon hole;
+        for (size_t i = 0; i < 50; ++ i) {
+            double a = - 2. * PI * double(i) / 50.;
+            hole.points.emplace_back(scaled<coord_t>(x + 10. * cos(a)), scaled<coord_t>(10. * sin(a)));
+        }
+        expoly.holes.emplace_back(std::move(hole));
+        out.emplace_back(std::move(expoly));
+    }
+    return out;
+}
+
+TEST_CASE("Sparse signed distance field matches the full one", "[EdgeGrid]")
+{
+    ExPolygons    islands    = wavy_islands();
+    const coord_t resolution = scaled<coord_t>(0.5);
+    const coord_t band       = scaled<coord_t>(2.);
+
+    EdgeGrid::Grid full;
+    full.create(islands, resolution);
+    full.calculate_sdf();
+
+    EdgeGrid::Grid sparse;
+    sparse.create(islands, resolution);
+    sparse.calculate_sparse_sdf(band);
+    size_t memory_empty = sparse.sdf_memory_size();
+    CHECK(memory_empty < full.sdf_memory_size() / 10);
+
+    std::mt19937 rng(42);
+    BoundingBox  bbox = full.bbox();
+    std::uniform_int_distribution<coord_t> dist_x(bbox.min.x(), bbox.max.x());
+    std::uniform_int_distribution<coord_t> dist_y(bbox.min.y(), bbox.max.y());
+    size_t wrong_sign = 0, wrong_distance = 0;
+    for (size_t i = 0; i < 10000; ++ i) {
+        Point pt(dist_x(rng), dist_y(rng));
+        float d_full   = full.signed_distance_bilinear(pt);
+        float d_sparse = sparse.signed_distance_bilinear(pt);
+        if (std::abs(d_full) > resolution && (d_full < 0) != (d_sparse < 0))
+            ++ wrong_sign;
+        if (std::abs(d_full) < band / 2 && std::abs(d_full - d_sparse) > resolution / 4)
+            ++ wrong_distance;
+    }
+    CHECK(wrong_sign == 0);
+    CHECK(wrong_distance == 0);
+
+    // Only the tiles around the contours are allocated.
+    CHECK(sparse.sdf_memory_size() > memory_empty);
+    CHECK(sparse.sdf_memory_size() < full.sdf_memory_size());
+
+    EdgeGrid::Grid sparse_parallel;
+    sparse_parallel.create(islands, resolution);
+    sparse_parallel.calculate_sparse_sdf(band);
+    sparse_parallel.calculate_sparse_sdf_tiles();
+    CHECK(sparse_parallel.sdf_memory_size() >= sparse.sdf_memory_size());
+    CHECK(sparse_parallel.contours_simplified(0, false).size() == full.contours_simplified(0, false).size());
+}
+
+TEST_CASE("Sparse signed distance field of a filled square only stores the tiles along its contour", "[EdgeGrid]")
+{
+    // 400mm square, 0.5mm resolution: 800x800 cells, 50x50 tiles.
+    const ExPolygons square { ExPolygon(Polygon::new_scale({ { 0., 0. }, { 400., 0. }, { 400., 400. }, { 0., 400. } })) };
+    const coord_t    resolution = scaled<coord_t>(0.5);
+    const coord_t    band       = scaled<coord_t>(2.);
+
+    EdgeGrid::Grid grid;
+    grid.create(square, resolution);
+    grid.calculate_sparse_sdf(band);
+
+    // With the band narrower than a tile, at most three rows of tiles along each side are in band.
+    const size_t tiles_per_side = 800 / 16;
+    CHECK(grid.sparse_sdf_tiles_in_band() > 0);
+    CHECK(grid.sparse_sdf_tiles_in_band() <= 3 * 4 * tiles_per_side);
+
+    // The interior is inside, the outside is outside.
+    CHECK(grid.signed_distance_bilinear(Point::new_scale(200., 200.)) < 0.f);
+    CHECK(grid.signed_distance_bilinear(Point::new_scale(200., 1.)) < 0.f);
+    CHECK(grid.signed_distance_bilinear(Point::new_scale(200., 399.)) < 0.f);
+}
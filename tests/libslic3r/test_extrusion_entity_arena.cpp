@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+
+#include <libslic3r/ExtrusionEntity.hpp>
+#include <libslic3r/ExtrusionEntityArena.hpp>
+
+#include <memory>
+#include <vector>
+
+using namespace Slic3r;
+
+static ExtrusionPath* new_path(coord_t x)
+{
+    auto *path = new ExtrusionPath(ExtrusionAttributes{ ExtrusionRole::Perimeter, ExtrusionFlow{ 1.0, 1.0, 1.0 } }, nullptr);
+    path->polyline.append(Point(x, 0));
+    path->polyline.append(Point(x, 100));
+    return path;
+}
+
+TEST_CASE("Extrusion entities are allocated from the arena of the active scope", "[ExtrusionEntityArena]") {
+    const ExtrusionEntityArena::Stats initial = ExtrusionEntityArena::stats();
+    REQUIRE(ExtrusionEntityArena::current() == nullptr);
+
+    SECTION("Without a scope the entities are allocated on the heap") {
+        std::unique_ptr<ExtrusionPath> path(new_path(0));
+        REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive);
+        REQUIRE(ExtrusionEntityArena::stats().allocations_alive == initial.allocations_alive);
+    }
+
+    SECTION("Entities of a scope share a chunk and outlive the scope") {
+        std::vector<ExtrusionPath*> paths;
+        {
+            ExtrusionEntityArena::Scope scope;
+            REQUIRE(ExtrusionEntityArena::current() != nullptr);
+            for (coord_t x = 0; x < 100; ++ x)
+                paths.emplace_back(new_path(x));
+            REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive + 1);
+            REQUIRE(ExtrusionEntityArena::stats().allocations_alive == initial.allocations_alive + 100);
+            for (const ExtrusionPath *path : paths)
+                REQUIRE(std::abs(reinterpret_cast<const char*>(path) - reinterpret_cast<const char*>(paths.front())) < ptrdiff_t(ExtrusionEntityArena::ChunkSize));
+        }
+        // The scope is gone, its chunk is kept alive by the entities.
+        REQUIRE(ExtrusionEntityArena::current() == nullptr);
+        REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive + 1);
+        for (coord_t x = 0; x < 100; ++ x)
+            REQUIRE(paths[x]->first_point() == Point(x, 0));
+
+        // Deleting all but one entity keeps the chunk, deleting the last one releases it.
+        for (size_t i = 1; i < paths.size(); ++ i)
+            delete paths[i];
+        REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive + 1);
+        REQUIRE(ExtrusionEntityArena::stats().allocations_alive == initial.allocations_alive + 1);
+        delete paths.front();
+        REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive);
+        REQUIRE(ExtrusionEntityArena::stats().allocations_alive == initial.allocations_alive);
+    }
+
+    SECTION("Memory freed inside a scope is not reused") {
+        ExtrusionEntityArena::Scope scope;
+        ExtrusionPath *first = new_path(0);
+        const void    *first_address = first;
+        delete first;
+        std::unique_ptr<ExtrusionPath> second(new_path(1));
+        REQUIRE(static_cast<const void*>(second.get()) != first_address);
+    }
+
+    SECTION("Nested scopes restore the outer arena") {
+        ExtrusionEntityArena::Scope outer;
+        ExtrusionEntityArena *outer_arena = ExtrusionEntityArena::current();
+        {
+            ExtrusionEntityArena::Scope inner;
+            REQUIRE(ExtrusionEntityArena::current() != outer_arena);
+        }
+        REQUIRE(ExtrusionEntityArena::current() == outer_arena);
+    }
+
+    SECTION("Large allocations go to the heap") {
+        ExtrusionEntityArena::Scope scope;
+        void *large = ExtrusionEntityArena::allocate(ExtrusionEntityArena::MaxAllocationSize + 1);
+        REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive);
+        REQUIRE(ExtrusionEntityArena::stats().allocations_alive == initial.allocations_alive);
+        ExtrusionEntityArena::deallocate(large);
+    }
+
+    REQUIRE(ExtrusionEntityArena::current() == nullptr);
+    REQUIRE(ExtrusionEntityArena::stats().chunks_alive == initial.chunks_alive);
+}
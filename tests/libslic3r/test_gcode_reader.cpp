@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/LocalesUtils.hpp"
+
+#include "test_data.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+using namespace Slic3r;
+
+namespace {
+
+struct ParsedLine
+{
+    std::string raw;
+    float       axis[NUM_AXES];
+    bool        has[NUM_AXES];
+    float       position[NUM_AXES];
+
+    bool operator==(const ParsedLine &rhs) const {
+        if (raw != rhs.raw)
+            return false;
+        for (size_t i = 0; i < NUM_AXES; ++ i)
+            if (has[i] != rhs.has[i] || (has[i] && axis[i] != rhs.axis[i]) || position[i] != rhs.position[i])
+                return false;
+        return true;
+    }
+};
+
+static std::vector<ParsedLine> parse(const std::string &path, bool parallel, std::vector<std::vector<size_t>> &lines_ends)
+{
+    std::vector<ParsedLine> out;
+    GCodeReader reader;
+    auto callback = [&out](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        ParsedLine l;
+        l.raw = line.raw();
+        for (size_t i = 0; i < NUM_AXES; ++ i) {
+            l.has[i]      = line.has(Axis(i));
+            l.axis[i]     = line.value(Axis(i));
+            l.position[i] = i == X ? reader.x() : i == Y ? reader.y() : i == Z ? reader.z() : i == E ? reader.e() : reader.f();
+        }
+        out.emplace_back(std::move(l));
+    };
+    bool ok = parallel ? reader.parse_file_parallel(path, callback, lines_ends) : reader.parse_file(path, callback, lines_ends);
+    REQUIRE(ok);
+    return out;
+}
+
+static void check_same_result(const std::string &path)
+{
+    std::vector<std::vector<size_t>> lines_ends_serial;
+    std::vector<std::vector<size_t>> lines_ends_parallel;
+    std::vector<ParsedLine> serial   = parse(path, false, lines_ends_serial);
+    std::vector<ParsedLine> parallel = parse(path, true, lines_ends_parallel);
+    REQUIRE(serial.size() == parallel.size());
+    CHECK(serial == parallel);
+    CHECK(lines_ends_serial == lines_ends_parallel);
+}
+
+static GCodeProcessorResult process(const std::string &path, bool parallel)
+{
+    GCodeProcessor processor;
+    processor.enable_parallel_parsing(parallel);
+    processor.process_file(path);
+    return processor.extract_result();
+}
+
+} // namespace
+
+TEST_CASE("Parallel G-code reader matches the serial one", "[GCodeReader]") {
+    CNumericLocalesSetter locales_setter;
+
+    SECTION("Test G-code corpus") {
+        for (const char *name : { "4113_fan_mover.gcode", "4113_fan_mover_ok.gcode" })
+            check_same_result(std::string(TEST_DATA_DIR) + "/test_gcode/" + name);
+    }
+
+    SECTION("Large file spanning many chunks, mixed line ends, no trailing newline") {
+        boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("slic3r_test_gcode_%%%%%%%%.gcode");
+        {
+            boost::nowide::ofstream f(path.string(), std::ios::binary);
+            f << "G21\nG90\nM83\n";
+            for (int i = 0; i < 100000; ++ i) {
+                f << "G1 X" << (i % 200) * 0.5 << " Y" << (i % 170) * 0.25 << " E0.0" << (i % 9 + 1) << " ; extrude " << i << ((i % 3) == 0 ? "\r\n" : "\n");
+                if (i % 1000 == 0)
+                    f << "\n;LAYER_CHANGE\nG92 E0\nG1 Z" << i / 1000 * 0.2 << " F3000\n";
+            }
+            f << "G1 X0 Y0 F9000";
+        }
+        check_same_result(path.string());
+        boost::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("GCodeProcessor produces the same result with the parallel reader", "[GCodeReader]") {
+    std::string gcode = Test::slice({ Test::TestMesh::overhang, Test::TestMesh::cube_20x20x20 }, {
+        { "support_material",   true },
+        { "perimeters",         2 },
+        { "fill_density",       "20%" },
+        { "skirts",             1 },
+    });
+    REQUIRE(! gcode.empty());
+
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("slic3r_test_gcode_%%%%%%%%.gcode");
+    {
+        boost::nowide::ofstream f(path.string(), std::ios::binary);
+        f << gcode;
+    }
+    GCodeProcessorResult serial   = process(path.string(), false);
+    GCodeProcessorResult parallel = process(path.string(), true);
+    boost::filesystem::remove(path);
+
+    REQUIRE(serial.moves.size() > 1);
+    REQUIRE(serial.moves.size() == parallel.moves.size());
+    size_t num_extrusions = 0;
+    for (size_t i = 0; i < serial.moves.size(); ++ i) {
+        const GCodeProcessorResult::MoveVertex &s = serial.moves[i];
+        const GCodeProcessorResult::MoveVertex &p = parallel.moves[i];
+        INFO("move " << i);
+        REQUIRE(s.gcode_id == p.gcode_id);
+        REQUIRE(s.type == p.type);
+        REQUIRE(s.extrusion_role == p.extrusion_role);
+        REQUIRE(s.extruder_id == p.extruder_id);
+        REQUIRE(s.position == p.position);
+        REQUIRE(s.delta_extruder == p.delta_extruder);
+        REQUIRE(s.feedrate == p.feedrate);
+        REQUIRE(s.width == p.width);
+        REQUIRE(s.height == p.height);
+        REQUIRE(s.move_time == p.move_time);
+        REQUIRE(s.layer_id == p.layer_id);
+        num_extrusions += s.type == EMoveType::Extrude;
+    }
+    // The G-code contains extrusions of several roles, thus the comparison is not trivial.
+    CHECK(num_extrusions > 0);
+    CHECK(serial.lines_ends == parallel.lines_ends);
+    for (size_t i = 0; i < size_t(PrintEstimatedStatistics::ETimeMode::Count); ++ i) {
+        const PrintEstimatedStatistics::Mode &s = serial.print_statistics.modes[i];
+        const PrintEstimatedStatistics::Mode &p = parallel.print_statistics.modes[i];
+        CHECK(s.time == p.time);
+        CHECK(s.travel_time == p.travel_time);
+        CHECK(s.moves_times == p.moves_times);
+        CHECK(s.roles_times == p.roles_times);
+        CHECK(s.layers_times == p.layers_times);
+    }
+    CHECK(serial.print_statistics.modes.front().roles_times.size() > 2);
+    CHECK(serial.print_statistics.volumes_per_extruder == parallel.print_statistics.volumes_per_extruder);
+}
@@ -5,6 +5,8 @@
 #include <libslic3r/TriangleMesh.hpp> // its - indexed_triangle_set
 #include "libslic3r/AABBTreeIndirect.hpp" // is similar
 
+#include <chrono>
+
 using namespace Slic3r;
 
 namespace Private {
@@ -22,6 +24,8 @@ struct Similarity
 
 // border for our algorithm with frog_leg model and decimation to 5%
 Similarity frog_leg_5(0.32f, 0.043f);
+// border for parallel algorithm which is less precise around borders of cells
+Similarity frog_leg_5_parallel(0.32f, 0.045f);
 
 Similarity get_similarity(const indexed_triangle_set &from,
                              const indexed_triangle_set &to)
@@ -239,6 +243,50 @@ TEST_CASE("Simplify frog_legs.obj to 5% by Quadric edge collapse", "[its][quadri
     Private::is_better_similarity(mesh.its, its, Private::frog_leg_5);
 }
 
+TEST_CASE("Simplify frog_legs.obj to 5% by parallel Quadric edge collapse", "[its][quadric_edge_collapse]")
+{
+    TriangleMesh mesh            = load_model("frog_legs.obj");
+    double       original_volume = its_volume(mesh.its);
+    uint32_t     wanted_count    = mesh.its.indices.size() * 0.05;
+    REQUIRE_FALSE(mesh.empty());
+    indexed_triangle_set its       = mesh.its; // copy
+    float                max_error = std::numeric_limits<float>::max();
+    // small cells to split frog legs into 8 parts
+    its_quadric_edge_collapse_parallel(its, wanted_count, &max_error, nullptr, nullptr, 4000);
+    CHECK(its.indices.size() <= wanted_count);
+    CHECK(!Private::exist_triangle_with_twice_vertices(its.indices));
+    double volume = its_volume(its);
+    CHECK(fabs(original_volume - volume) < 33.);
+
+    Private::is_better_similarity(mesh.its, its, Private::frog_leg_5_parallel);
+}
+
+TEST_CASE("Serial vs parallel Quadric edge collapse time Benchmark", "[its][quadric_edge_collapse][.]")
+{
+    indexed_triangle_set sphere = its_make_sphere(10., PI / 1000.); // cca 4M triangles
+    uint32_t wanted_count = sphere.indices.size() * 0.05;
+
+    auto simplify = [&](const char *name, auto fn) {
+        indexed_triangle_set its = sphere; // copy
+        auto start = std::chrono::high_resolution_clock::now();
+        fn(its);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << name << ": " << std::chrono::duration<double>(end - start).count()
+                  << " s, triangles = " << its.indices.size() << std::endl;
+        Private::get_similarity(sphere, its);
+        return its;
+    };
+
+    indexed_triangle_set serial = simplify("serial", [&](indexed_triangle_set &its) {
+        // one cell for whole mesh is the serial algorithm
+        its_quadric_edge_collapse_parallel(its, wanted_count, nullptr, nullptr, nullptr, sphere.indices.size());
+    });
+    indexed_triangle_set parallel = simplify("parallel", [&](indexed_triangle_set &its) {
+        its_quadric_edge_collapse_parallel(its, wanted_count);
+    });
+    CHECK(serial.indices.size() == parallel.indices.size());
+}
+
 #include <libigl/igl/qslim.h>
 TEST_CASE("Simplify frog_legs.obj to 5% by IGL/qslim", "[]")
 {
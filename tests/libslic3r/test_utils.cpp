@@ -1,6 +1,10 @@
 #include <catch2/catch.hpp>
 
 #include "libslic3r/libslic3r.h"
+#include "libslic3r/Utils.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
 
 SCENARIO("Test fast_round_up()") {
     using namespace Slic3r;
@@ -33,3 +37,63 @@ SCENARIO("Test fast_round_up()") {
         REQUIRE(fast_round_up<int>(-1.51) == -2);
     }
 }
+
+static void write_file(const boost::filesystem::path &path, const std::string &content)
+{
+    boost::nowide::ofstream f(path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+    f << content;
+}
+
+static std::string read_file(const boost::filesystem::path &path)
+{
+    boost::nowide::ifstream f(path.string(), std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+SCENARIO("Copying and moving files keeps the target on failure", "[Utils]") {
+    using namespace Slic3r;
+    namespace fs = boost::filesystem;
+
+    const fs::path dir = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(dir);
+    const fs::path source  = dir / "source.gcode";
+    const fs::path target  = dir / "target.gcode";
+    const fs::path missing = dir / "missing.gcode";
+    write_file(source, "new G-code");
+    write_file(target, "old G-code");
+
+    std::string error_message;
+    WHEN("The source of a checked copy cannot be opened") {
+        CopyFileResult result = copy_file(missing.string(), target.string(), error_message, true);
+        THEN("The copy fails, the target is kept and no temporary file is left") {
+            REQUIRE(result == FAIL_CHECK_ORIGIN_NOT_OPENED);
+            REQUIRE(read_file(target) == "old G-code");
+            REQUIRE(! fs::exists(target.string() + ".tmp"));
+        }
+    }
+    WHEN("The source of a plain copy cannot be opened") {
+        CopyFileResult result = copy_file(missing.string(), target.string(), error_message, false);
+        THEN("The copy fails, the target is kept and no temporary file is left") {
+            REQUIRE(result == FAIL_COPY_FILE);
+            REQUIRE(read_file(target) == "old G-code");
+            REQUIRE(! fs::exists(target.string() + ".tmp"));
+        }
+    }
+    WHEN("The source of a move does not exist") {
+        CopyFileResult result = move_file(missing.string(), target.string(), error_message, true);
+        THEN("The move fails and the target is kept") {
+            REQUIRE(result != SUCCESS);
+            REQUIRE(read_file(target) == "old G-code");
+        }
+    }
+    WHEN("A file is moved over an existing target") {
+        CopyFileResult result = move_file(source.string(), target.string(), error_message, true);
+        THEN("The target is replaced and the source is gone") {
+            REQUIRE(result == SUCCESS);
+            REQUIRE(read_file(target) == "new G-code");
+            REQUIRE(! fs::exists(source));
+        }
+    }
+
+    fs::remove_all(dir);
+}
@@ -8,9 +8,47 @@
 #include "libslic3r/Format/SLAArchiveReader.hpp"
 
 #include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <map>
 
 using namespace Slic3r;
 
+static std::uint32_t read_uint32_le(std::istream &in)
+{
+    unsigned char b[4] = {};
+    in.read(reinterpret_cast<char*>(b), 4);
+    return std::uint32_t(b[0]) | (std::uint32_t(b[1]) << 8) | (std::uint32_t(b[2]) << 16) | (std::uint32_t(b[3]) << 24);
+}
+
+// Image offset and size of the layers of an Anycubic archive. Returns an empty vector for other archives.
+static std::vector<std::pair<std::uint32_t, std::uint32_t>> anycubic_layer_images(const std::string &fname, std::uint32_t &image_data_offset)
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> out;
+    boost::nowide::ifstream in(fname, std::ios::binary);
+    char tag[12];
+    in.read(tag, sizeof(tag));
+    if (! in || std::string(tag, 8) != "ANYCUBIC")
+        return out;
+    // version, area_num, header, software, preview, layer color offsets
+    for (int i = 0; i < 6; ++ i)
+        read_uint32_le(in);
+    std::uint32_t layer_data_offset = read_uint32_le(in);
+    read_uint32_le(in); // extra data offset
+    image_data_offset = read_uint32_le(in);
+    // Skip the tag and the payload size of the layers header.
+    in.seekg(layer_data_offset + 16);
+    std::uint32_t layer_count = read_uint32_le(in);
+    for (std::uint32_t i = 0; i < layer_count; ++ i) {
+        std::uint32_t offset = read_uint32_le(in);
+        std::uint32_t size   = read_uint32_le(in);
+        out.emplace_back(offset, size);
+        // Lift distance and speed, exposure time, layer height and two unknown values.
+        in.seekg(6 * 4, std::ios::cur);
+    }
+    return out;
+}
+
 TEST_CASE("Archive export test", "[sla_archives]") {
     auto registry = registered_sla_archives();
 
@@ -34,6 +72,11 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         print.apply(m, cfg);
         print.process();
 
+        // Apart from the bottom layers all the layers of a cube are the same,
+        // their raster is shared.
+        if (std::string(pname) == "20mm_cube")
+            REQUIRE(print.print_statistics().duplicate_layers_count > 0);
+
         ThumbnailsList thumbnails;
         auto outputfname = std::string("output_") + pname + "." + entry.ext;
 
@@ -42,6 +85,18 @@ TEST_CASE("Archive export test", "[sla_archives]") {
         // Not much can be checked about the archives...
         REQUIRE(boost::filesystem::exists(outputfname));
 
+        // The Anycubic archives store the image of identical layers once, the duplicates point to it.
+        std::uint32_t image_data_offset = 0;
+        if (auto images = anycubic_layer_images(outputfname, image_data_offset); ! images.empty()) {
+            INFO(std::string("Testing archive type: ") + entry.id + " -- shared layer images...");
+            std::map<std::uint32_t, std::uint32_t> unique_images(images.begin(), images.end());
+            REQUIRE(unique_images.size() == images.size() - print.print_statistics().duplicate_layers_count);
+            size_t images_size = 0;
+            for (const auto &[offset, size] : unique_images)
+                images_size += size;
+            REQUIRE(boost::filesystem::file_size(outputfname) == image_data_offset + images_size);
+        }
+
         double vol_written = m.mesh().volume();
 
         if (entry.rdfactoryfn) {
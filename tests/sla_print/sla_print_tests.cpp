@@ -2,12 +2,16 @@
 #include <random>
 #include <numeric>
 #include <cstdint>
+#include <mutex>
 
 #include "sla_test_utils.hpp"
 
 #include <libslic3r/TriangleMeshSlicer.hpp>
 #include <libslic3r/SLA/SupportTreeMesher.hpp>
+#include <libslic3r/SLA/SupportTreeSlicer.hpp>
 #include <libslic3r/BranchingTree/PointCloud.hpp>
+#include <libslic3r/SLA/Rotfinder.hpp>
+#include <libslic3r/Model.hpp>
 
 namespace {
 
@@ -149,6 +153,74 @@ TEST_CASE("DefaultSupports::FloorSupportsDoNotPierceModel", "[SLASupportGenerati
         test_support_model_collision(fname, supportcfg);
 }
 
+TEST_CASE("DefaultSupports::SlicedPartsMatchSlicedMesh", "[SLASupportGeneration]") {
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.object_elevation_mm = 10.;
+
+    for (auto fname : {"20mm_cube.obj", "A_upsidedown.obj"}) {
+        SupportByproducts byproducts;
+        test_supports(fname, supportcfg, byproducts);
+
+        const sla::SupportTreeBuilder &builder = byproducts.suptree_builder;
+
+        std::vector<ExPolygons> mesh_slices =
+            slice_mesh_ex(builder.retrieve_mesh(sla::MeshType::Support),
+                          byproducts.slicegrid, CLOSING_RADIUS);
+        std::vector<ExPolygons> part_slices =
+            sla::slice_support_tree(builder.parts(), byproducts.slicegrid,
+                                    CLOSING_RADIUS);
+
+        REQUIRE(part_slices.size() == mesh_slices.size());
+
+        // Both are polygonal approximations of the same exact sections, the
+        // difference of a layer is the largest where a part ends.
+        const double margin = scaled<double>(1.) * scaled<double>(1.) * 0.5;
+        double mesh_area = 0., part_area = 0.;
+        for (size_t n = 0; n < part_slices.size(); ++n) {
+            double amesh = area(mesh_slices[n]);
+            double apart = area(part_slices[n]);
+            INFO(fname << " layer " << n);
+            REQUIRE(apart == Approx(amesh).epsilon(0.05).margin(margin));
+            mesh_area += amesh;
+            part_area += apart;
+        }
+
+        REQUIRE(mesh_area > 0.);
+        REQUIRE(part_area == Approx(mesh_area).epsilon(0.01));
+    }
+}
+
+TEST_CASE("DefaultSupports::PartsMeshMatchesMeshedParts", "[SLASupportGeneration]") {
+    sla::SupportTreeConfig supportcfg;
+    supportcfg.object_elevation_mm = 10.;
+
+    const size_t steps = 45;
+
+    for (auto fname : {"20mm_cube.obj", "A_upsidedown.obj"}) {
+        SupportByproducts byproducts;
+        test_supports(fname, supportcfg, byproducts);
+
+        sla::SupportTreeParts parts = byproducts.suptree_builder.parts();
+
+        indexed_triangle_set meshed_parts;
+        for (const sla::Head &h : parts.heads) its_merge(meshed_parts, sla::get_mesh(h, steps));
+        for (const sla::Pillar &p : parts.pillars) its_merge(meshed_parts, sla::get_mesh(p, steps));
+        for (const sla::Pedestal &p : parts.pedestals) its_merge(meshed_parts, sla::get_mesh(p, steps));
+        for (const sla::Junction &j : parts.junctions) its_merge(meshed_parts, sla::get_mesh(j, steps));
+        for (const sla::Bridge &br : parts.bridges) its_merge(meshed_parts, sla::get_mesh(br, steps));
+        for (const sla::DiffBridge &br : parts.diffbridges) its_merge(meshed_parts, sla::get_mesh(br, steps));
+
+        indexed_triangle_set parts_mesh = sla::get_mesh(parts, steps);
+
+        INFO(fname);
+        REQUIRE(! parts_mesh.empty());
+        REQUIRE(parts_mesh.indices == meshed_parts.indices);
+        REQUIRE(parts_mesh.vertices.size() == meshed_parts.vertices.size());
+        for (size_t i = 0; i < parts_mesh.vertices.size(); ++i)
+            REQUIRE((parts_mesh.vertices[i] - meshed_parts.vertices[i]).norm() < 1e-4f);
+    }
+}
+
 //TEST_CASE("BranchingSupports::ElevatedSupportGeometryIsValid", "[SLASupportGeneration][Branching]") {
 //    sla::SupportTreeConfig supportcfg;
 //    supportcfg.object_elevation_mm = 10.;
@@ -271,3 +343,55 @@ TEST_CASE("Test concurrency")
 
     REQUIRE(s == Approx(ref));
 }
+
+TEST_CASE("Stopped multi resolution orientation search returns identity", "[SLARotfinder]")
+{
+    // Big enough mesh to be searched at a coarse resolution first.
+    Model model;
+    ModelObject *mo = model.add_object();
+    mo->add_volume(TriangleMesh{its_make_sphere(10., PI / 200.)});
+    mo->add_instance();
+    REQUIRE(mo->volumes.front()->mesh().its.indices.size() > 50000);
+
+    // Stop before the first candidate is evaluated.
+    auto params = sla::RotOptimizeParams{}.multi_resolution(true).statucb([](int) { return false; });
+
+    Vec2d rot = sla::find_best_misalignment_rotation(*mo, params);
+    REQUIRE(rot == Vec2d::Zero());
+}
+
+TEST_CASE("Progress of several objects processed concurrently is monotonic", "[SLAPrint]")
+{
+    Model model;
+    for (double x : { -30., 0., 30. }) {
+        ModelObject *mo = model.add_object();
+        mo->add_volume(TriangleMesh{its_make_cube(10., 10., 10.)});
+        mo->add_instance()->set_offset(Vec3d(x, 0., 0.));
+    }
+
+    SLAFullPrintConfig fullcfg;
+    fullcfg.printer_technology.value = ptSLA;
+    fullcfg.set("hollowing_enable", true);
+    fullcfg.set("supports_enable", false);
+    fullcfg.set("pad_enable", false);
+    DynamicPrintConfig cfg;
+    cfg.apply(fullcfg);
+
+    // The status may be reported by several threads.
+    std::mutex       mutex;
+    std::vector<int> statuses;
+    SLAPrint print;
+    print.set_status_callback([&mutex, &statuses](const PrintBase::SlicingStatus &status) {
+        if (status.percent >= 0) {
+            std::scoped_lock<std::mutex> lock(mutex);
+            statuses.emplace_back(status.percent);
+        }
+    });
+    print.apply(model, cfg);
+    REQUIRE(print.objects().size() == 3);
+    print.process();
+
+    REQUIRE(! statuses.empty());
+    REQUIRE(std::is_sorted(statuses.begin(), statuses.end()));
+    REQUIRE(statuses.back() == 100);
+}
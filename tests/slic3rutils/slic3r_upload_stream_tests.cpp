@@ -0,0 +1,200 @@
+#include "catch2/catch.hpp"
+
+#include <istream>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+
+#include "slic3r/Utils/Http.hpp"
+#include "slic3r/Utils/UploadStream.hpp"
+
+using namespace Slic3r;
+
+// Deterministic G-code like payload of the given size.
+static std::string make_payload(size_t size)
+{
+    std::string out;
+    out.reserve(size + 32);
+    for (size_t i = 0; out.size() < size; ++ i)
+        out += "G1 X" + std::to_string(i % 250) + " Y" + std::to_string(i % 210) + " E0.0123\n";
+    out.resize(size);
+    return out;
+}
+
+static boost::filesystem::path spool_path()
+{
+    return boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("upload_stream_test.%%%%-%%%%-%%%%-%%%%");
+}
+
+// Feed the payload into the stream in small pieces from a separate thread, as the G-code export does.
+static std::thread start_producer(UploadStream &stream, const std::string &payload, size_t piece)
+{
+    return std::thread([&stream, &payload, piece]() {
+        for (size_t i = 0; i < payload.size(); i += piece)
+            if (! stream.write(payload.data() + i, std::min(piece, payload.size() - i)))
+                return;
+        stream.close();
+    });
+}
+
+TEST_CASE("UploadStream passes data from a producer to a reader", "[UploadStream]") {
+    const std::string payload = make_payload(3 * 1024 * 1024 + 17);
+    const boost::filesystem::path path = spool_path();
+    {
+        UploadStream stream(path);
+        std::thread producer = start_producer(stream, payload, 1000);
+
+        std::istream in(&stream);
+        std::string  received{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+        producer.join();
+
+        REQUIRE(received.size() == payload.size());
+        REQUIRE(received == payload);
+        REQUIRE(stream.bytes_written() == payload.size());
+    }
+    // The spool file is deleted with the stream.
+    REQUIRE(! boost::filesystem::exists(path));
+}
+
+TEST_CASE("UploadStream producer does not wait for the reader", "[UploadStream]") {
+    const std::string payload = make_payload(8 * 1024 * 1024 + 3);
+    UploadStream stream(spool_path());
+    // Nobody reads while the data is being written, as if the upload job waited for the previous uploads.
+    for (size_t i = 0; i < payload.size(); i += 4000)
+        REQUIRE(stream.write(payload.data() + i, std::min<size_t>(4000, payload.size() - i)));
+    stream.close();
+
+    std::istream in(&stream);
+    std::string  received{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    REQUIRE(received == payload);
+}
+
+TEST_CASE("UploadStream fails to open an invalid spool file", "[UploadStream]") {
+    UploadStream stream(spool_path() / "not_a_directory" / "spool");
+    REQUIRE(stream.aborted());
+    char c = 'x';
+    REQUIRE(! stream.write(&c, 1));
+}
+
+TEST_CASE("Aborting UploadStream fails the producer and the reader", "[UploadStream]") {
+    const std::string payload = make_payload(1024 * 1024);
+    UploadStream stream(spool_path());
+    std::thread producer = start_producer(stream, payload, 1000);
+
+    std::istream in(&stream);
+    char buffer[1024];
+    in.read(buffer, sizeof(buffer));
+    REQUIRE(in.gcount() == sizeof(buffer));
+    stream.abort();
+    // The producer either finished or it is still writing, its writes fail now.
+    producer.join();
+    // Data already handed over to the reader may still be read, then the reader fails.
+    while (in.read(buffer, sizeof(buffer))) ;
+    REQUIRE(in.bad());
+    REQUIRE(! stream.write(buffer, 1));
+}
+
+// Minimal HTTP/1.1 stand-in for a print host, accepting a single request with a chunked body.
+class ChunkedUploadServer
+{
+public:
+    ChunkedUploadServer() : m_acceptor(m_io, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address("127.0.0.1"), 0)) {
+        m_thread = std::thread([this]() { this->serve(); });
+    }
+    ~ChunkedUploadServer() { if (m_thread.joinable()) m_thread.join(); }
+
+    unsigned short port() const { return m_acceptor.local_endpoint().port(); }
+    void           join() { m_thread.join(); }
+
+    std::string headers;
+    std::string body;
+    bool        chunked { false };
+
+private:
+    void serve() {
+        boost::asio::ip::tcp::socket socket(m_io);
+        m_acceptor.accept(socket);
+        boost::asio::streambuf buf;
+        boost::asio::read_until(socket, buf, "\r\n\r\n");
+        std::istream in(&buf);
+        for (std::string line; std::getline(in, line) && line != "\r";)
+            headers += line + "\n";
+        chunked = headers.find("Transfer-Encoding: chunked") != std::string::npos;
+        if (headers.find("Expect: 100-continue") != std::string::npos)
+            boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.1 100 Continue\r\n\r\n")));
+        // Decode the chunks until the terminating zero sized chunk.
+        for (;;) {
+            boost::asio::read_until(socket, buf, "\r\n");
+            std::string size_line;
+            std::getline(in, size_line);
+            size_t size = std::stoul(size_line, nullptr, 16);
+            if (buf.size() < size + 2)
+                boost::asio::read(socket, buf, boost::asio::transfer_exactly(size + 2 - buf.size()));
+            std::string chunk(size + 2, '\0');
+            in.read(chunk.data(), chunk.size());
+            if (size == 0)
+                break;
+            body.append(chunk.data(), size);
+        }
+        boost::asio::write(socket, boost::asio::buffer(std::string("HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok")));
+    }
+
+    boost::asio::io_context        m_io;
+    boost::asio::ip::tcp::acceptor m_acceptor;
+    std::thread                    m_thread;
+};
+
+TEST_CASE("Http uploads a stream with chunked transfer encoding while it is being produced", "[Http][UploadStream]") {
+    ChunkedUploadServer server;
+    const std::string payload = make_payload(2 * 1024 * 1024 + 5);
+    auto stream = std::make_shared<UploadStream>(spool_path());
+    std::thread producer = start_producer(*stream, payload, 4000);
+
+    unsigned status = 0;
+    std::string error;
+    Http::put("http://127.0.0.1:" + std::to_string(server.port()) + "/upload")
+        .set_put_body(stream)
+        .on_complete([&status](std::string, unsigned http_status) { status = http_status; })
+        .on_error([&status, &error](std::string, std::string err, unsigned http_status) { status = http_status; error = err; })
+        .perform_sync();
+    producer.join();
+    server.join();
+
+    INFO(error);
+    REQUIRE(status == 200);
+    REQUIRE(server.chunked);
+    REQUIRE(server.body.size() == payload.size());
+    REQUIRE(server.body == payload);
+}
+
+TEST_CASE("Http uploads a stream as a chunked multipart form while it is being produced", "[Http][UploadStream]") {
+    // OctoPrint and Moonraker upload the G-code as a file part of a multipart form.
+    ChunkedUploadServer server;
+    const std::string payload = make_payload(2 * 1024 * 1024 + 5);
+    auto stream = std::make_shared<UploadStream>(spool_path());
+    std::thread producer = start_producer(*stream, payload, 4000);
+
+    unsigned status = 0;
+    std::string error;
+    Http::post("http://127.0.0.1:" + std::to_string(server.port()) + "/api/files/local")
+        .form_add("print", "false")
+        .form_add_stream("file", stream, "test.gcode")
+        .on_complete([&status](std::string, unsigned http_status) { status = http_status; })
+        .on_error([&status, &error](std::string, std::string err, unsigned http_status) { status = http_status; error = err; })
+        .perform_sync();
+    producer.join();
+    server.join();
+
+    INFO(error);
+    REQUIRE(status == 200);
+    REQUIRE(server.chunked);
+    REQUIRE(server.headers.find("Content-Type: multipart/form-data") != std::string::npos);
+    REQUIRE(server.body.find("name=\"print\"") != std::string::npos);
+    REQUIRE(server.body.find("name=\"file\"; filename=\"test.gcode\"") != std::string::npos);
+    // The file part carries the whole payload, followed by the closing boundary.
+    size_t payload_pos = server.body.find(payload);
+    REQUIRE(payload_pos != std::string::npos);
+    REQUIRE(server.body.find("--", payload_pos + payload.size()) != std::string::npos);
+}